@@ -23,6 +23,7 @@
 
 #include <vlc_common.h>
 #include <vlc_list.h>
+#include <vlc_tick.h>
 
 # ifdef __cplusplus
 extern "C" {
@@ -31,6 +32,50 @@ extern "C" {
 /** Executor type (opaque) */
 typedef struct vlc_executor vlc_executor_t;
 
+/**
+ * Priority of a runnable.
+ *
+ * Pending runnables of a higher priority are always started before pending
+ * runnables of a lower priority. Runnables of the same priority are started
+ * in submission order (except for runnables submitted from an executor
+ * thread, see vlc_executor_SubmitPriority()).
+ */
+enum vlc_executor_priority
+{
+    VLC_EXECUTOR_PRIORITY_LOW,
+    VLC_EXECUTOR_PRIORITY_NORMAL,
+    VLC_EXECUTOR_PRIORITY_HIGH,
+};
+
+/**
+ * Executor statistics, see vlc_executor_GetStats().
+ */
+struct vlc_executor_stats
+{
+    /** Number of threads spawned by the executor */
+    unsigned threads;
+    /** Number of runnables currently running */
+    unsigned running;
+    /** Number of runnables pending, for each priority */
+    size_t queued[VLC_EXECUTOR_PRIORITY_HIGH + 1];
+
+    /** Number of runnables submitted since creation */
+    uint64_t submitted;
+    /** Number of runnables run to completion */
+    uint64_t completed;
+    /** Number of runnables canceled before being started */
+    uint64_t canceled;
+    /** Number of runnables taken from the queue of another thread */
+    uint64_t stolen;
+
+    /** Total time spent by started runnables in the queue */
+    vlc_tick_t wait_time;
+    /** Longest time spent by a started runnable in the queue */
+    vlc_tick_t max_wait_time;
+    /** Total time spent running runnables */
+    vlc_tick_t run_time;
+};
+
 /**
  * A Runnable encapsulates a task to be run from an executor thread.
  */
@@ -60,6 +105,8 @@ struct vlc_runnable {
 
     /* Private data used by the vlc_executor_t (do not touch) */
     struct vlc_list node;
+    vlc_tick_t submitted;
+    enum vlc_executor_priority priority;
 };
 
 /**
@@ -145,6 +192,26 @@ vlc_executor_Delete(vlc_executor_t *executor);
 VLC_API void
 vlc_executor_Submit(vlc_executor_t *executor, struct vlc_runnable *runnable);
 
+/**
+ * Submit a runnable for execution with a given priority.
+ *
+ * This is the same as vlc_executor_Submit() (which uses
+ * VLC_EXECUTOR_PRIORITY_NORMAL), except that the runnable will be started
+ * before any pending runnable of a lower priority.
+ *
+ * A runnable submitted from one of the executor threads (i.e. by a runnable
+ * spawning sub-tasks) is queued on that thread, which will run it next
+ * (last-in first-out) unless an idle thread steals it first (oldest first).
+ *
+ * \param executor the executor
+ * \param runnable the task to run
+ * \param priority the priority of the task
+ */
+VLC_API void
+vlc_executor_SubmitPriority(vlc_executor_t *executor,
+                            struct vlc_runnable *runnable,
+                            enum vlc_executor_priority priority);
+
 /**
  * Cancel a runnable previously submitted.
  *
@@ -176,6 +243,18 @@ vlc_executor_Cancel(vlc_executor_t *executor, struct vlc_runnable *runnable);
 VLC_API void
 vlc_executor_WaitIdle(vlc_executor_t *executor);
 
+/**
+ * Get the executor statistics.
+ *
+ * The counters are sampled atomically with regard to the executor state.
+ *
+ * \param executor the executor
+ * \param stats the statistics to fill
+ */
+VLC_API void
+vlc_executor_GetStats(vlc_executor_t *executor,
+                      struct vlc_executor_stats *stats);
+
 # ifdef __cplusplus
 }
 # endif
@@ -598,7 +598,8 @@ VLC_API vlc_video_context *filter_chain_GetVideoCtxOut(const filter_chain_t *cha
  * Apply the filter chain to a video picture.
  *
  * \param chain pointer to filter chain
- * \param pic picture to apply filters to
+ * \param pic picture to apply filters to, or NULL to fetch the pictures
+ * still pending in the chain
  * \return modified picture after applying all video filters
  */
 VLC_API picture_t *filter_chain_VideoFilter(filter_chain_t *chain,
@@ -609,6 +610,35 @@ VLC_API picture_t *filter_chain_VideoFilter(filter_chain_t *chain,
  */
 VLC_API void filter_chain_VideoFlush( filter_chain_t * );
 
+/**
+ * Runs the filters of a video chain on their own threads.
+ *
+ * Each filter of the chain becomes a stage with its own thread, fed by a
+ * queue of at most depth pictures. filter_chain_VideoFilter() then queues
+ * the input picture, blocking only while the first queue is full, and
+ * returns the next picture out of the chain if any, in order.
+ *
+ * The owner picture allocation callback is called from the thread of the
+ * last stage. Mouse events must not be sent to a pipelined chain.
+ *
+ * This must be called before filtering the first picture, or after a flush.
+ *
+ * \param chain pointer to a video filter chain
+ * \param depth maximum number of pictures queued per stage,
+ *              0 to filter synchronously (the default)
+ */
+VLC_API void filter_chain_SetPipelined( filter_chain_t *chain,
+                                        unsigned depth );
+
+/**
+ * Drain a video filter chain.
+ *
+ * Waits until all the pictures queued in a pipelined chain are processed.
+ * The resulting pictures are then returned by filter_chain_VideoFilter()
+ * called with a NULL picture. This does nothing on a synchronous chain.
+ */
+VLC_API void filter_chain_VideoDrain( filter_chain_t * );
+
 /**
  * Apply the filter chain to a mouse state.
  *
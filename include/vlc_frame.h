@@ -190,6 +190,41 @@ VLC_API vlc_frame_t *vlc_frame_New(const struct vlc_frame_callbacks *cbs,
  */
 VLC_API vlc_frame_t *vlc_frame_Alloc(size_t size) VLC_USED VLC_MALLOC;
 
+/**
+ * Frame allocator statistics, see vlc_frame_GetAllocStats().
+ */
+struct vlc_frame_alloc_stats
+{
+    /** Frames allocated from the frame cache by vlc_frame_Alloc() */
+    uint64_t allocs;
+    /** Allocations served without the system allocator */
+    uint64_t hits;
+    /** Cacheable frames released */
+    uint64_t releases;
+    /** Frames currently kept for reuse */
+    size_t cached_frames;
+    /** Memory currently kept for reuse (payload only) */
+    size_t cached_bytes;
+};
+
+/**
+ * Gets the frame allocator statistics.
+ *
+ * vlc_frame_Alloc() reuses the memory of released frames up to a certain
+ * size. Larger frames are not accounted for.
+ *
+ * @param stats statistics to fill [OUT]
+ */
+VLC_API void vlc_frame_GetAllocStats(struct vlc_frame_alloc_stats *stats);
+
+/**
+ * Frees the memory kept for reuse by vlc_frame_Alloc().
+ *
+ * Frames still in use are not affected, and go back to the caches when
+ * released. LibVLC calls this when an instance is released.
+ */
+VLC_API void vlc_frame_TrimCaches(void);
+
 VLC_API vlc_frame_t *vlc_frame_TryRealloc(vlc_frame_t *, ssize_t pre, size_t body) VLC_USED;
 
 /**
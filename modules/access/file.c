@@ -44,6 +44,10 @@
 #   include <linux/magic.h>
 #endif
 
+#ifdef HAVE_MMAP
+#   include <sys/mman.h>
+#endif
+
 #if defined( _WIN32 )
 #   include <io.h>
 #   include <ctype.h>
@@ -66,6 +70,13 @@ typedef struct
     int fd;
 
     bool b_pace_control;
+#ifdef HAVE_MMAP
+    /* Memory-mapped mode */
+    uint64_t offset;
+    size_t map_size;
+    size_t page_size;
+    bool b_seek;
+#endif
 } access_sys_t;
 
 #if !defined (_WIN32) && !defined (__OS2__)
@@ -161,12 +172,26 @@ static bool IsRemote (const char *path)
 # define IsRemote(fd,path) IsRemote(path)
 #endif
 
+#ifdef HAVE_MMAP
+/* Mappings start small after a seek, as the demuxer is likely looking
+ * something up, and grow while the file is read sequentially. */
+# define FILE_MMAP_MIN_SIZE (64 << 10)
+# define FILE_MMAP_MAX_SIZE (4 << 20)
+#endif
+
 #ifndef HAVE_POSIX_FADVISE
 # define posix_fadvise(fd, off, len, adv)
 #endif
+#ifndef HAVE_POSIX_MADVISE
+# define posix_madvise(addr, len, adv)
+#endif
 
 static ssize_t Read (stream_t *, void *, size_t);
 static int FileSeek (stream_t *, uint64_t);
+#ifdef HAVE_MMAP
+static block_t *BlockMmap (stream_t *, bool *);
+static int FileSeekMmap (stream_t *, uint64_t);
+#endif
 static int FileControl (stream_t *, int, va_list);
 
 /*****************************************************************************
@@ -278,6 +303,24 @@ int FileOpen( vlc_object_t *p_this )
         p_sys->b_pace_control = strcasecmp (p_access->psz_name, "stream");
     }
 
+#ifdef HAVE_MMAP
+    /* Hand out blocks pointing straight into the page cache. This is only
+     * safe if the file is not truncated behind our back, so it is opt-in,
+     * and never used on network file systems. */
+    if (S_ISREG (st.st_mode) && var_InheritBool (p_access, "file-mmap")
+     && !IsRemote(fd, p_access->psz_filepath))
+    {
+        p_access->pf_read = NULL;
+        p_access->pf_block = BlockMmap;
+        p_access->pf_seek = FileSeekMmap;
+        p_sys->offset = 0;
+        p_sys->map_size = FILE_MMAP_MIN_SIZE;
+        p_sys->page_size = sysconf (_SC_PAGESIZE);
+        p_sys->b_seek = true;
+        msg_Dbg (p_access, "using memory-mapped file access");
+    }
+#endif
+
     return VLC_SUCCESS;
 
 error:
@@ -292,7 +335,7 @@ void FileClose (vlc_object_t * p_this)
 {
     stream_t     *p_access = (stream_t*)p_this;
 
-    if (p_access->pf_read == NULL)
+    if (p_access->pf_control != FileControl)
     {
         DirClose (p_this);
         return;
@@ -338,6 +381,82 @@ static int FileSeek (stream_t *p_access, uint64_t i_pos)
     return VLC_SUCCESS;
 }
 
+#ifdef HAVE_MMAP
+static block_t *BlockMmap (stream_t *p_access, bool *restrict eof)
+{
+    access_sys_t *sys = p_access->p_sys;
+    struct stat st;
+
+    /* Touching a mapping past the end of the file raises SIGBUS, so never
+     * map beyond the current size (the file may still be growing). */
+    if (fstat (sys->fd, &st))
+    {
+        msg_Err (p_access, "read error: %s", vlc_strerror_c(errno));
+        *eof = true;
+        return NULL;
+    }
+
+    if (sys->offset >= (uint64_t)st.st_size)
+    {
+        *eof = true;
+        return NULL;
+    }
+
+    uint64_t start = sys->offset & ~(uint64_t)(sys->page_size - 1);
+    size_t skew = sys->offset - start;
+    size_t length = sys->map_size;
+
+    if ((uint64_t)st.st_size - start < length)
+        length = st.st_size - start;
+
+    void *addr = mmap (NULL, length, PROT_READ, MAP_SHARED, sys->fd, start);
+    if (addr == MAP_FAILED)
+    {
+        msg_Err (p_access, "memory mapping error: %s", vlc_strerror_c(errno));
+        *eof = true;
+        return NULL;
+    }
+
+    if (sys->b_seek)
+        /* Random access, e.g. index lookup: only fetch what was asked */
+        posix_madvise (addr, length, POSIX_MADV_WILLNEED);
+    else
+    {
+        /* Sequential access: let the kernel read ahead aggressively and
+         * drop pages behind, and start fetching the next window already. */
+        posix_madvise (addr, length, POSIX_MADV_SEQUENTIAL);
+        posix_fadvise (sys->fd, start + length, length, POSIX_FADV_WILLNEED);
+    }
+
+    block_t *block = block_mmap_Alloc (addr, length);
+    if (unlikely(block == NULL))
+        return NULL;
+
+    block->p_buffer += skew;
+    block->i_buffer -= skew;
+
+    sys->offset = start + length;
+    sys->b_seek = false;
+    if (sys->map_size < FILE_MMAP_MAX_SIZE)
+        sys->map_size *= 2;
+    return block;
+}
+
+static int FileSeekMmap (stream_t *p_access, uint64_t i_pos)
+{
+    access_sys_t *sys = p_access->p_sys;
+
+    if (i_pos == sys->offset)
+        return VLC_SUCCESS;
+
+    /* Start over with small mappings until the access is sequential again */
+    sys->offset = i_pos;
+    sys->map_size = FILE_MMAP_MIN_SIZE;
+    sys->b_seek = true;
+    return VLC_SUCCESS;
+}
+#endif
+
 /*****************************************************************************
  * Control:
  *****************************************************************************/
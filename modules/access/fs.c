@@ -38,6 +38,13 @@ vlc_module_begin ()
     add_shortcut( "file", "fd", "stream" )
     set_callbacks( FileOpen, FileClose )
 
+#ifdef HAVE_MMAP
+    add_bool("file-mmap", false, N_("Memory-map local files"),
+             N_("Read local files through memory mappings instead of "
+                "copying them, which is faster for large files. "
+                "The files must not be truncated while they are open."))
+#endif
+
     add_submodule()
     set_section( N_("Directory" ), NULL )
     set_capability( "access", 55 )
@@ -25,6 +25,7 @@
 #include <assert.h>
 #include <vlc_common.h>
 #include <vlc_network.h>
+#include <vlc_threads.h>
 #include <vlc_tls.h>
 #include <vlc_url.h>
 #include "transport.h"
@@ -103,6 +104,8 @@ struct vlc_http_mgr
     vlc_tls_client_t *creds;
     struct vlc_http_cookie_jar_t *jar;
     struct vlc_http_conn *conn;
+    bool multiplexed; /**< whether conn can carry concurrent streams */
+    vlc_mutex_t lock;
 };
 
 static struct vlc_http_conn *vlc_http_mgr_find(struct vlc_http_mgr *mgr,
@@ -117,10 +120,21 @@ static void vlc_http_mgr_release(struct vlc_http_mgr *mgr,
 {
     assert(mgr->conn == conn);
     mgr->conn = NULL;
+    mgr->multiplexed = false;
 
     vlc_http_conn_release(conn);
 }
 
+static void vlc_http_mgr_set(struct vlc_http_mgr *mgr,
+                             struct vlc_http_conn *conn, bool multiplexed)
+{
+    if (mgr->conn != NULL)
+        vlc_http_mgr_release(mgr, mgr->conn);
+
+    mgr->conn = conn;
+    mgr->multiplexed = multiplexed;
+}
+
 static
 struct vlc_http_msg *vlc_http_mgr_reuse(struct vlc_http_mgr *mgr,
                                         const char *host, unsigned port,
@@ -134,9 +148,16 @@ struct vlc_http_msg *vlc_http_mgr_reuse(struct vlc_http_mgr *mgr,
     struct vlc_http_stream *stream = vlc_http_stream_open(conn, req, payload);
     if (stream != NULL)
     {
+        /* The stream keeps the connection alive even if another thread
+         * replaces it in the meantime. Other requests can be multiplexed on
+         * the same connection while this one waits for its response. */
+        vlc_mutex_unlock(&mgr->lock);
         struct vlc_http_msg *m = vlc_http_msg_get_initial(stream);
+        vlc_mutex_lock(&mgr->lock);
         if (m != NULL)
             return m;
+        if (mgr->conn != conn)
+            return NULL; /* already replaced */
     }
     /* Get rid of closing or reset connection */
     vlc_http_mgr_release(mgr, conn);
@@ -206,10 +227,7 @@ static struct vlc_http_msg *vlc_https_request(struct vlc_http_mgr *mgr,
         return NULL;
     }
 
-    if (mgr->conn != NULL)
-        vlc_http_mgr_release(mgr, mgr->conn);
-
-    mgr->conn = conn;
+    vlc_http_mgr_set(mgr, conn, http2);
     return vlc_http_mgr_reuse(mgr, host, port, req, payload);
 }
 
@@ -263,10 +281,7 @@ static struct vlc_http_msg *vlc_http_request(struct vlc_http_mgr *mgr,
         return NULL;
     }
 
-    if (mgr->conn != NULL)
-        vlc_http_mgr_release(mgr, mgr->conn);
-
-    mgr->conn = conn;
+    vlc_http_mgr_set(mgr, conn, false);
     return resp;
 }
 
@@ -278,8 +293,20 @@ struct vlc_http_msg *vlc_http_mgr_request(struct vlc_http_mgr *mgr, bool https,
     if (port && vlc_http_port_blocked(port))
         return NULL;
 
-    return (https ? vlc_https_request : vlc_http_request)(mgr, host, port, m,
-                                                          idempotent, payload);
+    vlc_mutex_lock(&mgr->lock);
+    struct vlc_http_msg *resp =
+        (https ? vlc_https_request : vlc_http_request)(mgr, host, port, m,
+                                                       idempotent, payload);
+    vlc_mutex_unlock(&mgr->lock);
+    return resp;
+}
+
+bool vlc_http_mgr_is_multiplexed(struct vlc_http_mgr *mgr)
+{
+    vlc_mutex_lock(&mgr->lock);
+    bool multiplexed = mgr->multiplexed;
+    vlc_mutex_unlock(&mgr->lock);
+    return multiplexed;
 }
 
 struct vlc_http_cookie_jar_t *vlc_http_mgr_get_jar(struct vlc_http_mgr *mgr)
@@ -299,6 +326,8 @@ struct vlc_http_mgr *vlc_http_mgr_create(vlc_object_t *obj,
     mgr->creds = NULL;
     mgr->jar = jar;
     mgr->conn = NULL;
+    mgr->multiplexed = false;
+    vlc_mutex_init(&mgr->lock);
     return mgr;
 }
 
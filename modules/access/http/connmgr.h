@@ -57,6 +57,16 @@ struct vlc_http_msg *vlc_http_mgr_request(struct vlc_http_mgr *mgr, bool https,
 
 struct vlc_http_cookie_jar_t *vlc_http_mgr_get_jar(struct vlc_http_mgr *);
 
+/**
+ * Checks whether requests are multiplexed
+ * Tells whether the current connection of the manager, if any, can carry
+ * several concurrent requests (i.e. it is an HTTP/2 connection). The manager
+ * is thread-safe, so such a manager can be shared by concurrent requesters,
+ * each getting its own stream on the same connection.
+ * @param mgr HTTP connection manager
+ */
+bool vlc_http_mgr_is_multiplexed(struct vlc_http_mgr *mgr);
+
 /**
  * Creates an HTTP connection manager
  *
@@ -0,0 +1,411 @@
+/*****************************************************************************
+ * connmgr_test.c: HTTP connection manager tests
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#undef NDEBUG
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vlc_common.h>
+#include <vlc_network.h>
+#include <vlc_threads.h>
+#include <vlc_tls.h>
+#include "conn.h"
+#include "connmgr.h"
+#include "message.h"
+
+const char vlc_module_name[] = "test_http_connmgr";
+
+/* Fake HTTP/2 connections: any number of streams, whose response headers
+ * are held until the test answers them */
+struct test_conn
+{
+    struct vlc_http_conn conn;
+    unsigned streams; /**< open streams */
+    unsigned waiting; /**< streams waiting for their response headers */
+    unsigned replies; /**< responses to hand out */
+    bool reset; /**< waiting streams fail */
+    bool closing; /**< new streams are refused */
+    bool released; /**< released by the manager */
+};
+
+struct test_stream
+{
+    struct vlc_http_stream stream;
+    struct test_conn *conn;
+};
+
+#define MAX_CONNS 8
+
+static vlc_mutex_t lock = VLC_STATIC_MUTEX;
+static vlc_cond_t cond = VLC_STATIC_COND;
+static struct test_conn *conns[MAX_CONNS];
+static unsigned conn_count = 0;
+static unsigned live_count = 0;
+
+static void conn_destroy(struct test_conn *conn)
+{
+    vlc_mutex_assert(&lock);
+    assert(conn->released && conn->streams == 0);
+    live_count--;
+}
+
+static struct vlc_http_msg *stream_read_headers(struct vlc_http_stream *s)
+{
+    struct test_stream *stream = container_of(s, struct test_stream, stream);
+    struct test_conn *conn = stream->conn;
+
+    vlc_mutex_lock(&lock);
+    conn->waiting++;
+    vlc_cond_broadcast(&cond);
+    while (!conn->reset && conn->replies == 0)
+        vlc_cond_wait(&cond, &lock);
+    conn->waiting--;
+
+    bool ok = !conn->reset;
+    if (ok)
+        conn->replies--;
+    vlc_mutex_unlock(&lock);
+
+    if (!ok)
+        return NULL;
+
+    struct vlc_http_msg *m = vlc_http_resp_create(200);
+    assert(m != NULL);
+    vlc_http_msg_attach(m, s);
+    return m;
+}
+
+static block_t *stream_read(struct vlc_http_stream *s)
+{
+    (void) s;
+    return NULL;
+}
+
+static void stream_close(struct vlc_http_stream *s, bool abort)
+{
+    struct test_stream *stream = container_of(s, struct test_stream, stream);
+    struct test_conn *conn = stream->conn;
+
+    (void) abort;
+    vlc_mutex_lock(&lock);
+    assert(conn->streams > 0);
+    conn->streams--;
+    if (conn->released && conn->streams == 0)
+        conn_destroy(conn);
+    vlc_mutex_unlock(&lock);
+    free(stream);
+}
+
+static const struct vlc_http_stream_cbs stream_callbacks =
+{
+    stream_read_headers,
+    NULL,
+    stream_read,
+    stream_close,
+};
+
+static struct vlc_http_stream *conn_stream_open(struct vlc_http_conn *c,
+                                                const struct vlc_http_msg *m,
+                                                bool has_data)
+{
+    struct test_conn *conn = container_of(c, struct test_conn, conn);
+
+    (void) m; (void) has_data;
+    vlc_mutex_lock(&lock);
+    assert(!conn->released);
+    if (conn->closing)
+    {
+        vlc_mutex_unlock(&lock);
+        return NULL;
+    }
+    conn->streams++;
+    vlc_mutex_unlock(&lock);
+
+    struct test_stream *stream = malloc(sizeof (*stream));
+    assert(stream != NULL);
+    stream->stream.cbs = &stream_callbacks;
+    stream->conn = conn;
+    return &stream->stream;
+}
+
+static void conn_release(struct vlc_http_conn *c)
+{
+    struct test_conn *conn = container_of(c, struct test_conn, conn);
+
+    vlc_mutex_lock(&lock);
+    assert(!conn->released);
+    conn->released = true;
+    if (conn->streams == 0)
+        conn_destroy(conn);
+    vlc_mutex_unlock(&lock);
+}
+
+static const struct vlc_http_conn_cbs conn_callbacks =
+{
+    conn_stream_open,
+    conn_release,
+};
+
+/* Transport of the connection manager */
+static vlc_tls_client_t test_creds;
+static vlc_tls_t test_tls;
+
+vlc_tls_client_t *vlc_tls_ClientCreate(vlc_object_t *obj)
+{
+    (void) obj;
+    return &test_creds;
+}
+
+void vlc_tls_ClientDelete(vlc_tls_client_t *creds)
+{
+    assert(creds == &test_creds);
+}
+
+vlc_tls_t *vlc_tls_SocketOpenTLS(vlc_tls_client_t *creds, const char *name,
+                                 unsigned port, const char *service,
+                                 const char *const *alpn, char **alp)
+{
+    assert(creds == &test_creds);
+    assert(!strcmp(name, "www.example.com"));
+    assert(port == 443);
+    (void) service;
+    assert(alpn != NULL && !strcmp(alpn[0], "h2"));
+    *alp = strdup("h2");
+    assert(*alp != NULL);
+    return &test_tls;
+}
+
+char *vlc_getProxyUrl(const char *url)
+{
+    (void) url;
+    return NULL;
+}
+
+struct vlc_http_conn *vlc_h2_conn_create(void *ctx, struct vlc_tls *tls)
+{
+    (void) ctx;
+    assert(tls == &test_tls);
+
+    struct test_conn *conn = calloc(1, sizeof (*conn));
+    assert(conn != NULL);
+    conn->conn.cbs = &conn_callbacks;
+    conn->conn.tls = tls;
+
+    vlc_mutex_lock(&lock);
+    assert(conn_count < MAX_CONNS);
+    conns[conn_count++] = conn;
+    live_count++;
+    vlc_mutex_unlock(&lock);
+    return &conn->conn;
+}
+
+struct vlc_http_conn *vlc_h1_conn_create(void *ctx, struct vlc_tls *tls,
+                                         bool proxy)
+{
+    (void) ctx; (void) tls; (void) proxy;
+    assert(!"HTTP/1 connection");
+    return NULL;
+}
+
+struct vlc_http_stream *vlc_h1_request(void *ctx, const char *hostname,
+                                       unsigned port, bool proxy,
+                                       const struct vlc_http_msg *req,
+                                       bool idempotent, bool has_data,
+                                       struct vlc_http_conn **restrict connp)
+{
+    (void) ctx; (void) hostname; (void) port; (void) proxy; (void) req;
+    (void) idempotent; (void) has_data; (void) connp;
+    assert(!"HTTP/1 request");
+    return NULL;
+}
+
+vlc_tls_t *vlc_https_connect_proxy(void *ctx, vlc_tls_client_t *creds,
+                                   const char *name, unsigned port,
+                                   bool *restrict two, const char *proxy)
+{
+    (void) ctx; (void) creds; (void) name; (void) port; (void) two;
+    (void) proxy;
+    assert(!"proxy");
+    return NULL;
+}
+
+/* Callback for vlc_http_msg_h2_frame */
+#include "h2frame.h"
+
+struct vlc_h2_frame *
+vlc_h2_frame_headers(uint_fast32_t id, uint_fast32_t mtu, bool eos,
+                     unsigned count, const char *const tab[][2])
+{
+    (void) id; (void) mtu; (void) eos; (void) count, (void) tab;
+    assert(!"HTTP/2 frame");
+    return NULL;
+}
+
+/* Requesters */
+struct request
+{
+    struct vlc_http_mgr *mgr;
+    struct vlc_http_msg *resp;
+    vlc_thread_t thread;
+};
+
+static void *request_thread(void *data)
+{
+    struct request *r = data;
+    struct vlc_http_msg *req = vlc_http_req_create("GET", "https",
+                                                   "www.example.com", "/");
+    assert(req != NULL);
+    r->resp = vlc_http_mgr_request(r->mgr, true, "www.example.com", 0, req,
+                                   true, false);
+    vlc_http_msg_destroy(req);
+    return NULL;
+}
+
+static void request_start(struct request *r, struct vlc_http_mgr *mgr)
+{
+    r->mgr = mgr;
+    r->resp = NULL;
+    assert(vlc_clone(&r->thread, request_thread, r) == 0);
+}
+
+static void request_finish(struct request *r)
+{
+    vlc_join(r->thread, NULL);
+    assert(r->resp != NULL);
+    assert(vlc_http_msg_get_status(r->resp) == 200);
+    vlc_http_msg_destroy(r->resp);
+}
+
+/* Waits for a number of requests to wait for their headers on a connection.
+ * Fails rather than hangs if they are held by the manager. */
+static void wait_requests(unsigned index, unsigned count)
+{
+    vlc_tick_t deadline = vlc_tick_now() + VLC_TICK_FROM_SEC(10);
+
+    vlc_mutex_lock(&lock);
+    while (conn_count <= index || conns[index]->waiting < count)
+        assert(vlc_cond_timedwait(&cond, &lock, deadline) == 0);
+    assert(conns[index]->waiting == count);
+    vlc_mutex_unlock(&lock);
+}
+
+static void reply(unsigned index, unsigned count)
+{
+    vlc_mutex_lock(&lock);
+    conns[index]->replies += count;
+    vlc_cond_broadcast(&cond);
+    vlc_mutex_unlock(&lock);
+}
+
+static void test_concurrent(vlc_object_t *obj)
+{
+    struct vlc_http_mgr *mgr = vlc_http_mgr_create(obj, NULL);
+    struct request a, b;
+    assert(mgr != NULL);
+
+    /* The second request gets its stream while the first one waits */
+    request_start(&a, mgr);
+    wait_requests(0, 1);
+    request_start(&b, mgr);
+    wait_requests(0, 2);
+    assert(conn_count == 1);
+    assert(vlc_http_mgr_is_multiplexed(mgr));
+
+    reply(0, 2);
+    request_finish(&a);
+    request_finish(&b);
+
+    vlc_http_mgr_destroy(mgr);
+    assert(live_count == 0);
+}
+
+static void test_replaced(vlc_object_t *obj)
+{
+    struct vlc_http_mgr *mgr = vlc_http_mgr_create(obj, NULL);
+    struct request a, b;
+    assert(mgr != NULL);
+
+    /* Only a request on an existing connection is retried if it fails */
+    request_start(&a, mgr);
+    wait_requests(0, 1);
+    reply(0, 1);
+    request_finish(&a);
+
+    request_start(&a, mgr);
+    wait_requests(0, 1);
+
+    /* The connection goes away: the next request replaces it */
+    vlc_mutex_lock(&lock);
+    conns[0]->closing = true;
+    vlc_mutex_unlock(&lock);
+    request_start(&b, mgr);
+    wait_requests(1, 1);
+    vlc_mutex_lock(&lock);
+    assert(conns[0]->released);
+    assert(conns[0]->streams == 1);
+    vlc_mutex_unlock(&lock);
+
+    /* The first request fails on the replaced connection, and must leave the
+     * current one alone before retrying */
+    vlc_mutex_lock(&lock);
+    conns[0]->reset = true;
+    vlc_cond_broadcast(&cond);
+    vlc_mutex_unlock(&lock);
+    wait_requests(2, 1);
+    vlc_mutex_lock(&lock);
+    assert(conns[1]->released);
+    assert(conns[1]->streams == 1);
+    assert(!conns[2]->released);
+    vlc_mutex_unlock(&lock);
+
+    reply(1, 1);
+    reply(2, 1);
+    request_finish(&a);
+    request_finish(&b);
+    assert(live_count == 1);
+
+    vlc_http_mgr_destroy(mgr);
+    assert(live_count == 0);
+}
+
+int main(void)
+{
+    vlc_object_t obj;
+
+    memset(&obj, 0, sizeof (obj));
+
+    test_concurrent(&obj);
+
+    for (unsigned i = 0; i < conn_count; i++)
+        free(conns[i]);
+    conn_count = 0;
+
+    test_replaced(&obj);
+
+    for (unsigned i = 0; i < conn_count; i++)
+        free(conns[i]);
+    return 0;
+}
@@ -53,13 +53,29 @@
  */
 #define MRU 65507u
 
+#ifdef HAVE_RECVMMSG
+/* Datagrams received per system call */
+# define BATCH 64
+/* Initial datagram buffer size, enough for any Ethernet MTU */
+# define SLOT_SIZE 2048u
+#endif
+
 typedef struct {
     int fd;
     int timeout;
 
+#ifdef HAVE_RECVMMSG
+    unsigned mru;
+    unsigned next;
+    unsigned count;
+    block_t *slots[BATCH];
+    struct iovec iov[BATCH];
+    struct mmsghdr msgs[BATCH];
+#else
     size_t length;
     char *offset;
     char buf[MRU];
+#endif
 } access_sys_t;
 
 static int Control(stream_t *access, int query, va_list args)
@@ -83,6 +99,81 @@ static int Control(stream_t *access, int query, va_list args)
     return VLC_SUCCESS;
 }
 
+#ifdef HAVE_RECVMMSG
+static block_t *BlockRecv(stream_t *access, bool *restrict eof)
+{
+    access_sys_t *sys = access->p_sys;
+
+    while (sys->next < sys->count) {
+        block_t *block = sys->slots[sys->next];
+
+        sys->slots[sys->next++] = NULL;
+        if (likely(block->i_buffer > 0))
+            return block;
+        block_Release(block);
+    }
+
+    /* Replace the buffers handed out by the previous receive */
+    for (unsigned i = 0; i < BATCH; i++) {
+        if (sys->slots[i] == NULL) {
+            sys->slots[i] = block_Alloc(sys->mru);
+            if (unlikely(sys->slots[i] == NULL))
+                return NULL;
+        }
+
+        sys->iov[i].iov_base = sys->slots[i]->p_buffer;
+        sys->iov[i].iov_len = sys->slots[i]->i_buffer;
+        sys->msgs[i].msg_hdr.msg_iov = &sys->iov[i];
+        sys->msgs[i].msg_hdr.msg_iovlen = 1;
+        sys->msgs[i].msg_hdr.msg_flags = 0;
+    }
+
+    struct pollfd ufd[1];
+
+    ufd[0].fd = sys->fd;
+    ufd[0].events = POLLIN;
+
+    switch (vlc_poll_i11e(ufd, 1, sys->timeout)) {
+        case 0:
+            msg_Err(access, "receive time-out");
+            *eof = true;
+            return NULL;
+        case -1:
+            return NULL;
+    }
+
+    int val = recvmmsg(sys->fd, sys->msgs, BATCH, MSG_DONTWAIT, NULL);
+    if (val <= 0)
+        return NULL;
+
+    bool truncated = false;
+
+    for (int i = 0; i < val; i++) {
+        block_t *block = sys->slots[i];
+
+        if (sys->msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+            block->i_flags |= BLOCK_FLAG_CORRUPTED;
+            truncated = true;
+        }
+        else
+            block->i_buffer = sys->msgs[i].msg_len;
+    }
+
+    if (truncated && sys->mru < MRU) {
+        msg_Warn(access, "datagram truncated, using %u bytes buffers", MRU);
+        sys->mru = MRU;
+
+        for (unsigned i = val; i < BATCH; i++) {
+            block_Release(sys->slots[i]);
+            sys->slots[i] = NULL;
+        }
+    }
+
+    sys->next = 0;
+    sys->count = val;
+    return BlockRecv(access, eof);
+}
+#else
 static ssize_t Read(stream_t *access, void *buf, size_t len)
 {
     access_sys_t *sys = access->p_sys;
@@ -131,6 +222,7 @@ static ssize_t Read(stream_t *access, void *buf, size_t len)
 
     return val;
 }
+#endif
 
 /*****************************************************************************
  * Open: open the socket
@@ -147,10 +239,20 @@ static int Open( vlc_object_t *p_this )
     if( unlikely( sys == NULL ) )
         return VLC_ENOMEM;
 
-    sys->length = 0;
     p_access->p_sys = sys;
+#ifdef HAVE_RECVMMSG
+    sys->mru = SLOT_SIZE;
+    sys->next = 0;
+    sys->count = 0;
+    memset(sys->slots, 0, sizeof (sys->slots));
+    memset(sys->msgs, 0, sizeof (sys->msgs));
+    p_access->pf_read = NULL;
+    p_access->pf_block = BlockRecv;
+#else
+    sys->length = 0;
     p_access->pf_read = Read;
     p_access->pf_block = NULL;
+#endif
     p_access->pf_control = Control;
     p_access->pf_seek = NULL;
 
@@ -229,6 +331,11 @@ static void Close( vlc_object_t *p_this )
     access_sys_t *sys = p_access->p_sys;
 
     net_Close( sys->fd );
+#ifdef HAVE_RECVMMSG
+    for( unsigned i = 0; i < BATCH; i++ )
+        if( sys->slots[i] != NULL )
+            block_Release( sys->slots[i] );
+#endif
 }
 
 #define TIMEOUT_TEXT N_("UDP Source timeout (sec)")
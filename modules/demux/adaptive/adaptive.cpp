@@ -81,6 +81,10 @@ static void Close   (vlc_object_t *);
 #define ADAPT_ACCESS_TEXT N_("Use regular HTTP modules")
 #define ADAPT_ACCESS_LONGTEXT N_("Connect using HTTP access instead of custom HTTP code")
 
+#define ADAPT_DOWNLOADS_TEXT N_("Concurrent downloads")
+#define ADAPT_DOWNLOADS_LONGTEXT N_("Maximum number of segments downloaded at once. " \
+                                    "The segments needed first for playback are fetched first.")
+
 #define ADAPT_LOWLATENCY_TEXT N_("Low latency")
 #define ADAPT_LOWLATENCY_LONGTEXT N_("Overrides low latency parameters")
 
@@ -141,6 +145,8 @@ vlc_module_begin ()
         add_integer( "adaptive-maxbuffer",
                      MS_FROM_VLC_TICK(AbstractBufferingLogic::DEFAULT_MAX_BUFFERING),
                      ADAPT_MAXBUFFER_TEXT, nullptr )
+        add_integer( "adaptive-downloads", 3, ADAPT_DOWNLOADS_TEXT, ADAPT_DOWNLOADS_LONGTEXT )
+            change_integer_range( 1, 16 )
         add_integer( "adaptive-lowlatency", -1, ADAPT_LOWLATENCY_TEXT, ADAPT_LOWLATENCY_LONGTEXT )
             change_integer_list(rgi_latency, ppsz_latency)
         set_callbacks( Open, Close )
@@ -282,14 +288,18 @@ static PlaylistManager * HandleDash(demux_t *p_demux, DOMParser &xmlParser,
                                     const std::string & playlisturl,
                                     AbstractAdaptationLogic::LogicType logic)
 {
+    SegmentTimelineHandler timelineHandler;
+    xmlParser.setElementHandler(&timelineHandler);
     if(!xmlParser.reset(p_demux->s) || !xmlParser.parse(true))
     {
+        xmlParser.setElementHandler(nullptr);
         msg_Err(p_demux, "Cannot parse MPD");
         return nullptr;
     }
     IsoffMainParser mpdparser(xmlParser.getRootNode(), VLC_OBJECT(p_demux),
-                              p_demux->s, playlisturl);
+                              p_demux->s, playlisturl, &timelineHandler);
     MPD *p_playlist = mpdparser.parse();
+    xmlParser.setElementHandler(nullptr);
     if(p_playlist == nullptr)
     {
         msg_Err( p_demux, "Cannot create/unknown MPD for profile");
@@ -44,6 +44,7 @@ AbstractChunkSource::AbstractChunkSource(ChunkType t, const BytesRange &range)
     contentLength = 0;
     requeststatus = RequestStatus::Success;
     bytesRange = range;
+    deadline = VLC_TICK_INVALID;
     if(bytesRange.isValid() && bytesRange.getEndByte())
         contentLength = bytesRange.getEndByte() - bytesRange.getStartByte();
 }
@@ -78,6 +79,16 @@ ChunkType AbstractChunkSource::getChunkType() const
     return type;
 }
 
+void AbstractChunkSource::setDeadline(vlc_tick_t time)
+{
+    deadline = time;
+}
+
+vlc_tick_t AbstractChunkSource::getDeadline() const
+{
+    return deadline;
+}
+
 AbstractChunk::AbstractChunk(AbstractChunkSource *source_)
 {
     bytesRead = 0;
@@ -79,6 +79,9 @@ namespace adaptive
                 std::string getContentType  () const override;
                 RequestStatus getRequestStatus() const override;
                 virtual void        recycle() = 0;
+                /* playback time of the data, used to schedule downloads */
+                void                setDeadline     (vlc_tick_t);
+                vlc_tick_t          getDeadline     () const;
 
             protected:
                 AbstractChunkSource(ChunkType, const BytesRange & = BytesRange());
@@ -88,6 +91,7 @@ namespace adaptive
                 RequestStatus       requeststatus;
                 size_t              contentLength;
                 BytesRange          bytesRange;
+                vlc_tick_t          deadline;
         };
 
         class AbstractChunk : public ChunkInterface
@@ -29,38 +29,47 @@
 
 using namespace adaptive::http;
 
-Downloader::Downloader()
+Downloader::Worker::Worker(Downloader *downloader_)
 {
-    killed = false;
+    downloader = downloader_;
     thread_handle_valid = false;
-    current = nullptr;
     cancel_current = false;
+    current = nullptr;
+}
+
+Downloader::Downloader(unsigned count)
+{
+    killed = false;
+    workers.assign(count ? count : 1, Worker(this));
 }
 
 bool Downloader::start()
 {
-    if(!thread_handle_valid &&
-       vlc_clone(&thread_handle, downloaderThread, static_cast<void *>(this)))
+    for(Worker &worker : workers)
     {
-        return false;
+        if(!worker.thread_handle_valid &&
+           vlc_clone(&worker.thread_handle, downloaderThread, static_cast<void *>(&worker)))
+            break;
+        worker.thread_handle_valid = true;
     }
-    thread_handle_valid = true;
-    return true;
+    /* Fewer workers only means less concurrency */
+    return workers.front().thread_handle_valid;
 }
 
 Downloader::~Downloader()
 {
     kill();
 
-    if(thread_handle_valid)
-        vlc_join(thread_handle, nullptr);
+    for(Worker &worker : workers)
+        if(worker.thread_handle_valid)
+            vlc_join(worker.thread_handle, nullptr);
 }
 
 void Downloader::kill()
 {
     vlc::threads::mutex_locker locker {lock};
     killed = true;
-    wait_cond.signal();
+    wait_cond.broadcast();
 }
 
 void Downloader::schedule(HTTPChunkBufferedSource *source)
@@ -74,9 +83,11 @@ void Downloader::schedule(HTTPChunkBufferedSource *source)
 void Downloader::cancel(HTTPChunkBufferedSource *source)
 {
     vlc::threads::mutex_locker locker {lock};
-    while (current == source)
+    while (isActive(source))
     {
-        cancel_current = true;
+        for(Worker &worker : workers)
+            if(worker.current == source)
+                worker.cancel_current = true;
         updated_cond.wait(lock);
     }
 
@@ -87,21 +98,59 @@ void Downloader::cancel(HTTPChunkBufferedSource *source)
     }
 }
 
+bool Downloader::isActive(const HTTPChunkBufferedSource *source) const
+{
+    for(const Worker &worker : workers)
+        if(worker.current == source)
+            return true;
+    return false;
+}
+
+/* Picks the chunk to download next, a slice at a time: first the ones of
+ * the streams no other worker is serving, then the one needed first for
+ * playback, as its stream buffer will underrun first, then the oldest */
+HTTPChunkBufferedSource * Downloader::next() const
+{
+    HTTPChunkBufferedSource *best = nullptr;
+    bool best_served = true;
+
+    for(HTTPChunkBufferedSource *source : chunks)
+    {
+        if(isActive(source))
+            continue;
+
+        bool served = false;
+        for(const Worker &worker : workers)
+            if(worker.current && worker.current->sourceid == source->sourceid)
+                served = true;
+
+        if(best &&
+           (served > best_served ||
+            (served == best_served && source->getDeadline() >= best->getDeadline())))
+            continue;
+
+        best = source;
+        best_served = served;
+    }
+    return best;
+}
+
 void * Downloader::downloaderThread(void *opaque)
 {
     vlc_thread_set_name("vlc-adapt-dl");
-    Downloader *instance = static_cast<Downloader *>(opaque);
-    instance->Run();
+    Worker *worker = static_cast<Worker *>(opaque);
+    worker->downloader->Run(worker);
     return nullptr;
 }
 
-void Downloader::Run()
+void Downloader::Run(Worker *worker)
 {
     while(1)
     {
         lock.lock();
 
-        while(chunks.empty() && !killed)
+        HTTPChunkBufferedSource *source = nullptr;
+        while(!killed && !(source = next()))
             wait_cond.wait(lock);
 
         if(killed)
@@ -110,18 +159,20 @@ void Downloader::Run()
             break;
         }
 
-        current = chunks.front();
+        worker->current = source;
         lock.unlock();
-        current->bufferize(HTTPChunkSource::CHUNK_SIZE);
+        source->bufferize(HTTPChunkSource::CHUNK_SIZE);
         lock.lock();
-        if(current->isDone() || cancel_current)
+        if(source->isDone() || worker->cancel_current)
         {
-            chunks.pop_front();
-            current->release();
+            chunks.remove(source);
+            source->release();
         }
-        cancel_current = false;
-        current = nullptr;
-        updated_cond.signal();
+        worker->cancel_current = false;
+        worker->current = nullptr;
+        updated_cond.broadcast();
+        /* The chunk, or another one of its stream, can be picked again */
+        wait_cond.signal();
         lock.unlock();
     }
 }
@@ -26,6 +26,7 @@
 #include <vlc_threads.h>
 #include <vlc_cxx_helpers.hpp>
 #include <list>
+#include <vector>
 
 namespace adaptive
 {
@@ -36,25 +37,35 @@ namespace adaptive
         class Downloader
         {
             public:
-                Downloader();
+                Downloader(unsigned = 1);
                 ~Downloader();
                 bool start();
                 void schedule(HTTPChunkBufferedSource *);
                 void cancel(HTTPChunkBufferedSource *);
 
             private:
+                class Worker
+                {
+                    public:
+                        Worker(Downloader *);
+                        Downloader *downloader;
+                        vlc_thread_t thread_handle;
+                        bool         thread_handle_valid;
+                        bool         cancel_current;
+                        HTTPChunkBufferedSource *current;
+                };
+
                 static void * downloaderThread(void *);
-                void Run();
+                void Run(Worker *);
                 void kill();
-                vlc_thread_t thread_handle;
+                bool isActive(const HTTPChunkBufferedSource *) const;
+                HTTPChunkBufferedSource * next() const;
                 vlc::threads::mutex lock;
                 vlc::threads::condition_variable wait_cond;
                 vlc::threads::condition_variable updated_cond;
-                bool         thread_handle_valid;
                 bool         killed;
-                bool         cancel_current;
                 std::list<HTTPChunkBufferedSource *> chunks;
-                HTTPChunkBufferedSource *current;
+                std::vector<Worker> workers;
         };
 
     }
@@ -90,14 +90,15 @@ class adaptive::http::LibVLCHTTPSource : public adaptive::AbstractSource
      public:
         LibVLCHTTPSource(vlc_object_t *p_object, struct vlc_http_cookie_jar_t *jar)
         {
-            http_mgr = vlc_http_mgr_create(p_object, jar);
+            this->p_object = p_object;
+            this->jar = jar;
             http_res = nullptr;
             totalRead = 0;
+            createManager();
         }
         virtual ~LibVLCHTTPSource()
         {
-            if(http_mgr)
-                vlc_http_mgr_destroy(http_mgr);
+            reset();
         }
         block_t *readNextBlock() override
         {
@@ -185,11 +186,30 @@ class adaptive::http::LibVLCHTTPSource : public adaptive::AbstractSource
 
         static const struct vlc_http_resource_cbs callbacks;
         size_t totalRead;
-        struct vlc_http_mgr *http_mgr;
+        vlc_object_t *p_object;
+        struct vlc_http_cookie_jar_t *jar;
+        std::shared_ptr<struct vlc_http_mgr> http_mgr;
         BytesRange range;
 
     public:
         struct vlc_http_resource *http_res;
+
+        /* Only to be changed between requests, as the resource refers to it */
+        void createManager()
+        {
+            struct vlc_http_mgr *mgr = vlc_http_mgr_create(p_object, jar);
+            if(mgr)
+                http_mgr.reset(mgr, vlc_http_mgr_destroy);
+            else
+                http_mgr.reset();
+        }
+
+        void useManager(const std::shared_ptr<struct vlc_http_mgr> &mgr)
+        {
+            assert(http_res == nullptr);
+            http_mgr = mgr;
+        }
+
         int create(const char *uri,const std::string &ua,
                    const std::string &ref, const BytesRange &range)
         {
@@ -200,7 +220,7 @@ class adaptive::http::LibVLCHTTPSource : public adaptive::AbstractSource
 
             tpl->source = this;
             this->range = range;
-            if (vlc_http_res_init(&tpl->resource, &this->callbacks, http_mgr, uri,
+            if (vlc_http_res_init(&tpl->resource, &this->callbacks, http_mgr.get(), uri,
                                   ua.empty() ? nullptr : ua.c_str(),
                                   ref.empty() ? nullptr : ref.c_str()))
             {
@@ -239,9 +259,42 @@ const struct vlc_http_resource_cbs LibVLCHTTPSource::callbacks =
     LibVLCHTTPSource::validateresponse_handler,
 };
 
-LibVLCHTTPConnection::LibVLCHTTPConnection(vlc_object_t *p_object_, AuthStorage *auth)
+std::string LibVLCHTTPSharedManagers::origin(const ConnectionParams &params)
+{
+    return params.getScheme() + "://" + params.getHostname() + ":" +
+           std::to_string(params.getPort());
+}
+
+std::shared_ptr<struct vlc_http_mgr>
+LibVLCHTTPSharedManagers::get(const ConnectionParams &params)
+{
+    vlc::threads::mutex_locker locker(lock);
+    auto it = managers.find(origin(params));
+    if(it == managers.end())
+        return nullptr;
+    /* Lost its connection, or the server moved back to HTTP/1 */
+    if(!vlc_http_mgr_is_multiplexed(it->second.get()))
+    {
+        managers.erase(it);
+        return nullptr;
+    }
+    return it->second;
+}
+
+void LibVLCHTTPSharedManagers::offer(const ConnectionParams &params,
+                                     const std::shared_ptr<struct vlc_http_mgr> &mgr)
+{
+    if(!vlc_http_mgr_is_multiplexed(mgr.get()))
+        return;
+    vlc::threads::mutex_locker locker(lock);
+    managers.emplace(origin(params), mgr);
+}
+
+LibVLCHTTPConnection::LibVLCHTTPConnection(vlc_object_t *p_object_, AuthStorage *auth,
+                                           LibVLCHTTPSharedManagers *shared)
     : AbstractConnection( p_object_ )
 {
+    sharedManagers = shared;
     source = new adaptive::http::LibVLCHTTPSource(p_object_, auth->getJar());
     sourceStream = new ChunksSourceStream(p_object, source);
     stream = nullptr;
@@ -293,11 +346,22 @@ bool LibVLCHTTPConnection::canReuse(const ConnectionParams &params_) const
 RequestStatus LibVLCHTTPConnection::request(const std::string &path,
                                             const BytesRange &range)
 {
+    reset();
+
+    /* Run as another stream of the origin's HTTP/2 connection if there is
+     * one, rather than waiting for, or opening, a connection of our own */
+    if(sharedManagers)
+    {
+        std::shared_ptr<struct vlc_http_mgr> shared = sharedManagers->get(params);
+        if(shared)
+            source->useManager(shared);
+        else if(source->http_mgr.use_count() > 1)
+            source->createManager();
+    }
+
     if(source->http_mgr == nullptr)
         return RequestStatus::GenericError;
 
-    reset();
-
     /* Set new path for this query */
     params.setPath(path);
 
@@ -392,6 +456,9 @@ RequestStatus LibVLCHTTPConnection::request(const std::string &path,
         return RequestStatus::Redirection;
     }
 
+    if(sharedManagers)
+        sharedManagers->offer(params, source->http_mgr);
+
     sourceStream->Reset();
     stream = sourceStream->makeStream();
     if(stream == nullptr)
@@ -558,7 +625,7 @@ AbstractConnection * LibVLCHTTPConnectionFactory::createConnection(vlc_object_t
     if((params.getScheme() != "http" && params.getScheme() != "https") ||
        params.getHostname().empty())
         return nullptr;
-    return new LibVLCHTTPConnection(p_object, authStorage);
+    return new LibVLCHTTPConnection(p_object, authStorage, &sharedManagers);
 }
 
 StreamUrlConnectionFactory::StreamUrlConnectionFactory()
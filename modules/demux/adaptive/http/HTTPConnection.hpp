@@ -28,8 +28,14 @@
 #include "ConnectionParams.hpp"
 #include "BytesRange.hpp"
 #include <vlc_common.h>
+#include <vlc_threads.h>
+#include <vlc_cxx_helpers.hpp>
+#include <map>
+#include <memory>
 #include <string>
 
+struct vlc_http_mgr;
+
 namespace adaptive
 {
     class ChunksSourceStream;
@@ -72,10 +78,27 @@ namespace adaptive
 
        class LibVLCHTTPSource;
 
+       /* HTTP/2 connection managers shared by all the connections to the
+        * same origin, so that concurrent requests become streams of a single
+        * multiplexed connection instead of separate connections. */
+       class LibVLCHTTPSharedManagers
+       {
+            public:
+               std::shared_ptr<struct vlc_http_mgr> get(const ConnectionParams &);
+               void offer(const ConnectionParams &,
+                          const std::shared_ptr<struct vlc_http_mgr> &);
+
+            private:
+               static std::string origin(const ConnectionParams &);
+               vlc::threads::mutex lock;
+               std::map<std::string, std::shared_ptr<struct vlc_http_mgr>> managers;
+       };
+
        class LibVLCHTTPConnection : public AbstractConnection
        {
             public:
-               LibVLCHTTPConnection(vlc_object_t *, AuthStorage *);
+               LibVLCHTTPConnection(vlc_object_t *, AuthStorage *,
+                                    LibVLCHTTPSharedManagers * = nullptr);
                virtual ~LibVLCHTTPConnection();
                bool    canReuse     (const ConnectionParams &) const override;
                RequestStatus request(const std::string& path,
@@ -88,6 +111,7 @@ namespace adaptive
                std::string useragent;
                std::string referer;
                LibVLCHTTPSource *source;
+               LibVLCHTTPSharedManagers *sharedManagers;
                ChunksSourceStream *sourceStream;
                stream_t *stream;
        };
@@ -127,6 +151,7 @@ namespace adaptive
                AbstractConnection * createConnection(vlc_object_t *, const ConnectionParams &) override;
            private:
                AuthStorage *authStorage;
+               LibVLCHTTPSharedManagers sharedManagers;
        };
 
        class StreamUrlConnectionFactory : public AbstractConnectionFactory
@@ -33,15 +33,22 @@
 #include <vlc_url.h>
 #include <vlc_http.h>
 
+#include <algorithm>
 #include <cassert>
 
 using namespace adaptive::http;
 
+const vlc_tick_t AbstractConnectionManager::MIN_RATE_SAMPLE_TIME = VLC_TICK_FROM_MS(50);
+
 AbstractConnectionManager::AbstractConnectionManager(vlc_object_t *p_object_)
     : IDownloadRateObserver()
 {
     p_object = p_object_;
     rateObserver = nullptr;
+    vlc_mutex_init(&rate_lock);
+    rate_covered_until = VLC_TICK_INVALID;
+    rate_pending_size = 0;
+    rate_pending_time = 0;
 }
 
 AbstractConnectionManager::~AbstractConnectionManager()
@@ -52,14 +59,35 @@ AbstractConnectionManager::~AbstractConnectionManager()
 void AbstractConnectionManager::updateDownloadRate(const adaptive::ID &sourceid, size_t size,
                                                    vlc_tick_t time, vlc_tick_t latency)
 {
-    if(rateObserver)
-    {
-        BwDebug(msg_Dbg(p_object,
-                "%" PRId64 "Kbps downloaded %zuKBytes in %" PRId64 "ms latency %" PRId64 "ms [%s]",
-                INT64_C(1000) * size * 8 / (time ? time : 1), size / 1024, MS_FROM_VLC_TICK(time),
-                latency / 1000, sourceid.str().c_str()));
-        rateObserver->updateDownloadRate(sourceid, size, time, latency);
-    }
+    if(!rateObserver)
+        return;
+
+    /* The segments are downloaded by several workers at once, each one
+     * getting its share of the link only: only count the time no other
+     * reported transfer already covered, so that the rate is the one of
+     * the link and not of a single transfer */
+    const vlc_tick_t end = vlc_tick_now();
+    vlc_mutex_locker locker(&rate_lock);
+    vlc_tick_t start = end - time;
+    if(rate_covered_until != VLC_TICK_INVALID && start < rate_covered_until)
+        start = std::min(rate_covered_until, end);
+    rate_covered_until = std::max(rate_covered_until, end);
+
+    rate_pending_size += size;
+    rate_pending_time += end - start;
+    /* Transfers ending together: wait for a meaningful duration */
+    if(rate_pending_time < std::min(time, MIN_RATE_SAMPLE_TIME))
+        return;
+
+    BwDebug(msg_Dbg(p_object,
+            "%" PRId64 "Kbps downloaded %zuKBytes in %" PRId64 "ms latency %" PRId64 "ms [%s]",
+            INT64_C(1000) * rate_pending_size * 8 / rate_pending_time,
+            rate_pending_size / 1024, MS_FROM_VLC_TICK(rate_pending_time),
+            latency / 1000, sourceid.str().c_str()));
+    rateObserver->updateDownloadRate(sourceid, rate_pending_size,
+                                     rate_pending_time, latency);
+    rate_pending_size = 0;
+    rate_pending_time = 0;
 }
 
 void AbstractConnectionManager::setDownloadRateObserver(IDownloadRateObserver *obs)
@@ -77,7 +105,7 @@ HTTPConnectionManager::HTTPConnectionManager    (vlc_object_t *p_object_)
       localAllowed(false)
 {
     vlc_mutex_init(&lock);
-    downloader = new Downloader();
+    downloader = new Downloader(var_InheritInteger(p_object_, "adaptive-downloads"));
     downloaderhp = new Downloader();
     downloader->start();
     downloaderhp->start();
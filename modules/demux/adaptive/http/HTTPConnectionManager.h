@@ -71,7 +71,14 @@ namespace adaptive
                 vlc_object_t                                       *p_object;
 
             private:
+                static const vlc_tick_t MIN_RATE_SAMPLE_TIME;
                 IDownloadRateObserver                              *rateObserver;
+                /* Transfers overlapping in time share the link: the rate
+                 * is measured on the time they were not overlapping */
+                vlc_mutex_t                                         rate_lock;
+                vlc_tick_t                                          rate_covered_until;
+                size_t                                              rate_pending_size;
+                vlc_tick_t                                          rate_pending_time;
         };
 
         class HTTPConnectionManager : public AbstractConnectionManager
@@ -80,6 +80,8 @@ void RateBasedAdaptationLogic::updateDownloadRate(const ID &, size_t size,
 {
     if(unlikely(time == 0))
         return;
+
+    vlc_mutex_locker locker(&lock);
     /* Accumulate up to observation window */
     dllength += time;
     dlsize += size;
@@ -89,7 +91,6 @@ void RateBasedAdaptationLogic::updateDownloadRate(const ID &, size_t size,
 
     const size_t bps = CLOCK_FREQ * dlsize * 8 / dllength;
 
-    vlc_mutex_locker locker(&lock);
     bpsAvg = average.push(bps);
 
 //    BwDebug(msg_Dbg(p_obj, "alpha1 %lf alpha0 %lf dmax %ld ds %ld", alpha,
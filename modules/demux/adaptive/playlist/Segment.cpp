@@ -108,6 +108,10 @@ SegmentChunk* ISegment::toChunk(SharedResources *res, size_t index, BaseRepresen
                 delete chunk;
                 return nullptr;
             }
+            /* Downloads of the data needed first are served first */
+            vlc_tick_t startTime, duration;
+            if(rep->getPlaybackTimeDurationBySegmentNumber(index, &startTime, &duration))
+                source->setDeadline(startTime + VLC_TICK_0);
             res->getConnManager()->start(source);
             return chunk;
         }
@@ -43,99 +43,80 @@ SegmentTimeline::SegmentTimeline(AbstractMultipleSegmentBaseType *parent_)
 
 SegmentTimeline::~SegmentTimeline()
 {
-    std::list<Element *>::iterator it;
-    for(it = elements.begin(); it != elements.end(); ++it)
-        delete *it;
 }
 
 void SegmentTimeline::addElement(uint64_t number, stime_t d, uint64_t r, stime_t t)
 {
-    Element *element = new (std::nothrow) Element(number, d, r, t);
-    if(element)
+    Element element(number, d, r, t);
+    if(!elements.empty())
     {
-        if(!elements.empty() && !t)
-        {
-            const Element *el = elements.back();
-            element->t = el->t + (el->d * (el->r + 1));
-        }
-        elements.push_back(element);
-        totalLength += (d * (r + 1));
+        const Element &el = elements.back();
+        if(!t)
+            element.t = el.t + el.length();
+        element.elapsed = el.elapsed + el.length();
     }
+    elements.push_back(element);
+    totalLength += element.length();
 }
 
-stime_t SegmentTimeline::getMinAheadScaledTime(uint64_t number) const
+SegmentTimeline::Elements::const_iterator SegmentTimeline::findByNumber(uint64_t number) const
 {
-    stime_t totalscaledtime = 0;
+    /* first run not ending before number */
+    return std::lower_bound(elements.cbegin(), elements.cend(), number,
+                            [](const Element &el, uint64_t n)
+                                { return el.lastNumber() < n; });
+}
 
+stime_t SegmentTimeline::endElapsed() const
+{
+    const Element &el = elements.back();
+    return el.elapsed + el.length();
+}
+
+stime_t SegmentTimeline::getMinAheadScaledTime(uint64_t number) const
+{
     if(!elements.size() ||
        minElementNumber() > number ||
        maxElementNumber() < number)
         return 0;
 
-    std::list<Element *>::const_reverse_iterator it;
-    for(it = elements.rbegin(); it != elements.rend(); ++it)
-    {
-        const Element *el = *it;
-        if(number > el->number + el->r)
-            break;
-        else if(number < el->number)
-            totalscaledtime += (el->d * (el->r + 1));
-        else /* within repeat range */
-            totalscaledtime += el->d * (el->number + el->r - number);
-    }
-
-    return totalscaledtime;
+    auto it = findByNumber(number);
+    if(number < it->number) /* in a numbering gap */
+        return endElapsed() - it->elapsed;
+    /* within repeat range */
+    return endElapsed() - it->elapsed - it->d * (number - it->number + 1);
 }
 
 uint64_t SegmentTimeline::getElementNumberByScaledPlaybackTime(stime_t scaled) const
 {
-    const Element *prevel = nullptr;
-    std::list<Element *>::const_iterator it;
-
     if(!elements.size())
         return 0;
 
-    for(it = elements.begin(); it != elements.end(); ++it)
-    {
-        const Element *el = *it;
-        if(scaled >= el->t)
-        {
-            if((uint64_t)scaled < el->t + (el->d * (el->r + 1)))
-                return el->number + (scaled - el->t) / el->d;
-        }
-        /* might have been discontinuity */
-        else
-        {
-            if(prevel) /* > prev but < current */
-                return prevel->number + prevel->r;
-            else /* << first of the list */
-                return el->number;
-        }
-        prevel = el;
-    }
+    /* last run starting at or before that time */
+    auto it = std::upper_bound(elements.cbegin(), elements.cend(), scaled,
+                               [](stime_t time, const Element &el)
+                                   { return time < el.t; });
+    if(it == elements.cbegin()) /* << first of the list */
+        return it->number;
+
+    const Element &el = *(--it);
+    if(scaled < el.t + el.length())
+        return el.number + (scaled - el.t) / el.d;
 
-    /* time is >> any of the list */
-    return prevel->number + prevel->r;
+    /* might have been discontinuity, or time is >> any of the list */
+    return el.lastNumber();
 }
 
 bool SegmentTimeline::getScaledPlaybackTimeDurationBySegmentNumber(uint64_t number,
                                                                    stime_t *time, stime_t *duration) const
 {
-    std::list<Element *>::const_iterator it;
-    for(it = elements.begin(); it != elements.end(); ++it)
-    {
-        const Element *el = *it;
-        if(number >= el->number)
-        {
-            if(number <= el->number + el->r)
-            {
-                *time = el->t + el->d * (number - el->number);
-                *duration = el->d;
-                return true;
-            }
-        }
-    }
-    return false;
+    auto it = findByNumber(number);
+    if(it == elements.cend() || number < it->number)
+        return false;
+
+    *time = it->t + it->d * (number - it->number);
+    *duration = it->d;
+    return true;
 }
 
 stime_t SegmentTimeline::getScaledPlaybackTimeByElementNumber(uint64_t number) const
@@ -155,30 +136,22 @@ uint64_t SegmentTimeline::maxElementNumber() const
     if(elements.empty())
         return 0;
 
-    const Element *e = elements.back();
-    return e->number + e->r;
+    return elements.back().lastNumber();
 }
 
 uint64_t SegmentTimeline::minElementNumber() const
 {
     if(elements.empty())
         return 0;
-    return elements.front()->number;
+    return elements.front().number;
 }
 
 uint64_t SegmentTimeline::getElementIndexBySequence(uint64_t number) const
 {
-    std::list<Element *>::const_iterator it;
-    for(it = elements.begin(); it != elements.end(); ++it)
-    {
-        const Element *el = *it;
-        if(number >= el->number)
-        {
-            if(number <= el->number + el->r)
-                return std::distance(elements.begin(), it);
-        }
-    }
-    return std::numeric_limits<uint64_t>::max();
+    auto it = findByNumber(number);
+    if(it == elements.cend() || number < it->number)
+        return std::numeric_limits<uint64_t>::max();
+    return std::distance(elements.cbegin(), it);
 }
 
 void SegmentTimeline::pruneByPlaybackTime(vlc_tick_t time)
@@ -191,32 +164,26 @@ void SegmentTimeline::pruneByPlaybackTime(vlc_tick_t time)
 size_t SegmentTimeline::pruneBySequenceNumber(uint64_t number)
 {
     size_t prunednow = 0;
-    while(elements.size())
+    auto last = elements.begin() + std::distance(elements.cbegin(), findByNumber(number));
+
+    for(auto it = elements.begin(); it != last; ++it)
     {
-        Element *el = elements.front();
-        if(el->number >= number)
-        {
-            break;
-        }
-        else if(el->number + el->r >= number)
-        {
-            uint64_t count = number - el->number;
-            el->number += count;
-            el->t += count * el->d;
-            el->r -= count;
-            prunednow += count;
-            totalLength -= count * el->d;
-            break;
-        }
-        else
-        {
-            prunednow += el->r + 1;
-            elements.pop_front();
-            totalLength -= (el->d * (el->r + 1));
-            delete el;
-        }
+        prunednow += it->r + 1;
+        totalLength -= it->length();
+    }
+
+    if(last != elements.end() && last->number < number)
+    {
+        uint64_t count = number - last->number;
+        last->number += count;
+        last->t += count * last->d;
+        last->elapsed += count * last->d;
+        last->r -= count;
+        prunednow += count;
+        totalLength -= count * last->d;
     }
 
+    elements.erase(elements.begin(), last);
     return prunednow;
 }
 
@@ -224,38 +191,39 @@ void SegmentTimeline::updateWith(SegmentTimeline &other)
 {
     if(elements.empty())
     {
-        while(other.elements.size())
-        {
-            elements.push_back(other.elements.front());
-            other.elements.pop_front();
-        }
+        elements = std::move(other.elements);
+        totalLength += other.totalLength;
+        other.elements.clear();
+        other.totalLength = 0;
         return;
     }
 
-    Element *last = elements.back();
-    while(other.elements.size())
+    /* Runs starting before our last one are already known */
+    auto it = std::lower_bound(other.elements.cbegin(), other.elements.cend(),
+                               elements.back().t,
+                               [](const Element &el, stime_t time)
+                                   { return el.t < time; });
+    for(; it != other.elements.cend(); ++it)
     {
-        Element *el = other.elements.front();
-        other.elements.pop_front();
-
-        if(last->contains(el->t)) /* Same element, but prev could have been middle of repeat */
+        Element &last = elements.back();
+        if(last.contains(it->t)) /* Same element, but prev could have been middle of repeat */
         {
-            const uint64_t count = (el->t - last->t) / last->d;
-            totalLength -= (last->d * (last->r + 1));
-            last->r = std::max(last->r, el->r + count);
-            totalLength += (last->d * (last->r + 1));
-            delete el;
+            const uint64_t count = (it->t - last.t) / last.d;
+            totalLength -= last.length();
+            last.r = std::max(last.r, it->r + count);
+            totalLength += last.length();
         }
-        else if(el->t < last->t)
+        else if(it->t < last.t)
         {
-            delete el;
+            continue;
         }
         else /* Did not exist in previous list */
         {
-            totalLength += (el->d * (el->r + 1));
+            Element el = *it;
+            el.number = last.lastNumber() + 1;
+            el.elapsed = last.elapsed + last.length();
+            totalLength += el.length();
             elements.push_back(el);
-            el->number = last->number + last->r + 1;
-            last = el;
         }
     }
 }
@@ -266,9 +234,8 @@ void SegmentTimeline::debug(vlc_object_t *obj, int indent) const
     ss << std::string(indent, ' ') << "Timeline";
     msg_Dbg(obj, "%s", ss.str().c_str());
 
-    std::list<Element *>::const_iterator it;
-    for(it = elements.begin(); it != elements.end(); ++it)
-        (*it)->debug(obj, indent + 1);
+    for(const Element &el : elements)
+        el.debug(obj, indent + 1);
 }
 
 SegmentTimeline::Element::Element(uint64_t number_, stime_t d_, uint64_t r_, stime_t t_)
@@ -277,6 +244,7 @@ SegmentTimeline::Element::Element(uint64_t number_, stime_t d_, uint64_t r_, sti
     d = d_;
     t = t_;
     r = r_;
+    elapsed = 0;
 }
 
 bool SegmentTimeline::Element::contains(stime_t time) const
@@ -26,7 +26,7 @@
 #include "Inheritables.hpp"
 
 #include <vlc_common.h>
-#include <list>
+#include <vector>
 
 namespace adaptive
 {
@@ -36,8 +36,6 @@ namespace adaptive
 
         class SegmentTimeline : public AttrsNode
         {
-            class Element;
-
             public:
                 SegmentTimeline(AbstractMultipleSegmentBaseType *);
                 virtual ~SegmentTimeline();
@@ -56,21 +54,30 @@ namespace adaptive
                 void debug(vlc_object_t *, int = 0) const;
 
             private:
-                std::list<Element *> elements;
-                stime_t totalLength;
-                AbstractMultipleSegmentBaseType *parent;
-
+                /* Run of r + 1 segments of duration d, starting at time t */
                 class Element
                 {
                     public:
                         Element(uint64_t, stime_t, uint64_t, stime_t);
                         void debug(vlc_object_t *, int = 0) const;
                         bool contains(stime_t) const;
+                        uint64_t lastNumber() const { return number + r; }
+                        stime_t  length() const { return d * (stime_t)(r + 1); }
                         stime_t  t;
                         stime_t  d;
                         uint64_t r;
                         uint64_t number;
+                        stime_t  elapsed; /* sum of the lengths of all the previous runs */
                 };
+
+                /* Runs sorted by number and time, so that lookups are binary
+                 * searches and pruning drops a contiguous head */
+                using Elements = std::vector<Element>;
+                Elements::const_iterator findByNumber(uint64_t) const;
+                stime_t endElapsed() const;
+                Elements elements;
+                stime_t totalLength;
+                AbstractMultipleSegmentBaseType *parent;
         };
     }
 }
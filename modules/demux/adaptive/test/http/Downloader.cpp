@@ -0,0 +1,337 @@
+/*****************************************************************************
+ *
+ *****************************************************************************
+ * Copyright (C) 2026 VideoLabs, VideoLAN and VLC Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "../../http/Downloader.hpp"
+#include "../../http/Chunk.h"
+#include "../../http/HTTPConnection.hpp"
+#include "../../http/HTTPConnectionManager.h"
+#include "../../http/ConnectionParams.hpp"
+
+#include "../test.hpp"
+
+#include <vlc_block.h>
+#include <vlc_threads.h>
+#include <vlc_cxx_helpers.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace adaptive;
+using namespace adaptive::http;
+
+/* Records the chunks in the order the workers read them, and holds the
+ * reads of a chunk until enough reads were made */
+class ReadRecorder
+{
+    public:
+        void read(const std::string &name)
+        {
+            vlc::threads::mutex_locker locker {lock};
+            reads.push_back(name);
+            cond.broadcast();
+            for(auto it = gates.find(name);
+                it != gates.end() && reads.size() < it->second;
+                it = gates.find(name))
+                cond.wait(lock);
+        }
+
+        void gate(const std::string &name, size_t until)
+        {
+            vlc::threads::mutex_locker locker {lock};
+            gates[name] = until;
+        }
+
+        void open(const std::string &name)
+        {
+            vlc::threads::mutex_locker locker {lock};
+            gates.erase(name);
+            cond.broadcast();
+        }
+
+        void openAll()
+        {
+            vlc::threads::mutex_locker locker {lock};
+            gates.clear();
+            cond.broadcast();
+        }
+
+        void waitReads(size_t count)
+        {
+            vlc::threads::mutex_locker locker {lock};
+            while(reads.size() < count)
+                cond.wait(lock);
+        }
+
+        std::vector<std::string> get()
+        {
+            vlc::threads::mutex_locker locker {lock};
+            return reads;
+        }
+
+        size_t count(const std::string &name)
+        {
+            vlc::threads::mutex_locker locker {lock};
+            return std::count(reads.begin(), reads.end(), name);
+        }
+
+    private:
+        vlc::threads::mutex lock;
+        vlc::threads::condition_variable cond;
+        std::vector<std::string> reads;
+        std::map<std::string, size_t> gates;
+};
+
+class TestConnection : public AbstractConnection
+{
+    public:
+        TestConnection(ReadRecorder *recorder_, const std::string &name_)
+            : AbstractConnection(nullptr), recorder(recorder_), name(name_)
+        {
+            remaining = 0;
+        }
+        virtual ~TestConnection() = default;
+
+        bool canReuse(const ConnectionParams &) const override { return false; }
+
+        RequestStatus request(const std::string &, const BytesRange &) override
+        {
+            contentLength = remaining = 2 * HTTPChunkSource::CHUNK_SIZE;
+            return RequestStatus::Success;
+        }
+
+        ssize_t read(void *p_buffer, size_t len) override
+        {
+            len = std::min(len, remaining);
+            if(len == 0)
+                return 0;
+            recorder->read(name);
+            memset(p_buffer, 0, len);
+            remaining -= len;
+            return len;
+        }
+
+        void setUsed(bool) override {}
+
+    private:
+        ReadRecorder *recorder;
+        std::string name;
+        size_t remaining;
+};
+
+class TestConnectionManager : public AbstractConnectionManager
+{
+    public:
+        TestConnectionManager(ReadRecorder *recorder_)
+            : AbstractConnectionManager(nullptr), recorder(recorder_)
+        {
+            downloader = nullptr;
+        }
+        virtual ~TestConnectionManager() = default;
+        void closeAllConnections () override {}
+        AbstractConnection * getConnection(ConnectionParams &params) override
+        {
+            /* the chunk is named after its path */
+            connections.emplace_back(
+                    std::make_unique<TestConnection>(recorder,
+                                                     params.getPath().substr(1)));
+            return connections.back().get();
+        }
+        AbstractChunkSource *makeSource(const std::string &, const ID &,
+                                        ChunkType, const BytesRange &) override
+        {
+            return nullptr;
+        }
+        void recycleSource(AbstractChunkSource *) override {}
+        void start(AbstractChunkSource *) override {}
+        void cancel(AbstractChunkSource *source) override
+        {
+            downloader->cancel(static_cast<HTTPChunkBufferedSource *>(source));
+        }
+
+        Downloader *downloader;
+
+    private:
+        ReadRecorder *recorder;
+        std::vector<std::unique_ptr<TestConnection>> connections;
+};
+
+class TestChunkSource : public HTTPChunkBufferedSource
+{
+    public:
+        TestChunkSource(AbstractConnectionManager *manager, const std::string &name,
+                        const std::string &stream, vlc_tick_t deadline)
+            : HTTPChunkBufferedSource("http://test/" + name, manager, ID(stream),
+                                      ChunkType::Segment, BytesRange())
+        {
+            setDeadline(deadline);
+        }
+        virtual ~TestChunkSource() = default;
+
+        /* waits for the whole chunk to be downloaded */
+        void drain()
+        {
+            while(block_t *p_block = readBlock())
+            {
+                const bool end = p_block->i_buffer == 0;
+                block_Release(p_block);
+                if(end)
+                    break;
+            }
+        }
+};
+
+class DownloaderFixture
+{
+    public:
+        DownloaderFixture(unsigned workers)
+            : manager(&recorder), downloader(workers)
+        {
+            manager.downloader = &downloader;
+        }
+
+        ~DownloaderFixture()
+        {
+            recorder.openAll();
+            for(TestChunkSource *source : sources)
+                delete source;
+        }
+
+        TestChunkSource * add(const std::string &name, const std::string &stream,
+                              vlc_tick_t deadline)
+        {
+            sources.push_back(new TestChunkSource(&manager, name, stream, deadline));
+            downloader.schedule(sources.back());
+            return sources.back();
+        }
+
+        ReadRecorder recorder;
+        TestConnectionManager manager;
+        Downloader downloader;
+
+    private:
+        std::vector<TestChunkSource *> sources;
+};
+
+static void *CancelThread(void *opaque)
+{
+    auto args = static_cast<std::pair<Downloader *, TestChunkSource *> *>(opaque);
+    args->first->cancel(args->second);
+    return nullptr;
+}
+
+static int Deadline_test()
+{
+    try
+    {
+        /* a single worker downloads the chunk needed first, whatever its
+         * stream or its scheduling order */
+        DownloaderFixture f(1);
+        TestChunkSource *a = f.add("A", "1", VLC_TICK_0 + 3);
+        TestChunkSource *b = f.add("B", "1", VLC_TICK_0 + 1);
+        TestChunkSource *c = f.add("C", "2", VLC_TICK_0 + 2);
+        Expect(f.downloader.start());
+        a->drain();
+        b->drain();
+        c->drain();
+
+        const std::vector<std::string> expected {"B", "B", "C", "C", "A", "A"};
+        Expect(f.recorder.get() == expected);
+    } catch(...) {
+        return 1;
+    }
+    return 0;
+}
+
+static int Fairness_test()
+{
+    try
+    {
+        /* while a worker serves a stream, the other one serves another
+         * stream, even if its chunks are needed later */
+        DownloaderFixture f(2);
+        f.recorder.gate("A1", 2);
+        TestChunkSource *a1 = f.add("A1", "1", VLC_TICK_0 + 1);
+        TestChunkSource *a2 = f.add("A2", "1", VLC_TICK_0 + 2);
+        TestChunkSource *b1 = f.add("B1", "2", VLC_TICK_0 + 3);
+        Expect(f.downloader.start());
+        a1->drain();
+        a2->drain();
+        b1->drain();
+
+        const std::vector<std::string> reads = f.recorder.get();
+        Expect(reads.size() == 6);
+        Expect(reads[0] == "A1");
+        Expect(reads[1] == "B1");
+        /* the stream is served in deadline order */
+        Expect(std::find(reads.begin(), reads.end(), "A2") >
+               std::find(reads.begin(), reads.end(), "A1") + 1);
+    } catch(...) {
+        return 1;
+    }
+    return 0;
+}
+
+static int Cancel_test()
+{
+    try
+    {
+        /* a chunk canceled while a worker reads it is not downloaded
+         * any further, and does not stall the other worker */
+        DownloaderFixture f(2);
+        f.recorder.gate("A", std::numeric_limits<size_t>::max());
+        TestChunkSource *a = f.add("A", "1", VLC_TICK_0 + 1);
+        TestChunkSource *b = f.add("B", "2", VLC_TICK_0 + 2);
+        Expect(f.downloader.start());
+        b->drain();
+        f.recorder.waitReads(3);
+        Expect(f.recorder.count("A") == 1);
+
+        vlc_thread_t th;
+        auto args = std::make_pair(&f.downloader, a);
+        Expect(vlc_clone(&th, CancelThread, &args) == 0);
+        /* let the cancellation wait for the worker holding the chunk */
+        vlc_tick_wait(vlc_tick_now() + VLC_TICK_FROM_MS(200));
+        f.recorder.open("A");
+        vlc_join(th, nullptr);
+
+        /* only the slice being read when canceled was downloaded */
+        Expect(f.recorder.count("A") == 1);
+        TestChunkSource *c = f.add("C", "1", VLC_TICK_0 + 3);
+        c->drain();
+        Expect(f.recorder.count("A") == 1);
+        Expect(f.recorder.count("C") == 2);
+    } catch(...) {
+        return 1;
+    }
+    return 0;
+}
+
+int Downloader_test()
+{
+    return Deadline_test() || Fairness_test() || Cancel_test();
+}
@@ -0,0 +1,287 @@
+/*****************************************************************************
+ *
+ *****************************************************************************
+ * Copyright (C) 2026 VideoLabs, VideoLAN and VLC Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "../../playlist/SegmentTemplate.h"
+#include "../../playlist/SegmentTimeline.h"
+#include "../../playlist/BasePeriod.h"
+#include "../../playlist/BaseAdaptationSet.h"
+#include "../../playlist/BaseRepresentation.h"
+#include "../../xml/DOMParser.h"
+#include "../../xml/DOMHelper.h"
+#include "../../../dash/mpd/IsoffMainParser.h"
+#include "../../../dash/mpd/MPD.h"
+
+#include "../test.hpp"
+
+#include <vlc_xml.h>
+
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace adaptive;
+using namespace adaptive::playlist;
+using namespace adaptive::xml;
+using namespace dash::mpd;
+
+/* Emits the reader events of a document in the DASH namespace. Only
+ * elements, double quoted attributes and text are supported. */
+class FakeXmlReader
+{
+    public:
+        FakeXmlReader(const char *doc) : p(doc)
+        {
+            std::memset(&reader, 0, sizeof(reader));
+            reader.p_sys = this;
+            reader.pf_next_node = NextNode;
+            reader.pf_next_attr = NextAttr;
+            reader.pf_is_empty = IsEmpty;
+        }
+
+        xml_reader_t reader;
+
+    private:
+        static FakeXmlReader * get(xml_reader_t *r)
+        {
+            return static_cast<FakeXmlReader *>(r->p_sys);
+        }
+
+        std::string token(const char *end)
+        {
+            size_t len = std::strcspn(p, end);
+            std::string str(p, len);
+            p += len;
+            return str;
+        }
+
+        void skipSpaces()
+        {
+            p += std::strspn(p, " \n\t");
+        }
+
+        static int NextNode(xml_reader_t *r, const char **data, const char **ns)
+        {
+            FakeXmlReader *sys = get(r);
+            sys->skipSpaces();
+            if(*sys->p == '\0')
+                return XML_READER_NONE;
+
+            sys->attrs.clear();
+            sys->attr = 0;
+            sys->empty = false;
+            *ns = NS_DASH.c_str();
+
+            if(*sys->p != '<')
+            {
+                sys->name = sys->token("<");
+                *data = sys->name.c_str();
+                return XML_READER_TEXT;
+            }
+
+            if(sys->p[1] == '/')
+            {
+                sys->p += 2;
+                sys->name = sys->token(">");
+                sys->p++;
+                *data = sys->name.c_str();
+                return XML_READER_ENDELEM;
+            }
+
+            sys->p++;
+            sys->name = sys->token(" />");
+            for(;;)
+            {
+                sys->skipSpaces();
+                if(*sys->p == '/')
+                {
+                    sys->empty = true;
+                    sys->p++;
+                }
+                if(*sys->p == '>')
+                    break;
+                std::string key = sys->token("=");
+                sys->p += 2; /* =" */
+                std::string value = sys->token("\"");
+                sys->p++;
+                sys->attrs.emplace_back(key, value);
+            }
+            sys->p++;
+            *data = sys->name.c_str();
+            return XML_READER_STARTELEM;
+        }
+
+        static const char * NextAttr(xml_reader_t *r, const char **value,
+                                     const char **ns)
+        {
+            FakeXmlReader *sys = get(r);
+            if(sys->attr >= sys->attrs.size())
+                return nullptr;
+            const auto &attr = sys->attrs[sys->attr++];
+            *value = attr.second.c_str();
+            if(ns)
+                *ns = nullptr;
+            return attr.first.c_str();
+        }
+
+        static int IsEmpty(xml_reader_t *r)
+        {
+            return get(r)->empty;
+        }
+
+        const char *p;
+        std::string name;
+        std::vector<std::pair<std::string, std::string>> attrs;
+        size_t attr;
+        bool empty;
+};
+
+static const char mpd_doc[] =
+    "<MPD type=\"static\" profiles=\"urn:mpeg:dash:profile:isoff-live:2011\">"
+    " <Period>"
+    "  <AdaptationSet mimeType=\"video/mp4\">"
+    "   <Representation id=\"1\" bandwidth=\"1000\">"
+    "    <SegmentTemplate timescale=\"10\" startNumber=\"5\" media=\"$Number$\">"
+    "     <SegmentTimeline>"
+    "      <S t=\"100\" d=\"10\" r=\"2\"/>"
+    "      <S d=\"20\"/>"
+    /* d is mandatory, the entry is dropped */
+    "      <S t=\"200\" r=\"1\"/>"
+    "      <S d=\"5\" r=\"1\">text<Foo a=\"1\"><Bar/><Baz></Baz></Foo></S>"
+    "      <S t=\"300\" d=\"10\"></S>"
+    "     </SegmentTimeline>"
+    "    </SegmentTemplate>"
+    "   </Representation>"
+    "   <Representation id=\"2\" bandwidth=\"2000\">"
+    "    <SegmentTemplate timescale=\"10\" media=\"$Number$\">"
+    "     <SegmentTimeline>"
+    "      <S d=\"4\" r=\"1\"/>"
+    "      <S t=\"50\" d=\"6\"/>"
+    "     </SegmentTimeline>"
+    "    </SegmentTemplate>"
+    "   </Representation>"
+    "  </AdaptationSet>"
+    " </Period>"
+    "</MPD>";
+
+static MPD * ParseMPD(SegmentTimelineHandler *handler, size_t *entryNodes)
+{
+    FakeXmlReader fake(mpd_doc);
+    DOMParser parser;
+    parser.setElementHandler(handler);
+    if(!parser.parse(&fake.reader, true))
+        return nullptr;
+    *entryNodes = 0;
+    for(Node *node : DOMHelper::getElementByTagName(parser.getRootNode(),
+                                                    "SegmentTimeline", NS_DASH, false))
+        *entryNodes += node->getSubNodes().size();
+    IsoffMainParser mpdparser(parser.getRootNode(), nullptr, nullptr,
+                              std::string("http://example.com/"), handler);
+    return mpdparser.parse();
+}
+
+static SegmentTimeline * GetTimeline(MPD *mpd, size_t index)
+{
+    BasePeriod *period = mpd->getFirstPeriod();
+    Expect(period);
+    Expect(period->getAdaptationSets().size() == 1);
+    const auto &reps = period->getAdaptationSets().front()->getRepresentations();
+    Expect(reps.size() == 2);
+    SegmentTemplate *templ = reps.at(index)->inheritSegmentTemplate();
+    Expect(templ);
+    SegmentTimeline *timeline = templ->inheritSegmentTimeline();
+    Expect(timeline);
+    return timeline;
+}
+
+static void ExpectSegment(const SegmentTimeline *timeline, uint64_t number,
+                          stime_t time, stime_t duration)
+{
+    stime_t t, d;
+    Expect(timeline->getScaledPlaybackTimeDurationBySegmentNumber(number, &t, &d));
+    Expect(t == time);
+    Expect(d == duration);
+}
+
+static void ExpectSameTimeline(const SegmentTimeline *a, const SegmentTimeline *b)
+{
+    Expect(a->minElementNumber() == b->minElementNumber());
+    Expect(a->maxElementNumber() == b->maxElementNumber());
+    Expect(a->getTotalLength() == b->getTotalLength());
+    for(uint64_t n = a->minElementNumber(); n <= a->maxElementNumber(); n++)
+    {
+        stime_t ta, da, tb, db;
+        Expect(a->getScaledPlaybackTimeDurationBySegmentNumber(n, &ta, &da));
+        Expect(b->getScaledPlaybackTimeDurationBySegmentNumber(n, &tb, &db));
+        Expect(ta == tb);
+        Expect(da == db);
+    }
+}
+
+int MPDTimeline_test()
+{
+    MPD *dom = nullptr;
+    MPD *streamed = nullptr;
+    try
+    {
+        size_t entryNodes;
+        dom = ParseMPD(nullptr, &entryNodes);
+        Expect(dom);
+        Expect(entryNodes == 7);
+
+        SegmentTimelineHandler handler;
+        streamed = ParseMPD(&handler, &entryNodes);
+        Expect(streamed);
+        /* the S entries did not reach the tree */
+        Expect(entryNodes == 0);
+
+        SegmentTimeline *timeline = GetTimeline(streamed, 0);
+        Expect(timeline->minElementNumber() == 5);
+        Expect(timeline->maxElementNumber() == 11);
+        Expect(timeline->getTotalLength() == 70);
+        ExpectSegment(timeline, 5, 100, 10);
+        ExpectSegment(timeline, 7, 120, 10);
+        ExpectSegment(timeline, 8, 130, 20);
+        ExpectSegment(timeline, 9, 150, 5);
+        ExpectSegment(timeline, 10, 155, 5);
+        ExpectSegment(timeline, 11, 300, 10);
+        ExpectSameTimeline(timeline, GetTimeline(dom, 0));
+
+        /* the elements following a non-empty S are still parsed */
+        timeline = GetTimeline(streamed, 1);
+        Expect(timeline->minElementNumber() == 1);
+        Expect(timeline->maxElementNumber() == 3);
+        ExpectSegment(timeline, 2, 4, 4);
+        ExpectSegment(timeline, 3, 50, 6);
+        ExpectSameTimeline(timeline, GetTimeline(dom, 1));
+
+        delete dom;
+        delete streamed;
+    } catch (...) {
+        delete dom;
+        delete streamed;
+        return 1;
+    }
+
+    return 0;
+}
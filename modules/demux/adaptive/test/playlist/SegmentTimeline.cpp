@@ -170,6 +170,30 @@ int Timeline_test()
         timeline->updateWith(*timeline2);
         Expect(timeline->maxElementNumber() == 4+99+10);
 
+        /* Long timeline, alternating durations of 10 and 11 */
+        delete timeline;
+        timeline = new SegmentTimeline(nullptr);
+        for(uint64_t i = 0; i < 10000; i++)
+            timeline->addElement(1 + i * 3, 10 + i % 2, 2, i ? 0 : START);
+        Expect(timeline->maxElementNumber() == 30000);
+        Expect(timeline->getTotalLength() == 3 * (10 * 10000 + 5000));
+        for(uint64_t number = 1; number <= 30000; number += 7)
+        {
+            const uint64_t i = (number - 1) / 3;
+            const stime_t t = START + 3 * (10 * i + i / 2) + ((number - 1) % 3) * (10 + i % 2);
+            Expect(timeline->getScaledPlaybackTimeByElementNumber(number) == t);
+            Expect(timeline->getElementNumberByScaledPlaybackTime(t) == number);
+            Expect(timeline->getElementIndexBySequence(number) == i);
+            Expect(timeline->getMinAheadScaledTime(number) ==
+                   (START + timeline->getTotalLength()) - t - (10 + (stime_t)(i % 2)));
+        }
+        Expect(timeline->pruneBySequenceNumber(15001) == 15000);
+        Expect(timeline->minElementNumber() == 15001);
+        Expect(timeline->getElementIndexBySequence(15001) == 0);
+        Expect(timeline->getTotalLength() == 3 * (10 * 5000 + 2500));
+        Expect(timeline->getScaledPlaybackTimeByElementNumber(15001) ==
+               START + 3 * (10 * 5000 + 2500));
+
         delete timeline;
         delete timeline2;
 
@@ -49,6 +49,8 @@ int main()
     TEST(CommandsQueue) ||
     TEST(M3U8MasterPlaylist) ||
     TEST(M3U8Playlist) ||
-    TEST(SegmentTracker)
+    TEST(MPDTimeline) ||
+    TEST(SegmentTracker) ||
+    TEST(Downloader)
     ;
 }
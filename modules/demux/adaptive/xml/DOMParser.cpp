@@ -37,6 +37,7 @@ using namespace adaptive::xml;
 DOMParser::DOMParser() :
     root( nullptr ),
     stream( nullptr ),
+    handler( nullptr ),
     vlc_reader( nullptr )
 {
 }
@@ -44,6 +45,7 @@ DOMParser::DOMParser() :
 DOMParser::DOMParser    (stream_t *stream) :
     root( nullptr ),
     stream( stream ),
+    handler( nullptr ),
     vlc_reader( nullptr )
 {
 }
@@ -70,14 +72,25 @@ bool    DOMParser::parse                    (bool b)
     struct vlc_logger *const logger = vlc_reader->obj.logger;
     if(!b)
         vlc_reader->obj.logger = nullptr;
-    root = processNode(b);
+    bool ret = parse(vlc_reader, b);
     vlc_reader->obj.logger = logger;
+    return ret;
+}
+
+bool    DOMParser::parse                    (xml_reader_t *reader, bool b)
+{
+    root = processNode(reader, b);
     if ( root == nullptr )
         return false;
 
     return true;
 }
 
+void DOMParser::setElementHandler(ElementHandler *h)
+{
+    handler = h;
+}
+
 bool DOMParser::reset(stream_t *s)
 {
     stream = s;
@@ -91,22 +104,39 @@ bool DOMParser::reset(stream_t *s)
     return !!vlc_reader;
 }
 
-Node* DOMParser::processNode(bool b_strict)
+Node* DOMParser::processNode(xml_reader_t *reader, bool b_strict)
 {
     const char *data, *ns;
     int type;
     std::stack<Node *> lifo;
+    size_t skipped = 0; /* depth within an element consumed by the handler */
 
-    while( (type = xml_ReaderNextNodeNS(vlc_reader, &data, &ns)) > 0 )
+    while( (type = xml_ReaderNextNodeNS(reader, &data, &ns)) > 0 )
     {
+        if(skipped)
+        {
+            if(type == XML_READER_STARTELEM && !xml_ReaderIsEmptyElement(reader))
+                skipped++;
+            else if(type == XML_READER_ENDELEM)
+                skipped--;
+            continue;
+        }
+
         switch(type)
         {
             case XML_READER_STARTELEM:
             {
-                Namespaces::Ptr ptr = nss.registerNamespace(ns);
-                bool empty = xml_ReaderIsEmptyElement(vlc_reader);
+                bool empty = xml_ReaderIsEmptyElement(reader);
                 const char *unprefixed = std::strchr(data, ':');
                 data = unprefixed ? unprefixed + 1 : data;
+                if(handler && !lifo.empty() &&
+                   handler->handleElement(lifo.top(), data, ns ? ns : "", reader))
+                {
+                    if(!empty)
+                        skipped = 1;
+                    break;
+                }
+                Namespaces::Ptr ptr = nss.registerNamespace(ns);
                 auto name = std::make_unique<std::string>(data);
                 Node *node = new (std::nothrow) Node(std::move(name), ptr);
                 if(node)
@@ -115,7 +145,7 @@ Node* DOMParser::processNode(bool b_strict)
                         lifo.top()->addSubNode(node);
                     lifo.push(node);
 
-                    addAttributesToNode(node);
+                    addAttributesToNode(reader, node);
                 }
 
                 if(empty && lifo.size() > 1)
@@ -160,13 +190,13 @@ Node* DOMParser::processNode(bool b_strict)
     return node;
 }
 
-void    DOMParser::addAttributesToNode      (Node *node)
+void    DOMParser::addAttributesToNode      (xml_reader_t *reader, Node *node)
 {
     const char *attrValue;
     const char *attrName;
     const char *ns;
 
-    while((attrName = xml_ReaderNextAttrNS(this->vlc_reader, &attrValue, &ns)) != nullptr)
+    while((attrName = xml_ReaderNextAttrNS(reader, &attrValue, &ns)) != nullptr)
     {
         Namespaces::Ptr ptr = nss.registerNamespace(ns ? ns : "");
         std::string key     = attrName;
@@ -37,24 +37,43 @@ namespace adaptive
         class DOMParser
         {
             public:
+                /* Consumes elements as they are read, instead of having them
+                 * and their children built into the tree. Meant for large
+                 * and repetitive elements (e.g. SegmentTimeline entries). */
+                class ElementHandler
+                {
+                    public:
+                        virtual ~ElementHandler() = default;
+                        /* Returns whether the element is consumed. Its
+                         * attributes can be read from the reader. */
+                        virtual bool handleElement(const Node *parent,
+                                                   const char *name,
+                                                   const char *ns,
+                                                   xml_reader_t *) = 0;
+                };
+
                 DOMParser           ();
                 DOMParser           (stream_t *stream);
                 virtual ~DOMParser  ();
 
                 bool                parse       (bool);
+                /* Builds the tree from a reader owned by the caller */
+                bool                parse       (xml_reader_t *, bool);
                 bool                reset       (stream_t *);
                 Node*               getRootNode ();
                 void                print       ();
+                void                setElementHandler(ElementHandler *);
 
             private:
                 Namespaces          nss;
                 Node                *root;
                 stream_t            *stream;
+                ElementHandler      *handler;
 
                 xml_reader_t        *vlc_reader;
 
-                Node*   processNode             (bool);
-                void    addAttributesToNode     (Node *node);
+                Node*   processNode             (xml_reader_t *, bool);
+                void    addAttributesToNode     (xml_reader_t *, Node *node);
                 void    print                   (Node *node, int offset);
         };
     }
@@ -104,7 +104,9 @@ bool DASHManager::updatePlaylist()
             return false;
         }
 
+        SegmentTimelineHandler timelineHandler;
         xml::DOMParser parser(mpdstream);
+        parser.setElementHandler(&timelineHandler);
         if(!parser.parse(true))
         {
             vlc_stream_Delete(mpdstream);
@@ -113,7 +115,8 @@ bool DASHManager::updatePlaylist()
         }
 
         IsoffMainParser mpdparser(parser.getRootNode(), VLC_OBJECT(p_demux),
-                                  mpdstream, Helper::getDirectoryPath(url).append("/"));
+                                  mpdstream, Helper::getDirectoryPath(url).append("/"),
+                                  &timelineHandler);
         MPD *newmpd = mpdparser.parse();
         if(newmpd)
         {
@@ -44,17 +44,63 @@
 #include "../../adaptive/tools/Debug.hpp"
 #include "../../adaptive/tools/Conversions.hpp"
 #include <vlc_stream.h>
+#include <vlc_xml.h>
 #include <cstdio>
+#include <cstring>
 #include <limits>
 
 using namespace dash::mpd;
 using namespace adaptive::xml;
 using namespace adaptive::playlist;
 
+bool SegmentTimelineHandler::handleElement(const Node *parent, const char *name,
+                                           const char *ns, xml_reader_t *reader)
+{
+    if(std::strcmp(name, "S") || !parent->matches("SegmentTimeline", ns))
+        return false;
+
+    Entry entry = {0, 0, 0, false};
+    bool hasDuration = false;
+    const char *attrName, *attrValue, *attrNs;
+    while((attrName = xml_ReaderNextAttrNS(reader, &attrValue, &attrNs)) != nullptr)
+    {
+        if(attrNs && *attrNs)
+            continue;
+        if(!std::strcmp(attrName, "t"))
+        {
+            entry.t = std::strtoll(attrValue, nullptr, 10);
+            entry.hasTime = true;
+        }
+        else if(!std::strcmp(attrName, "d"))
+        {
+            entry.d = std::strtoll(attrValue, nullptr, 10);
+            hasDuration = true;
+        }
+        else if(!std::strcmp(attrName, "r"))
+        {
+            entry.r = std::strtoll(attrValue, nullptr, 10);
+        }
+    }
+
+    Entries &entries = timelines[parent];
+    if(hasDuration) /* Mandatory */
+        entries.push_back(entry);
+    return true;
+}
+
+const SegmentTimelineHandler::Entries *
+SegmentTimelineHandler::getEntries(const Node *node) const
+{
+    auto it = timelines.find(node);
+    return it != timelines.end() ? &it->second : nullptr;
+}
+
 IsoffMainParser::IsoffMainParser    (Node *root_, vlc_object_t *p_object_,
-                                     stream_t *stream, const std::string & streambaseurl_)
+                                     stream_t *stream, const std::string & streambaseurl_,
+                                     const SegmentTimelineHandler *handler)
 {
     root = root_;
+    timelineHandler = handler;
     p_stream = stream;
     p_object = p_object_;
     playlisturl = streambaseurl_;
@@ -527,6 +573,25 @@ void IsoffMainParser::parseTimeline(Node *node, AbstractMultipleSegmentBaseType
     SegmentTimeline *timeline = new (std::nothrow) SegmentTimeline(base);
     if(timeline)
     {
+        const SegmentTimelineHandler::Entries *entries =
+            timelineHandler ? timelineHandler->getEntries(node) : nullptr;
+        if(entries)
+        {
+            for(const SegmentTimelineHandler::Entry &entry : *entries)
+            {
+                int64_t r = entry.r;
+                if(r < 0)
+                    r = std::numeric_limits<unsigned>::max();
+                if(entry.hasTime)
+                    timeline->addElement(number, entry.d, r, entry.t);
+                else
+                    timeline->addElement(number, entry.d, r);
+                number += (1 + r);
+            }
+            base->addAttribute(timeline);
+            return;
+        }
+
         std::vector<Node *> elements = DOMHelper::getElementByTagName(node, "S", getDASHNamespace(), false);
         std::vector<Node *>::const_iterator it;
         for(it = elements.begin(); it != elements.end(); ++it)
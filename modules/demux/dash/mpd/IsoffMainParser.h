@@ -30,9 +30,12 @@
 #endif
 
 #include "../../adaptive/playlist/SegmentBaseType.hpp"
+#include "../../adaptive/xml/DOMParser.h"
 #include "Profile.hpp"
 
 #include <cstdlib>
+#include <map>
+#include <vector>
 
 #include <vlc_common.h>
 
@@ -63,11 +66,34 @@ namespace dash
 
         static const std::string NS_DASH("urn:mpeg:dash:schema:mpd:2011");
 
+        /* Reads the S entries of the SegmentTimelines straight from the
+         * xml reader, as live MPDs can carry tens of thousands of them */
+        class SegmentTimelineHandler : public xml::DOMParser::ElementHandler
+        {
+            public:
+                struct Entry
+                {
+                    stime_t t;
+                    stime_t d;
+                    int64_t r;
+                    bool    hasTime;
+                };
+                using Entries = std::vector<Entry>;
+
+                bool handleElement(const xml::Node *, const char *,
+                                   const char *, xml_reader_t *) override;
+                const Entries * getEntries(const xml::Node *) const;
+
+            private:
+                std::map<const xml::Node *, Entries> timelines;
+        };
+
         class IsoffMainParser
         {
             public:
                 IsoffMainParser             (xml::Node *root, vlc_object_t *p_object,
-                                             stream_t *p_stream, const std::string &);
+                                             stream_t *p_stream, const std::string &,
+                                             const SegmentTimelineHandler * = nullptr);
                 virtual ~IsoffMainParser    ();
                 MPD *   parse();
 
@@ -95,6 +121,7 @@ namespace dash
                 void    parseCommonAttributesElements(xml::Node *, CommonAttributesElements *);
 
                 xml::Node       *root;
+                const SegmentTimelineHandler *timelineHandler;
                 vlc_object_t    *p_object;
                 stream_t        *p_stream;
                 std::string      playlisturl;
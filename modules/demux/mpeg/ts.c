@@ -194,6 +194,9 @@ static bool GatherPESData( demux_t *p_demux, ts_pid_t *, block_t *, size_t );
 static void ProgramSetPCR( demux_t *p_demux, ts_pmt_t *p_prg, stime_t i_pcr );
 
 static block_t* ReadTSPacket( demux_t *p_demux );
+static uint64_t StreamTell( demux_sys_t * );
+static int StreamSeek( demux_sys_t *, uint64_t );
+static void ReadBufferReset( demux_sys_t * );
 static int SeekToTime( demux_t *p_demux, const ts_pmt_t *, stime_t time );
 static void ReadyQueuesPostSeek( demux_t *p_demux );
 static void PCRHandle( demux_t *p_demux, ts_pid_t *, stime_t );
@@ -205,6 +208,8 @@ static void PCRFixHandle( demux_t *, ts_pmt_t *, block_t * );
 #define TS_PACKET_SIZE_MAX 204
 #define TS_HEADER_SIZE 4
 
+#define TS_READ_BATCH 256 /* packets per stream read */
+
 #define PROBE_CHUNK_COUNT 500
 #define PROBE_MAX         (PROBE_CHUNK_COUNT * 10)
 
@@ -405,6 +410,13 @@ static int Open( vlc_object_t *p_this )
     p_sys->i_packet_size = i_packet_size;
     p_sys->i_packet_header_size = i_packet_header_size;
     p_sys->i_ts_read = 50;
+    p_sys->readbuf.i_size = TS_READ_BATCH * i_packet_size;
+    p_sys->readbuf.p_buffer = malloc( p_sys->readbuf.i_size );
+    if( !p_sys->readbuf.p_buffer )
+    {
+        free( p_sys );
+        return VLC_ENOMEM;
+    }
     p_sys->csa = NULL;
     p_sys->b_start_record = false;
     p_sys->record_dir_path = NULL;
@@ -420,12 +432,14 @@ static int Open( vlc_object_t *p_this )
     patpid = GetPID(p_sys, 0);
     if ( !PIDSetup( p_demux, TYPE_PAT, patpid, NULL ) )
     {
+        free( p_sys->readbuf.p_buffer );
         free( p_sys );
         return VLC_ENOMEM;
     }
     if( !ts_psi_PAT_Attach( patpid, p_demux ) )
     {
         PIDRelease( p_demux, patpid );
+        free( p_sys->readbuf.p_buffer );
         free( p_sys );
         return VLC_EGENERIC;
     }
@@ -598,6 +612,7 @@ static void Close( vlc_object_t *p_this )
     vlc_dictionary_clear( &p_sys->attachments, FreeDictAttachment, NULL );
 
     free( p_sys->record_dir_path );
+    free( p_sys->readbuf.p_buffer );
     free( p_sys );
 }
 
@@ -966,7 +981,7 @@ static int Control( demux_t *p_demux, int i_query, va_list args )
 
         if( (i64 = stream_Size( p_sys->stream) ) > 0 )
         {
-            uint64_t offset = vlc_stream_Tell( p_sys->stream );
+            uint64_t offset = StreamTell( p_sys );
             *pf = (double)offset / (double)i64;
             return VLC_SUCCESS;
         }
@@ -1013,7 +1028,7 @@ static int Control( demux_t *p_demux, int i_query, va_list args )
 
         i64 = stream_Size( p_sys->stream );
         if( i64 > 0 &&
-            vlc_stream_Seek( p_sys->stream, (int64_t)(i64 * f) ) == VLC_SUCCESS )
+            StreamSeek( p_sys, (int64_t)(i64 * f) ) == VLC_SUCCESS )
         {
             ReadyQueuesPostSeek( p_demux );
             return VLC_SUCCESS;
@@ -1164,11 +1179,16 @@ static int Control( demux_t *p_demux, int i_query, va_list args )
     }
 
     case DEMUX_SET_TITLE:
-        return vlc_stream_vaControl( p_sys->stream, STREAM_SET_TITLE, args );
+        if( vlc_stream_vaControl( p_sys->stream, STREAM_SET_TITLE, args ) )
+            return VLC_EGENERIC;
+        ReadBufferReset( p_sys );
+        return VLC_SUCCESS;
 
     case DEMUX_SET_SEEKPOINT:
-        return vlc_stream_vaControl( p_sys->stream, STREAM_SET_SEEKPOINT,
-                                     args );
+        if( vlc_stream_vaControl( p_sys->stream, STREAM_SET_SEEKPOINT, args ) )
+            return VLC_EGENERIC;
+        ReadBufferReset( p_sys );
+        return VLC_SUCCESS;
 
     case DEMUX_TEST_AND_CLEAR_FLAGS:
     {
@@ -1804,81 +1824,221 @@ static void PESDataChainHandle( vlc_object_t *p_obj, void *priv, block_t *p_data
     ParsePESDataChain( (demux_t *)p_obj, (ts_pid_t *) priv, p_data, i_flags, i_appendpcr );
 }
 
-static block_t* ReadTSPacket( demux_t *p_demux )
+static void ReadBufferViewRelease( block_t *p_block )
 {
-    demux_sys_t *p_sys = p_demux->p_sys;
+    /* Data is owned by the read buffer */
+    VLC_UNUSED(p_block);
+}
 
-    block_t     *p_pkt;
+static const struct vlc_block_callbacks ReadBufferViewCbs =
+{
+    ReadBufferViewRelease,
+};
 
-    /* Get a new TS packet */
-    if( !( p_pkt = vlc_stream_Block( p_sys->stream, p_sys->i_packet_size ) ) )
+static void ReadBufferReset( demux_sys_t *p_sys )
+{
+    p_sys->readbuf.i_begin = 0;
+    p_sys->readbuf.i_synced = 0;
+    p_sys->readbuf.i_end = 0;
+}
+
+/* Stream offset of the next packet to be returned by ReadTSPacket */
+static uint64_t StreamTell( demux_sys_t *p_sys )
+{
+    return vlc_stream_Tell( p_sys->stream ) -
+           (p_sys->readbuf.i_end - p_sys->readbuf.i_begin);
+}
+
+static int StreamSeek( demux_sys_t *p_sys, uint64_t i_pos )
+{
+    ReadBufferReset( p_sys );
+    return vlc_stream_Seek( p_sys->stream, i_pos );
+}
+
+/* Switches to a temporary read buffer, so that the packet being processed
+ * survives probing at other stream offsets */
+static bool ReadBufferSave( demux_sys_t *p_sys, ts_read_buffer_t *p_saved )
+{
+    uint8_t *p_buffer = malloc( p_sys->readbuf.i_size );
+    if( !p_buffer )
+        return false;
+    *p_saved = p_sys->readbuf;
+    p_sys->readbuf.p_buffer = p_buffer;
+    ReadBufferReset( p_sys );
+    return true;
+}
+
+static void ReadBufferRestore( demux_sys_t *p_sys, const ts_read_buffer_t *p_saved )
+{
+    free( p_sys->readbuf.p_buffer );
+    p_sys->readbuf = *p_saved;
+}
+
+/* Ensures at least i_min bytes are buffered, grabbing as many whole packets
+ * as the stream can provide without blocking. Returns the buffered size. */
+static size_t ReadBufferFill( demux_sys_t *p_sys, size_t i_min )
+{
+    uint8_t *p_buffer = p_sys->readbuf.p_buffer;
+    size_t i_avail = p_sys->readbuf.i_end - p_sys->readbuf.i_begin;
+
+    if( i_avail >= i_min )
+        return i_avail;
+
+    if( p_sys->readbuf.i_begin > 0 )
     {
-        int64_t size = stream_Size( p_sys->stream );
-        if( size >= 0 && (uint64_t)size == vlc_stream_Tell( p_sys->stream ) )
-            msg_Dbg( p_demux, "EOF at %"PRIu64, vlc_stream_Tell( p_sys->stream ) );
-        else
-            msg_Dbg( p_demux, "Can't read TS packet at %"PRIu64, vlc_stream_Tell(p_sys->stream) );
-        return NULL;
+        memmove( p_buffer, &p_buffer[p_sys->readbuf.i_begin], i_avail );
+        p_sys->readbuf.i_synced -= __MIN(p_sys->readbuf.i_synced,
+                                         p_sys->readbuf.i_begin);
+        p_sys->readbuf.i_begin = 0;
+        p_sys->readbuf.i_end = i_avail;
     }
 
-    if( p_pkt->i_buffer < TS_HEADER_SIZE + p_sys->i_packet_header_size )
+    ssize_t i_read = vlc_stream_ReadPartial( p_sys->stream, &p_buffer[i_avail],
+                                             p_sys->readbuf.i_size - i_avail );
+    if( i_read <= 0 )
+        return i_avail;
+    i_avail += i_read;
+
+    /* Only wait for the remainder of the last packet */
+    size_t i_want = i_avail % p_sys->i_packet_size;
+    if( i_want )
+        i_want = p_sys->i_packet_size - i_want;
+    if( i_avail + i_want < i_min )
+        i_want = i_min - i_avail;
+    i_want = __MIN(i_want, p_sys->readbuf.i_size - i_avail);
+    if( i_want )
     {
-        block_Release( p_pkt );
-        return NULL;
+        i_read = vlc_stream_Read( p_sys->stream, &p_buffer[i_avail], i_want );
+        if( i_read > 0 )
+            i_avail += i_read;
     }
 
-    /* Skip header (BluRay streams).
-     * re-sync logic would do this (by adjusting packet start), but this would result in losing first and last ts packets.
-     * First packet is usually PAT, and losing it means losing whole first GOP. This is fatal with still-image based menus.
-     */
-    p_pkt->p_buffer += p_sys->i_packet_header_size;
-    p_pkt->i_buffer -= p_sys->i_packet_header_size;
+    p_sys->readbuf.i_end = i_avail;
+    return i_avail;
+}
 
-    /* Check sync byte and re-sync if needed */
-    if( p_pkt->p_buffer[0] != 0x47 )
+/* Validates sync bytes of all complete buffered packets in one pass */
+static void ReadBufferCheckSync( demux_sys_t *p_sys )
+{
+    const uint8_t *p_buffer = p_sys->readbuf.p_buffer;
+    size_t i_pos = __MAX(p_sys->readbuf.i_begin, p_sys->readbuf.i_synced);
+
+    while( i_pos + p_sys->i_packet_size <= p_sys->readbuf.i_end &&
+           p_buffer[i_pos + p_sys->i_packet_header_size] == 0x47 )
+        i_pos += p_sys->i_packet_size;
+
+    p_sys->readbuf.i_synced = i_pos;
+}
+
+/* Descrambles the packets newly validated by ReadBufferCheckSync, so that
+ * the CSA packets sharing a key are processed in batches */
+static void ReadBufferDescramble( demux_sys_t *p_sys, size_t i_from )
+{
+    uint8_t *pp_pkts[TS_READ_BATCH];
+    size_t i_count = 0;
+
+    for( size_t i_pos = i_from; i_pos < p_sys->readbuf.i_synced;
+         i_pos += p_sys->i_packet_size )
     {
+        uint8_t *p = &p_sys->readbuf.p_buffer[i_pos + p_sys->i_packet_header_size];
+
+        if( (p[3]&0x80) == 0 || unlikely(p[1]&0x80) ||
+            unlikely((((p[1]&0x1f)<<8)|p[2]) == 0x1FFF) )
+            continue;
+
+        pp_pkts[i_count++] = p;
+        if( i_count == TS_READ_BATCH )
+        {
+            vlc_mutex_lock( &p_sys->csa_lock );
+            csa_DecryptBatch( p_sys->csa, pp_pkts, i_count, p_sys->i_csa_pkt_size );
+            vlc_mutex_unlock( &p_sys->csa_lock );
+            i_count = 0;
+        }
+    }
+
+    if( i_count > 0 )
+    {
+        vlc_mutex_lock( &p_sys->csa_lock );
+        csa_DecryptBatch( p_sys->csa, pp_pkts, i_count, p_sys->i_csa_pkt_size );
+        vlc_mutex_unlock( &p_sys->csa_lock );
+    }
+}
+
+/* Returns the next packet as a view into the read buffer. The block is only
+ * valid until the next call and must be duplicated to be kept. */
+static block_t* ReadTSPacket( demux_t *p_demux )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+
+    for( ;; )
+    {
+        if( ReadBufferFill( p_sys, p_sys->i_packet_size ) < p_sys->i_packet_size )
+        {
+            int64_t size = stream_Size( p_sys->stream );
+            if( size >= 0 && (uint64_t)size == StreamTell( p_sys ) )
+                msg_Dbg( p_demux, "EOF at %"PRIu64, StreamTell( p_sys ) );
+            else
+                msg_Dbg( p_demux, "Can't read TS packet at %"PRIu64, StreamTell( p_sys ) );
+            return NULL;
+        }
+
+        if( p_sys->readbuf.i_synced <= p_sys->readbuf.i_begin )
+        {
+            ReadBufferCheckSync( p_sys );
+            if( p_sys->csa )
+                ReadBufferDescramble( p_sys, p_sys->readbuf.i_begin );
+        }
+
+        if( p_sys->readbuf.i_synced > p_sys->readbuf.i_begin )
+            break;
+
+        /* Check sync byte and re-sync if needed */
         msg_Warn( p_demux, "lost synchro" );
-        block_Release( p_pkt );
         for( ;; )
         {
-            const uint8_t *p_peek;
-            int i_peek = 0;
-            unsigned i_skip = 0;
+            const size_t i_peek = ReadBufferFill( p_sys, p_sys->i_packet_size * 10 );
+            const uint8_t *p_peek = &p_sys->readbuf.p_buffer[p_sys->readbuf.i_begin];
+            size_t i_skip = 0;
 
-            i_peek = vlc_stream_Peek( p_sys->stream, &p_peek,
-                    p_sys->i_packet_size * 10 );
-            if( i_peek < 0 || (unsigned)i_peek < p_sys->i_packet_size + 1 )
+            if( i_peek < p_sys->i_packet_size + p_sys->i_packet_header_size + 1 )
             {
                 msg_Dbg( p_demux, "eof ?" );
                 return NULL;
             }
 
-            while( i_skip < i_peek - p_sys->i_packet_size )
+            const size_t i_last = i_peek - p_sys->i_packet_size - p_sys->i_packet_header_size;
+            while( i_skip < i_last )
             {
                 if( p_peek[i_skip + p_sys->i_packet_header_size] == 0x47 &&
-                        p_peek[i_skip + p_sys->i_packet_header_size + p_sys->i_packet_size] == 0x47 )
+                    p_peek[i_skip + p_sys->i_packet_header_size + p_sys->i_packet_size] == 0x47 )
                 {
                     break;
                 }
                 i_skip++;
             }
-            msg_Dbg( p_demux, "skipping %d bytes of garbage at %"PRIu64,
-                     i_skip, vlc_stream_Tell( p_sys->stream ) );
-            if (vlc_stream_Read( p_sys->stream, NULL, i_skip ) != i_skip)
-                return NULL;
+            msg_Dbg( p_demux, "skipping %zu bytes of garbage at %"PRIu64,
+                     i_skip, StreamTell( p_sys ) );
+            p_sys->readbuf.i_begin += i_skip;
+            p_sys->readbuf.i_synced = p_sys->readbuf.i_begin;
 
-            if( i_skip < i_peek - p_sys->i_packet_size )
-            {
+            if( i_skip < i_last )
                 break;
-            }
-        }
-        msg_Dbg( p_demux, "resynced at %" PRIu64, vlc_stream_Tell( p_sys->stream ) );
-        if( !( p_pkt = vlc_stream_Block( p_sys->stream, p_sys->i_packet_size ) ) )
-        {
-            msg_Dbg( p_demux, "eof ?" );
-            return NULL;
         }
+        msg_Dbg( p_demux, "resynced at %" PRIu64, StreamTell( p_sys ) );
     }
+
+    block_t *p_pkt = block_Init( &p_sys->readbuf.view, &ReadBufferViewCbs,
+                                 &p_sys->readbuf.p_buffer[p_sys->readbuf.i_begin],
+                                 p_sys->i_packet_size );
+    p_sys->readbuf.i_begin += p_sys->i_packet_size;
+
+    /* Skip header (BluRay streams).
+     * re-sync logic would do this (by adjusting packet start), but this would result in losing first and last ts packets.
+     * First packet is usually PAT, and losing it means losing whole first GOP. This is fatal with still-image based menus.
+     */
+    p_pkt->p_buffer += p_sys->i_packet_header_size;
+    p_pkt->i_buffer -= p_sys->i_packet_header_size;
+
     return p_pkt;
 }
 
@@ -2010,13 +2170,13 @@ static int SeekToTime( demux_t *p_demux, const ts_pmt_t *p_pmt, stime_t i_scaled
 
     /* Deal with common but worst binary search case */
     if( p_pmt->pcr.i_first == i_scaledtime && p_sys->b_canseek )
-        return vlc_stream_Seek( p_sys->stream, 0 );
+        return StreamSeek( p_sys, 0 );
 
     const int64_t i_stream_size = stream_Size( p_sys->stream );
     if( !p_sys->b_canfastseek || i_stream_size < p_sys->i_packet_size )
         return VLC_EGENERIC;
 
-    const uint64_t i_initial_pos = vlc_stream_Tell( p_sys->stream );
+    const uint64_t i_initial_pos = StreamTell( p_sys );
 
     /* Find the time position by using binary search algorithm. */
     uint64_t i_head_pos = 0;
@@ -2032,7 +2192,7 @@ static int SeekToTime( demux_t *p_demux, const ts_pmt_t *p_pmt, stime_t i_scaled
         uint64_t i_div = i_splitpos % p_sys->i_packet_size;
         i_splitpos -= i_div;
 
-        if ( vlc_stream_Seek( p_sys->stream, i_splitpos ) != VLC_SUCCESS )
+        if ( StreamSeek( p_sys, i_splitpos ) != VLC_SUCCESS )
             break;
 
         uint64_t i_pos = i_splitpos;
@@ -2046,7 +2206,7 @@ static int SeekToTime( demux_t *p_demux, const ts_pmt_t *p_pmt, stime_t i_scaled
                 break;
             }
             else
-                i_pos = vlc_stream_Tell( p_sys->stream );
+                i_pos = StreamTell( p_sys );
 
             int i_pid = PIDGet( p_pkt );
             ts_pid_t *p_pid = GetPID(p_sys, i_pid);
@@ -2103,7 +2263,7 @@ static int SeekToTime( demux_t *p_demux, const ts_pmt_t *p_pmt, stime_t i_scaled
     if( !b_found )
     {
         msg_Dbg( p_demux, "Seek():cannot find a time position." );
-        if( vlc_stream_Seek( p_sys->stream, i_initial_pos ) != VLC_SUCCESS )
+        if( StreamSeek( p_sys, i_initial_pos ) != VLC_SUCCESS )
             msg_Err( p_demux, "Can't seek back to %" PRIu64, i_initial_pos );
         return VLC_EGENERIC;
     }
@@ -2189,7 +2349,7 @@ static int ProbeChunk( demux_t *p_demux, int i_program, bool b_end, bool *pb_fou
                         if( b_end )
                         {
                             p_pmt->i_last_dts = i_pcr;
-                            p_pmt->i_last_dts_byte = vlc_stream_Tell( p_sys->stream );
+                            p_pmt->i_last_dts_byte = StreamTell( p_sys );
                         }
                         /* Start, only keep first */
                         else if( b_pcrresult && p_pmt->pcr.i_first == -1 )
@@ -2218,6 +2378,9 @@ int ProbeStart( demux_t *p_demux, int i_program )
 {
     demux_sys_t *p_sys = p_demux->p_sys;
     const uint64_t i_initial_pos = vlc_stream_Tell( p_sys->stream );
+    ts_read_buffer_t readbuf;
+    if( !ReadBufferSave( p_sys, &readbuf ) )
+        return VLC_ENOMEM;
     int64_t i_stream_size = stream_Size( p_sys->stream );
 
     int i_probe_count = 0;
@@ -2229,8 +2392,8 @@ int ProbeStart( demux_t *p_demux, int i_program )
         i_pos = (int64_t)p_sys->i_packet_size * i_probe_count;
         i_pos = __MIN( i_pos, i_stream_size );
 
-        if( vlc_stream_Seek( p_sys->stream, i_pos ) )
-            return VLC_EGENERIC;
+        if( StreamSeek( p_sys, i_pos ) )
+            break;
 
         int i_count =  ProbeChunk( p_demux, i_program, false, &b_found );
         if( i_count < PROBE_CHUNK_COUNT )
@@ -2241,6 +2404,7 @@ int ProbeStart( demux_t *p_demux, int i_program )
     } while( i_pos < i_stream_size && !b_found &&
              i_probe_count < PROBE_MAX );
 
+    ReadBufferRestore( p_sys, &readbuf );
     if( vlc_stream_Seek( p_sys->stream, i_initial_pos ) )
         return VLC_EGENERIC;
 
@@ -2251,6 +2415,9 @@ int ProbeEnd( demux_t *p_demux, int i_program )
 {
     demux_sys_t *p_sys = p_demux->p_sys;
     const uint64_t i_initial_pos = vlc_stream_Tell( p_sys->stream );
+    ts_read_buffer_t readbuf;
+    if( !ReadBufferSave( p_sys, &readbuf ) )
+        return VLC_ENOMEM;
     int64_t i_stream_size = stream_Size( p_sys->stream );
 
     int i_probe_count = PROBE_CHUNK_COUNT;
@@ -2262,8 +2429,8 @@ int ProbeEnd( demux_t *p_demux, int i_program )
         i_pos = i_stream_size - (p_sys->i_packet_size * i_probe_count);
         i_pos = __MAX( i_pos, 0 );
 
-        if( vlc_stream_Seek( p_sys->stream, i_pos ) )
-            return VLC_EGENERIC;
+        if( StreamSeek( p_sys, i_pos ) )
+            break;
 
         int i_count = ProbeChunk( p_demux, i_program, true, &b_found );
         if( i_count < PROBE_CHUNK_COUNT )
@@ -2274,6 +2441,7 @@ int ProbeEnd( demux_t *p_demux, int i_program )
     } while( i_pos > 0 && !b_found &&
              i_probe_count < PROBE_MAX );
 
+    ReadBufferRestore( p_sys, &readbuf );
     if( vlc_stream_Seek( p_sys->stream, i_initial_pos ) )
         return VLC_EGENERIC;
 
@@ -2329,14 +2497,14 @@ static void ProgramSetPCR( demux_t *p_demux, ts_pmt_t *p_pmt, stime_t i_pcr )
         es_out_Control( p_demux->out, ES_OUT_SET_GROUP_PCR, p_pmt->i_number, FROM_SCALE(i_pcr) );
         /* growing files/named fifo handling */
         if( p_sys->b_access_control == false &&
-            vlc_stream_Tell( p_sys->stream ) > p_pmt->i_last_dts_byte )
+            StreamTell( p_sys ) > p_pmt->i_last_dts_byte )
         {
             if( p_pmt->i_last_dts_byte == 0 ) /* first run */
                 p_pmt->i_last_dts_byte = stream_Size( p_sys->stream );
             else
             {
                 p_pmt->i_last_dts = i_pcr;
-                p_pmt->i_last_dts_byte = vlc_stream_Tell( p_sys->stream );
+                p_pmt->i_last_dts_byte = StreamTell( p_sys );
             }
         }
     }
@@ -2576,17 +2744,9 @@ static block_t * ProcessTSPacket( demux_t *p_demux, ts_pid_t *pid, block_t *p_pk
      * TODO: handle Reed-Solomon 204,188 error correction */
     p_pkt->i_buffer = TS_PACKET_SIZE_188;
 
-    if( b_scrambled )
-    {
-        if( p_sys->csa )
-        {
-            vlc_mutex_lock( &p_sys->csa_lock );
-            csa_Decrypt( p_sys->csa, p_pkt->p_buffer, p_sys->i_csa_pkt_size );
-            vlc_mutex_unlock( &p_sys->csa_lock );
-        }
-        else
-            p_pkt->i_flags |= BLOCK_FLAG_SCRAMBLED;
-    }
+    /* With a CSA key, packets were descrambled by ReadTSPacket */
+    if( b_scrambled && !p_sys->csa )
+        p_pkt->i_flags |= BLOCK_FLAG_SCRAMBLED;
 
     /* We don't have any adaptation_field, so payload starts
      * immediately after the 4 byte TS header */
@@ -2697,6 +2857,12 @@ static bool GatherPESData( demux_t *p_demux, ts_pid_t *p_pid, block_t *p_pkt, si
                                  .priv = p_pid,
                                  .pf_parse = PESDataChainHandle };
     const bool b_unit_start = p_pkt->p_buffer[1]&0x40;
+
+    /* Payload gets queued, detach it from the read buffer */
+    p_pkt = block_Duplicate( p_pkt );
+    if( unlikely(!p_pkt) )
+        return false;
+
     p_pkt->p_buffer += i_skip; /* point to PES */
     p_pkt->i_buffer -= i_skip;
 
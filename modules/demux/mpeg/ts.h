@@ -21,6 +21,7 @@
 #define VLC_TS_H
 
 #include <vlc_arrays.h>
+#include <vlc_block.h>
 
 #ifdef HAVE_ARIBB24
     typedef struct arib_instance_t arib_instance_t;
@@ -52,6 +53,16 @@ typedef struct
     int i_service;
 } vdr_info_t;
 
+typedef struct
+{
+    uint8_t    *p_buffer;
+    size_t      i_size;
+    size_t      i_begin;  /* first unread byte */
+    size_t      i_synced; /* end of sync byte validated packets */
+    size_t      i_end;    /* end of buffered data */
+    block_t     view;     /* last returned packet */
+} ts_read_buffer_t;
+
 struct demux_sys_t
 {
     stream_t   *stream;
@@ -72,6 +83,9 @@ struct demux_sys_t
     /* how many TS packet we read at once */
     unsigned    i_ts_read;
 
+    /* Batched stream reads, packets are served in place from that buffer */
+    ts_read_buffer_t readbuf;
+
     bool        b_cc_check;
     bool        b_ignore_time_for_positions;
 
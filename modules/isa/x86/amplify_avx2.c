@@ -0,0 +1,103 @@
+/*****************************************************************************
+ * amplify_avx2.c: x86 AVX2 audio amplification
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <immintrin.h>
+
+#include <vlc_common.h>
+#include <vlc_cpu.h>
+#include "avx2.h"
+
+VLC_AVX2
+void amplify_f32_avx2(void *buf, size_t len, float amp)
+{
+    float *p = buf;
+    const __m256 mult = _mm256_set1_ps(amp);
+
+    for (len /= sizeof (*p); len >= 16; len -= 16)
+    {
+        __m256 a = _mm256_loadu_ps(p);
+        __m256 b = _mm256_loadu_ps(p + 8);
+
+        _mm256_storeu_ps(p, _mm256_mul_ps(a, mult));
+        _mm256_storeu_ps(p + 8, _mm256_mul_ps(b, mult));
+        p += 16;
+    }
+
+    for (; len > 0; len--)
+        *(p++) *= amp;
+}
+
+VLC_AVX2
+void amplify_f64_avx2(void *buf, size_t len, double amp)
+{
+    double *p = buf;
+    const __m256d mult = _mm256_set1_pd(amp);
+
+    for (len /= sizeof (*p); len >= 8; len -= 8)
+    {
+        __m256d a = _mm256_loadu_pd(p);
+        __m256d b = _mm256_loadu_pd(p + 4);
+
+        _mm256_storeu_pd(p, _mm256_mul_pd(a, mult));
+        _mm256_storeu_pd(p + 4, _mm256_mul_pd(b, mult));
+        p += 8;
+    }
+
+    for (; len > 0; len--)
+        *(p++) *= amp;
+}
+
+VLC_AVX2
+void amplify_s16_avx2(void *buf, size_t len, int16_t amp)
+{
+    int16_t *p = buf;
+    const __m256i mult = _mm256_set1_epi32(amp);
+
+    for (len /= sizeof (*p); len >= 16; len -= 16)
+    {
+        __m256i s = _mm256_loadu_si256((const __m256i *)p);
+        /* 16x16 products need 32 bits */
+        __m256i lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(s));
+        __m256i hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(s, 1));
+
+        lo = _mm256_srai_epi32(_mm256_mullo_epi32(lo, mult), 8);
+        hi = _mm256_srai_epi32(_mm256_mullo_epi32(hi, mult), 8);
+        /* Saturate, and restore the order mixed by the in-lane packing */
+        s = _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi),
+                                     _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256((__m256i *)p, s);
+        p += 16;
+    }
+
+    for (; len > 0; len--)
+    {
+        int_fast32_t s = (*p * (int_fast32_t)amp) >> 8;
+        if (s > INT16_MAX)
+            s = INT16_MAX;
+        else
+        if (s < INT16_MIN)
+            s = INT16_MIN;
+        *(p++) = s;
+    }
+}
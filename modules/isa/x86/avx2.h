@@ -0,0 +1,100 @@
+/*****************************************************************************
+ * avx2.h: x86 AVX2 kernels
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_ISA_X86_AVX2_H
+#define VLC_ISA_X86_AVX2_H 1
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* The kernels must only be called if vlc_CPU_AVX2() is true. They have no
+ * alignment requirements, and produce the exact same output as the C code
+ * they replace. */
+
+/* Planar picture buffer. Pitches are in bytes. */
+struct yuv_planes
+{
+    void *y, *u, *v;
+    size_t y_pitch, uv_pitch;
+};
+
+/* Planar chroma buffers. Pitch is in bytes. */
+struct uv_planes
+{
+    void *u, *v;
+    size_t pitch;
+};
+
+/* Packed picture buffer. Pitch is in bytes (_not_ pixels). */
+struct yuv_pack
+{
+    void *yuv;
+    size_t pitch;
+};
+
+/* Planar YUV 4:2:0 and 4:2:2 to packed YUV 4:2:2. Width must be even. */
+void i420_yuyv_avx2(const struct yuv_pack *out, const struct yuv_planes *in,
+                    unsigned width, unsigned height);
+void i420_uyvy_avx2(const struct yuv_pack *out, const struct yuv_planes *in,
+                    unsigned width, unsigned height);
+void i422_yuyv_avx2(const struct yuv_pack *out, const struct yuv_planes *in,
+                    unsigned width, unsigned height);
+void i422_uyvy_avx2(const struct yuv_pack *out, const struct yuv_planes *in,
+                    unsigned width, unsigned height);
+
+/* Packed YUV 4:2:2 to planar YUV 4:2:2. Width must be even. */
+void yuyv_i422_avx2(const struct yuv_planes *out, const struct yuv_pack *in,
+                    unsigned width, unsigned height);
+void uyvy_i422_avx2(const struct yuv_planes *out, const struct yuv_pack *in,
+                    unsigned width, unsigned height);
+
+/* Semiplanar to planar chroma. Width is in chroma samples. */
+void deinterleave_chroma_avx2(const struct uv_planes *out,
+                              const struct yuv_pack *in,
+                              unsigned width, unsigned height);
+
+/* Line blending (deinterlace functions), rounding down */
+void merge8_avx2(void *, const void *, const void *, size_t);
+void merge16_avx2(void *, const void *, const void *, size_t);
+
+/* In-place audio amplification, lengths in bytes */
+void amplify_f32_avx2(void *, size_t, float);
+void amplify_f64_avx2(void *, size_t, double);
+/* S16N samples by a 8.8 fixed point factor, saturating */
+void amplify_s16_avx2(void *, size_t, int16_t);
+
+/* Simple channel mixer conversions, on interleaved float samples */
+#define AVX2_CHANNEL_MIXER(in, out) \
+    void convert_##in##_to_##out##_avx2(float *dst, const float *src, \
+                                        int num, bool lfeChannel);
+
+AVX2_CHANNEL_MIXER(7_x,2_0)
+AVX2_CHANNEL_MIXER(5_x,2_0)
+AVX2_CHANNEL_MIXER(4_0,2_0)
+AVX2_CHANNEL_MIXER(3_x,2_0)
+AVX2_CHANNEL_MIXER(7_x,1_0)
+AVX2_CHANNEL_MIXER(5_x,1_0)
+AVX2_CHANNEL_MIXER(7_x,4_0)
+AVX2_CHANNEL_MIXER(5_x,4_0)
+
+#undef AVX2_CHANNEL_MIXER
+
+#endif
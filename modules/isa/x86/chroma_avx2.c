@@ -0,0 +1,225 @@
+/*****************************************************************************
+ * chroma_avx2.c: x86 AVX2 YUV packing and unpacking
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <immintrin.h>
+
+#include <vlc_common.h>
+#include <vlc_cpu.h>
+#include "avx2.h"
+
+/* Packs 32 pixels: Y[0-31] with U[0-15] and V[0-15] */
+VLC_AVX2
+static inline void pack32(uint8_t *dst, const uint8_t *y, const uint8_t *u,
+                          const uint8_t *v, bool uyvy)
+{
+    const __m256i luma = _mm256_loadu_si256((const __m256i *)y);
+    const __m128i cb = _mm_loadu_si128((const __m128i *)u);
+    const __m128i cr = _mm_loadu_si128((const __m128i *)v);
+    /* UV pairs 0-7 in the low lane, 8-15 in the high lane, so that the
+     * in-lane unpacking matches them with luma 0-15 and 16-31 */
+    const __m256i chroma = _mm256_set_m128i(_mm_unpackhi_epi8(cb, cr),
+                                            _mm_unpacklo_epi8(cb, cr));
+    __m256i lo, hi;
+
+    if (uyvy)
+    {
+        lo = _mm256_unpacklo_epi8(chroma, luma);
+        hi = _mm256_unpackhi_epi8(chroma, luma);
+    }
+    else
+    {
+        lo = _mm256_unpacklo_epi8(luma, chroma);
+        hi = _mm256_unpackhi_epi8(luma, chroma);
+    }
+
+    _mm256_storeu_si256((__m256i *)dst, _mm256_permute2x128_si256(lo, hi, 0x20));
+    _mm256_storeu_si256((__m256i *)(dst + 32),
+                        _mm256_permute2x128_si256(lo, hi, 0x31));
+}
+
+VLC_AVX2
+static void planar_to_packed(const struct yuv_pack *out,
+                             const struct yuv_planes *in,
+                             unsigned width, unsigned height,
+                             unsigned vshift, bool uyvy)
+{
+    for (unsigned i = 0; i < height; i++)
+    {
+        uint8_t *dst = (uint8_t *)out->yuv + i * out->pitch;
+        const uint8_t *y = (const uint8_t *)in->y + i * in->y_pitch;
+        const uint8_t *u = (const uint8_t *)in->u + (i >> vshift) * in->uv_pitch;
+        const uint8_t *v = (const uint8_t *)in->v + (i >> vshift) * in->uv_pitch;
+        unsigned x = 0;
+
+        for (; x + 32 <= width; x += 32)
+            pack32(&dst[2 * x], &y[x], &u[x / 2], &v[x / 2], uyvy);
+
+        for (; x + 2 <= width; x += 2)
+        {
+            uint8_t *p = &dst[2 * x];
+
+            p[uyvy ? 1 : 0] = y[x];
+            p[uyvy ? 0 : 1] = u[x / 2];
+            p[uyvy ? 3 : 2] = y[x + 1];
+            p[uyvy ? 2 : 3] = v[x / 2];
+        }
+    }
+}
+
+void i420_yuyv_avx2(const struct yuv_pack *out, const struct yuv_planes *in,
+                    unsigned width, unsigned height)
+{
+    planar_to_packed(out, in, width, height, 1, false);
+}
+
+void i420_uyvy_avx2(const struct yuv_pack *out, const struct yuv_planes *in,
+                    unsigned width, unsigned height)
+{
+    planar_to_packed(out, in, width, height, 1, true);
+}
+
+void i422_yuyv_avx2(const struct yuv_pack *out, const struct yuv_planes *in,
+                    unsigned width, unsigned height)
+{
+    planar_to_packed(out, in, width, height, 0, false);
+}
+
+void i422_uyvy_avx2(const struct yuv_pack *out, const struct yuv_planes *in,
+                    unsigned width, unsigned height)
+{
+    planar_to_packed(out, in, width, height, 0, true);
+}
+
+/* Splits 32 pixels into Y[0-31], U[0-15] and V[0-15] */
+VLC_AVX2
+static inline void unpack32(uint8_t *y, uint8_t *u, uint8_t *v,
+                            const uint8_t *src, __m256i shuf)
+{
+    /* Each lane becomes Y0-7 U0-3 V0-3 */
+    __m256i a = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)src),
+                                    shuf);
+    __m256i b = _mm256_shuffle_epi8(
+        _mm256_loadu_si256((const __m256i *)(src + 32)), shuf);
+
+    /* Luma in the low lane, chroma in the high lane */
+    a = _mm256_permute4x64_epi64(a, _MM_SHUFFLE(3, 1, 2, 0));
+    b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(3, 1, 2, 0));
+
+    const __m256i luma = _mm256_permute2x128_si256(a, b, 0x20);
+    const __m256i chroma = _mm256_permutevar8x32_epi32(
+        _mm256_permute2x128_si256(a, b, 0x31),
+        _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7));
+
+    _mm256_storeu_si256((__m256i *)y, luma);
+    _mm_storeu_si128((__m128i *)u, _mm256_castsi256_si128(chroma));
+    _mm_storeu_si128((__m128i *)v, _mm256_extracti128_si256(chroma, 1));
+}
+
+VLC_AVX2
+static void packed_to_planar(const struct yuv_planes *out,
+                             const struct yuv_pack *in,
+                             unsigned width, unsigned height, bool uyvy)
+{
+    const __m256i shuf = uyvy
+        ? _mm256_setr_epi8(1, 3, 5, 7, 9, 11, 13, 15, 0, 4, 8, 12, 2, 6, 10, 14,
+                           1, 3, 5, 7, 9, 11, 13, 15, 0, 4, 8, 12, 2, 6, 10, 14)
+        : _mm256_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 5, 9, 13, 3, 7, 11, 15,
+                           0, 2, 4, 6, 8, 10, 12, 14, 1, 5, 9, 13, 3, 7, 11, 15);
+
+    for (unsigned i = 0; i < height; i++)
+    {
+        const uint8_t *src = (const uint8_t *)in->yuv + i * in->pitch;
+        uint8_t *y = (uint8_t *)out->y + i * out->y_pitch;
+        uint8_t *u = (uint8_t *)out->u + i * out->uv_pitch;
+        uint8_t *v = (uint8_t *)out->v + i * out->uv_pitch;
+        unsigned x = 0;
+
+        for (; x + 32 <= width; x += 32)
+            unpack32(&y[x], &u[x / 2], &v[x / 2], &src[2 * x], shuf);
+
+        for (; x + 2 <= width; x += 2)
+        {
+            const uint8_t *p = &src[2 * x];
+
+            y[x] = p[uyvy ? 1 : 0];
+            u[x / 2] = p[uyvy ? 0 : 1];
+            y[x + 1] = p[uyvy ? 3 : 2];
+            v[x / 2] = p[uyvy ? 2 : 3];
+        }
+    }
+}
+
+void yuyv_i422_avx2(const struct yuv_planes *out, const struct yuv_pack *in,
+                    unsigned width, unsigned height)
+{
+    packed_to_planar(out, in, width, height, false);
+}
+
+void uyvy_i422_avx2(const struct yuv_planes *out, const struct yuv_pack *in,
+                    unsigned width, unsigned height)
+{
+    packed_to_planar(out, in, width, height, true);
+}
+
+VLC_AVX2
+void deinterleave_chroma_avx2(const struct uv_planes *out,
+                              const struct yuv_pack *in,
+                              unsigned width, unsigned height)
+{
+    /* Each lane becomes U0-7 V0-7 */
+    const __m256i shuf =
+        _mm256_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15,
+                         0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+
+    for (unsigned i = 0; i < height; i++)
+    {
+        const uint8_t *src = (const uint8_t *)in->yuv + i * in->pitch;
+        uint8_t *u = (uint8_t *)out->u + i * out->pitch;
+        uint8_t *v = (uint8_t *)out->v + i * out->pitch;
+        unsigned x = 0;
+
+        for (; x + 32 <= width; x += 32)
+        {
+            __m256i a = _mm256_loadu_si256((const __m256i *)&src[2 * x]);
+            __m256i b = _mm256_loadu_si256((const __m256i *)&src[2 * x + 32]);
+
+            /* U in the low lane, V in the high lane */
+            a = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(a, shuf),
+                                         _MM_SHUFFLE(3, 1, 2, 0));
+            b = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(b, shuf),
+                                         _MM_SHUFFLE(3, 1, 2, 0));
+
+            _mm256_storeu_si256((__m256i *)&u[x],
+                                _mm256_permute2x128_si256(a, b, 0x20));
+            _mm256_storeu_si256((__m256i *)&v[x],
+                                _mm256_permute2x128_si256(a, b, 0x31));
+        }
+
+        for (; x < width; x++)
+        {
+            u[x] = src[2 * x];
+            v[x] = src[2 * x + 1];
+        }
+    }
+}
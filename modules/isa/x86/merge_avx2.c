@@ -0,0 +1,79 @@
+/*****************************************************************************
+ * merge_avx2.c: x86 AVX2 deinterlacing line blending
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <immintrin.h>
+
+#include <vlc_common.h>
+#include <vlc_cpu.h>
+#include "avx2.h"
+
+/* pavg rounds up, while the C code rounds down: subtract the odd bit */
+
+VLC_AVX2
+void merge8_avx2(void *dst, const void *src1, const void *src2, size_t len)
+{
+    uint8_t *d = dst;
+    const uint8_t *s1 = src1, *s2 = src2;
+    const __m256i one = _mm256_set1_epi8(1);
+
+    for (; len >= 32; len -= 32)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i *)s1);
+        __m256i b = _mm256_loadu_si256((const __m256i *)s2);
+        __m256i odd = _mm256_and_si256(_mm256_xor_si256(a, b), one);
+
+        _mm256_storeu_si256((__m256i *)d,
+                            _mm256_sub_epi8(_mm256_avg_epu8(a, b), odd));
+        d += 32;
+        s1 += 32;
+        s2 += 32;
+    }
+
+    for (; len > 0; len--)
+        *d++ = (*s1++ + *s2++) >> 1;
+}
+
+VLC_AVX2
+void merge16_avx2(void *dst, const void *src1, const void *src2, size_t len)
+{
+    uint16_t *d = dst;
+    const uint16_t *s1 = src1, *s2 = src2;
+    const __m256i one = _mm256_set1_epi16(1);
+
+    for (len /= 2; len >= 16; len -= 16)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i *)s1);
+        __m256i b = _mm256_loadu_si256((const __m256i *)s2);
+        __m256i odd = _mm256_and_si256(_mm256_xor_si256(a, b), one);
+
+        _mm256_storeu_si256((__m256i *)d,
+                            _mm256_sub_epi16(_mm256_avg_epu16(a, b), odd));
+        d += 16;
+        s1 += 16;
+        s2 += 16;
+    }
+
+    for (; len > 0; len--)
+        *d++ = (*s1++ + *s2++) >> 1;
+}
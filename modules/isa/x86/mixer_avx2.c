@@ -0,0 +1,341 @@
+/*****************************************************************************
+ * mixer_avx2.c: x86 AVX2 simple channel mixer
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <immintrin.h>
+
+#include <vlc_common.h>
+#include <vlc_cpu.h>
+#include "avx2.h"
+
+/*
+ * Eight samples are processed at once, each input channel being transposed
+ * into one vector (gathers are much slower on most CPUs). The operations are
+ * the same, in the same order, as in the C code of the simple channel mixer,
+ * so that results are identical. Divisions by powers of two are exact
+ * multiplications.
+ *
+ * Four channels are loaded from each sample, possibly reading past the last
+ * sample of the batch: the vector loops leave at least one sample over.
+ */
+
+#define MIXER_SAMPLES 8
+
+/* Loads channels [0-3] of 8 samples, one vector per channel */
+VLC_AVX2
+static inline void load_4(__m256 *ch, const float *src, unsigned channels)
+{
+    __m256 r[4];
+
+    for (unsigned i = 0; i < 4; i++)
+        r[i] = _mm256_insertf128_ps(
+            _mm256_castps128_ps256(_mm_loadu_ps(src + i * channels)),
+            _mm_loadu_ps(src + (i + 4) * channels), 1);
+
+    __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]);
+    __m256 t1 = _mm256_unpackhi_ps(r[0], r[1]);
+    __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]);
+    __m256 t3 = _mm256_unpackhi_ps(r[2], r[3]);
+
+    ch[0] = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    ch[1] = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    ch[2] = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    ch[3] = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+/* Loads channels [0-7] of 8 samples */
+VLC_AVX2
+static inline void load_8(__m256 *ch, const float *src, unsigned channels)
+{
+    load_4(ch, src, channels);
+    load_4(ch + 4, src + 4, channels);
+}
+
+#define K(x) _mm256_set1_ps(x)
+#define ADD _mm256_add_ps
+#define MUL _mm256_mul_ps
+
+VLC_AVX2
+static inline void store_2_0(float *dst, __m256 l, __m256 r)
+{
+    __m256 lo = _mm256_unpacklo_ps(l, r);
+    __m256 hi = _mm256_unpackhi_ps(l, r);
+
+    _mm256_storeu_ps(dst, _mm256_permute2f128_ps(lo, hi, 0x20));
+    _mm256_storeu_ps(dst + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+}
+
+VLC_AVX2
+static inline void store_4_0(float *dst, __m256 a, __m256 b, __m256 c,
+                             __m256 d)
+{
+    __m256 ab_lo = _mm256_unpacklo_ps(a, b), ab_hi = _mm256_unpackhi_ps(a, b);
+    __m256 cd_lo = _mm256_unpacklo_ps(c, d), cd_hi = _mm256_unpackhi_ps(c, d);
+    __m256 s04 = _mm256_shuffle_ps(ab_lo, cd_lo, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 s15 = _mm256_shuffle_ps(ab_lo, cd_lo, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 s26 = _mm256_shuffle_ps(ab_hi, cd_hi, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 s37 = _mm256_shuffle_ps(ab_hi, cd_hi, _MM_SHUFFLE(3, 2, 3, 2));
+
+    _mm256_storeu_ps(dst, _mm256_permute2f128_ps(s04, s15, 0x20));
+    _mm256_storeu_ps(dst + 8, _mm256_permute2f128_ps(s26, s37, 0x20));
+    _mm256_storeu_ps(dst + 16, _mm256_permute2f128_ps(s04, s15, 0x31));
+    _mm256_storeu_ps(dst + 24, _mm256_permute2f128_ps(s26, s37, 0x31));
+}
+
+VLC_AVX2
+void convert_7_x_to_2_0_avx2(float *dst, const float *src, int num,
+                             bool lfeChannel)
+{
+    const unsigned channels = 7 + lfeChannel;
+
+    for (; num > MIXER_SAMPLES; num -= MIXER_SAMPLES)
+    {
+        __m256 ch[8];
+
+        load_8(ch, src, channels);
+
+        __m256 ctr = MUL(ch[6], K(0.7071f));
+
+        store_2_0(dst, ADD(ADD(ADD(ctr, ch[0]), MUL(ch[2], K(.25f))),
+                           MUL(ch[4], K(.25f))),
+                       ADD(ADD(ADD(ctr, ch[1]), MUL(ch[3], K(.25f))),
+                           MUL(ch[5], K(.25f))));
+        src += MIXER_SAMPLES * channels;
+        dst += MIXER_SAMPLES * 2;
+    }
+
+    for (; num > 0; num--)
+    {
+        float ctr = src[6] * 0.7071f;
+        *dst++ = ctr + src[0] + src[2] / 4 + src[4] / 4;
+        *dst++ = ctr + src[1] + src[3] / 4 + src[5] / 4;
+        src += channels;
+    }
+}
+
+VLC_AVX2
+void convert_5_x_to_2_0_avx2(float *dst, const float *src, int num,
+                             bool lfeChannel)
+{
+    const unsigned channels = 5 + lfeChannel;
+
+    for (; num > MIXER_SAMPLES; num -= MIXER_SAMPLES)
+    {
+        __m256 ch[8];
+
+        load_8(ch, src, channels);
+
+        __m256 c = ch[4];
+
+        store_2_0(dst, ADD(ch[0], MUL(K(0.7071f), ADD(c, ch[2]))),
+                       ADD(ch[1], MUL(K(0.7071f), ADD(c, ch[3]))));
+        src += MIXER_SAMPLES * channels;
+        dst += MIXER_SAMPLES * 2;
+    }
+
+    for (; num > 0; num--)
+    {
+        *dst++ = src[0] + 0.7071f * (src[4] + src[2]);
+        *dst++ = src[1] + 0.7071f * (src[4] + src[3]);
+        src += channels;
+    }
+}
+
+VLC_AVX2
+void convert_4_0_to_2_0_avx2(float *dst, const float *src, int num,
+                             bool lfeChannel)
+{
+    VLC_UNUSED(lfeChannel);
+
+    for (; num > MIXER_SAMPLES; num -= MIXER_SAMPLES)
+    {
+        __m256 ch[4];
+
+        load_4(ch, src, 4);
+
+        __m256 rear = ADD(ch[2], ch[3]);
+
+        store_2_0(dst, ADD(rear, MUL(K(.5f), ch[0])),
+                       ADD(rear, MUL(K(.5f), ch[1])));
+        src += MIXER_SAMPLES * 4;
+        dst += MIXER_SAMPLES * 2;
+    }
+
+    for (; num > 0; num--)
+    {
+        *dst++ = src[2] + src[3] + 0.5f * src[0];
+        *dst++ = src[2] + src[3] + 0.5f * src[1];
+        src += 4;
+    }
+}
+
+VLC_AVX2
+void convert_3_x_to_2_0_avx2(float *dst, const float *src, int num,
+                             bool lfeChannel)
+{
+    const unsigned channels = 3 + lfeChannel;
+
+    for (; num > MIXER_SAMPLES; num -= MIXER_SAMPLES)
+    {
+        __m256 ch[4];
+
+        load_4(ch, src, channels);
+
+        __m256 c = ch[2];
+
+        store_2_0(dst, ADD(c, MUL(K(.5f), ch[0])),
+                       ADD(c, MUL(K(.5f), ch[1])));
+        src += MIXER_SAMPLES * channels;
+        dst += MIXER_SAMPLES * 2;
+    }
+
+    for (; num > 0; num--)
+    {
+        *dst++ = src[2] + 0.5f * src[0];
+        *dst++ = src[2] + 0.5f * src[1];
+        src += channels;
+    }
+}
+
+VLC_AVX2
+void convert_7_x_to_1_0_avx2(float *dst, const float *src, int num,
+                             bool lfeChannel)
+{
+    const unsigned channels = 7 + lfeChannel;
+
+    for (; num > MIXER_SAMPLES; num -= MIXER_SAMPLES)
+    {
+        __m256 ch[8];
+
+        load_8(ch, src, channels);
+
+        __m256 m = ADD(ch[6], MUL(ch[0], K(.25f)));
+
+        m = ADD(m, MUL(ch[1], K(.25f)));
+        m = ADD(m, MUL(ch[2], K(.125f)));
+        m = ADD(m, MUL(ch[3], K(.125f)));
+        m = ADD(m, MUL(ch[4], K(.125f)));
+        m = ADD(m, MUL(ch[5], K(.125f)));
+        _mm256_storeu_ps(dst, m);
+        src += MIXER_SAMPLES * channels;
+        dst += MIXER_SAMPLES;
+    }
+
+    for (; num > 0; num--)
+    {
+        *dst++ = src[6] + src[0] / 4 + src[1] / 4 + src[2] / 8 + src[3] / 8
+               + src[4] / 8 + src[5] / 8;
+        src += channels;
+    }
+}
+
+VLC_AVX2
+void convert_5_x_to_1_0_avx2(float *dst, const float *src, int num,
+                             bool lfeChannel)
+{
+    const unsigned channels = 5 + lfeChannel;
+
+    for (; num > MIXER_SAMPLES; num -= MIXER_SAMPLES)
+    {
+        __m256 ch[8];
+
+        load_8(ch, src, channels);
+
+        __m256 m = ADD(MUL(K(0.7071f), ADD(ch[0], ch[1])), ch[4]);
+
+        _mm256_storeu_ps(dst, ADD(m, MUL(K(.5f), ADD(ch[2], ch[3]))));
+        src += MIXER_SAMPLES * channels;
+        dst += MIXER_SAMPLES;
+    }
+
+    for (; num > 0; num--)
+    {
+        *dst++ = 0.7071f * (src[0] + src[1]) + src[4]
+               + 0.5f * (src[2] + src[3]);
+        src += channels;
+    }
+}
+
+VLC_AVX2
+void convert_7_x_to_4_0_avx2(float *dst, const float *src, int num,
+                             bool lfeChannel)
+{
+    const unsigned channels = 7 + lfeChannel;
+    const __m256 six = K(6.f);
+
+    for (; num > MIXER_SAMPLES; num -= MIXER_SAMPLES)
+    {
+        __m256 ch[8];
+
+        load_8(ch, src, channels);
+
+        __m256 c = ch[6];
+        __m256 sl = _mm256_div_ps(ch[2], six);
+        __m256 sr = _mm256_div_ps(ch[3], six);
+
+        store_4_0(dst, ADD(ADD(c, MUL(K(.5f), ch[0])), sl),
+                       ADD(ADD(c, MUL(K(.5f), ch[1])), sr),
+                       ADD(sl, ch[4]), ADD(sr, ch[5]));
+        src += MIXER_SAMPLES * channels;
+        dst += MIXER_SAMPLES * 4;
+    }
+
+    for (; num > 0; num--)
+    {
+        *dst++ = src[6] + 0.5f * src[0] + src[2] / 6;
+        *dst++ = src[6] + 0.5f * src[1] + src[3] / 6;
+        *dst++ = src[2] / 6 +  src[4];
+        *dst++ = src[3] / 6 +  src[5];
+        src += channels;
+    }
+}
+
+VLC_AVX2
+void convert_5_x_to_4_0_avx2(float *dst, const float *src, int num,
+                             bool lfeChannel)
+{
+    const unsigned channels = 5 + lfeChannel;
+
+    for (; num > MIXER_SAMPLES; num -= MIXER_SAMPLES)
+    {
+        __m256 ch[8];
+
+        load_8(ch, src, channels);
+
+        __m256 ctr = MUL(ch[4], K(0.7071f));
+
+        store_4_0(dst, ADD(ch[0], ctr), ADD(ch[1], ctr), ch[2], ch[3]);
+        src += MIXER_SAMPLES * channels;
+        dst += MIXER_SAMPLES * 4;
+    }
+
+    for (; num > 0; num--)
+    {
+        float ctr = src[4] * 0.7071f;
+        *dst++ = src[0] + ctr;
+        *dst++ = src[1] + ctr;
+        *dst++ = src[2];
+        *dst++ = src[3];
+        src += channels;
+    }
+}
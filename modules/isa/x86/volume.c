@@ -0,0 +1,107 @@
+/*****************************************************************************
+ * volume.c: x86 AVX2 audio volume
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <math.h>
+#include <stdint.h>
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_cpu.h>
+#include <vlc_aout.h>
+#include <vlc_aout_volume.h>
+#include "avx2.h"
+
+static void AmplifyFloat(audio_volume_t *volume, block_t *block, float amp)
+{
+    if (amp != 1.f)
+        amplify_f32_avx2(block->p_buffer, block->i_buffer, amp);
+
+    (void) volume;
+}
+
+static void AmplifyDouble(audio_volume_t *volume, block_t *block, float amp)
+{
+    if (amp != 1.f)
+        amplify_f64_avx2(block->p_buffer, block->i_buffer, amp);
+
+    (void) volume;
+}
+
+static void AmplifyShort(audio_volume_t *volume, block_t *block, float amp)
+{
+    int_fast32_t mult = lroundf(amp * 0x1.p8f);
+
+    if (mult == (1 << 8))
+        return;
+
+    if (likely(mult <= INT16_MAX))
+        amplify_s16_avx2(block->p_buffer, block->i_buffer, mult);
+    else
+    {   /* Very loud: the factor does not fit in the vector lanes */
+        int16_t *p = (int16_t *)block->p_buffer;
+
+        for (size_t n = block->i_buffer / sizeof (*p); n > 0; n--)
+        {
+            int_fast32_t s = (*p * mult) >> 8;
+            *(p++) = s > INT16_MAX ? INT16_MAX : s < INT16_MIN ? INT16_MIN : s;
+        }
+    }
+
+    (void) volume;
+}
+
+static int Probe(vlc_object_t *obj)
+{
+    audio_volume_t *volume = (audio_volume_t *)obj;
+
+    if (!vlc_CPU_AVX2())
+        return VLC_ENOTSUP;
+
+    switch (volume->format) {
+        case VLC_CODEC_FL32:
+            volume->amplify = AmplifyFloat;
+            break;
+
+        case VLC_CODEC_FL64:
+            volume->amplify = AmplifyDouble;
+            break;
+
+        case VLC_CODEC_S16N:
+            volume->amplify = AmplifyShort;
+            break;
+
+        default:
+            return VLC_ENOTSUP;
+    }
+
+    return VLC_SUCCESS;
+}
+
+vlc_module_begin()
+    set_subcategory(SUBCAT_AUDIO_AFILTER)
+    set_description("x86 AVX2 optimisation for audio volume")
+    set_capability("audio volume", 20)
+    set_callback(Probe)
+vlc_module_end()
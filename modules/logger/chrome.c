@@ -0,0 +1,313 @@
+/*****************************************************************************
+ * chrome.c: Chrome trace event format tracer plugin
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/*
+ * Writes the traces as a JSON array of trace events, which can be loaded in
+ * chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Each stream id (ES or output) is shown as a separate track. Stream traces
+ * with an "IN" and an "OUT" stage (e.g. DEC, FILTER, DISPLAY) become async
+ * slices keyed by the stream id and the PTS, so that the time spent by a
+ * given frame in each stage of the pipeline is visible. Other traces are
+ * shown as instant events, with all their values as arguments.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_fs.h>
+#include <vlc_charset.h>
+#include <vlc_tracer.h>
+#include <vlc_vector.h>
+
+#include <errno.h>
+#include <assert.h>
+
+#define CHROME_FILENAME "vlc-trace.json"
+
+struct chrome_track
+{
+    char *id;
+    /* Types (string literals) which emitted an "IN" stage on this track */
+    struct VLC_VECTOR(const char *) opened;
+};
+
+typedef struct
+{
+    FILE *stream;
+    vlc_mutex_t lock;
+    struct VLC_VECTOR(struct chrome_track) tracks;
+} vlc_tracer_sys_t;
+
+static void ChromePrintChars(FILE *stream, const char *str)
+{
+    for (; *str != '\0'; str++)
+    {
+        unsigned char byte = *str;
+
+        if (byte == '\"' || byte == '\\')
+            fprintf(stream, "\\%c", byte);
+        else if (byte <= 0x1F || byte == 0x7F)
+            fprintf(stream, "\\u%04x", byte);
+        else /* UTF-8 is valid in JSON strings */
+            fputc(byte, stream);
+    }
+}
+
+static void ChromePrintString(FILE *stream, const char *str)
+{
+    if (str == NULL || !IsUTF8(str))
+    {
+        fputs("\"invalid string\"", stream);
+        return;
+    }
+
+    fputc('\"', stream);
+    ChromePrintChars(stream, str);
+    fputc('\"', stream);
+}
+
+static size_t ChromeGetTrack(vlc_tracer_sys_t *sys, const char *id)
+{
+    for (size_t i = 0; i < sys->tracks.size; i++)
+        if (strcmp(sys->tracks.data[i].id, id) == 0)
+            return i;
+
+    struct chrome_track track = { .id = strdup(id) };
+    if (unlikely(track.id == NULL))
+        return SIZE_MAX;
+    vlc_vector_init(&track.opened);
+
+    if (!vlc_vector_push(&sys->tracks, track))
+    {
+        free(track.id);
+        return SIZE_MAX;
+    }
+
+    /* Name the track after the stream */
+    size_t i = sys->tracks.size - 1;
+    fprintf(sys->stream, ",\n{\"ph\":\"M\",\"name\":\"thread_name\","
+                         "\"pid\":1,\"tid\":%zu,\"args\":{\"name\":", i + 1);
+    ChromePrintString(sys->stream, id);
+    fputs("}}", sys->stream);
+    return i;
+}
+
+static bool ChromeTrackOpened(struct chrome_track *track, const char *type,
+                              bool open)
+{
+    const char *opened;
+
+    vlc_vector_foreach(opened, &track->opened)
+        if (strcmp(opened, type) == 0)
+            return true;
+
+    if (open)
+        vlc_vector_push(&track->opened, type);
+    return false;
+}
+
+static void ChromePrintArgs(FILE *stream, const struct vlc_tracer_entry *entry)
+{
+    bool first = true;
+
+    fputs("\"args\":{", stream);
+    for (; entry->key != NULL; entry++)
+    {
+        if (!first)
+            fputc(',', stream);
+        first = false;
+
+        ChromePrintString(stream, entry->key);
+        fputc(':', stream);
+        switch (entry->type)
+        {
+            case VLC_TRACER_INT:
+                fprintf(stream, "%"PRId64, entry->value.integer);
+                break;
+            case VLC_TRACER_DOUBLE:
+                vlc_fprintf_c(stream, "%.17g", entry->value.double_);
+                break;
+            case VLC_TRACER_STRING:
+                ChromePrintString(stream, entry->value.string);
+                break;
+            default:
+                vlc_assert_unreachable();
+        }
+    }
+    fputc('}', stream);
+}
+
+static void TraceChrome(void *opaque, vlc_tick_t ts,
+                        const struct vlc_tracer_trace *trace)
+{
+    vlc_tracer_sys_t *sys = opaque;
+    FILE *stream = sys->stream;
+    const char *type = NULL, *id = NULL, *stage = NULL, *event = NULL;
+    const struct vlc_tracer_entry *pts = NULL;
+
+    for (const struct vlc_tracer_entry *entry = trace->entries;
+         entry->key != NULL; entry++)
+    {
+        if (entry->type == VLC_TRACER_STRING)
+        {
+            if (strcmp(entry->key, "type") == 0)
+                type = entry->value.string;
+            else if (strcmp(entry->key, "id") == 0)
+                id = entry->value.string;
+            else if (strcmp(entry->key, "stream") == 0)
+                stage = entry->value.string;
+            else if (strcmp(entry->key, "event") == 0)
+                event = entry->value.string;
+        }
+        else if (entry->type == VLC_TRACER_INT
+              && strcmp(entry->key, "pts") == 0)
+            pts = entry;
+    }
+
+    if (type == NULL)
+        type = "trace";
+
+    vlc_mutex_lock(&sys->lock);
+
+    size_t tid = id != NULL ? ChromeGetTrack(sys, id) : SIZE_MAX;
+    char phase = 'i';
+
+    if (tid != SIZE_MAX && stage != NULL && pts != NULL)
+    {
+        struct chrome_track *track = &sys->tracks.data[tid];
+
+        if (strcmp(stage, "IN") == 0)
+        {
+            ChromeTrackOpened(track, type, true);
+            phase = 'b';
+        }
+        else if (strcmp(stage, "OUT") == 0
+              && ChromeTrackOpened(track, type, false))
+            phase = 'e';
+    }
+
+    fprintf(stream, ",\n{\"ph\":\"%c\",\"pid\":1,\"tid\":%zu,"
+                    "\"ts\":%"PRId64",\"cat\":", phase, tid + 1,
+            US_FROM_VLC_TICK(ts));
+    ChromePrintString(stream, type);
+    fputs(",\"name\":", stream);
+    if (phase == 'i')
+    {
+        /* Instant events get the most specific name available */
+        if (event != NULL)
+            ChromePrintString(stream, event);
+        else if (stage != NULL && IsUTF8(type) && IsUTF8(stage))
+        {
+            fputc('\"', stream);
+            ChromePrintChars(stream, type);
+            fputc(' ', stream);
+            ChromePrintChars(stream, stage);
+            fputc('\"', stream);
+        }
+        else
+            ChromePrintString(stream, type);
+        fputs(",\"s\":\"t\",", stream);
+    }
+    else
+    {
+        /* Async slices are matched by category, name and id */
+        ChromePrintString(stream, type);
+        fprintf(stream, ",\"id\":\"%zu/%"PRId64"\",", tid + 1,
+                pts->value.integer);
+    }
+    ChromePrintArgs(stream, trace->entries);
+    fputc('}', stream);
+
+    vlc_mutex_unlock(&sys->lock);
+}
+
+static void Close(void *opaque)
+{
+    vlc_tracer_sys_t *sys = opaque;
+    struct chrome_track *track;
+
+    fputs("\n]\n", sys->stream);
+    fclose(sys->stream);
+
+    vlc_vector_foreach_ref(track, &sys->tracks)
+    {
+        free(track->id);
+        vlc_vector_destroy(&track->opened);
+    }
+    vlc_vector_destroy(&sys->tracks);
+    free(sys);
+}
+
+static const struct vlc_tracer_operations chrome_ops =
+{
+    TraceChrome,
+    Close
+};
+
+static const struct vlc_tracer_operations *Open(vlc_object_t *obj,
+                                               void **restrict sysp)
+{
+    vlc_tracer_sys_t *sys = malloc(sizeof (*sys));
+    if (unlikely(sys == NULL))
+        return NULL;
+
+    char *path = var_InheritString(obj, "chrome-tracer-file");
+    const char *filename = path != NULL ? path : CHROME_FILENAME;
+
+    msg_Dbg(obj, "opening trace file `%s'", filename);
+    sys->stream = vlc_fopen(filename, "wt");
+    if (sys->stream == NULL)
+    {
+        msg_Err(obj, "error opening trace file `%s': %s", filename,
+                vlc_strerror_c(errno));
+        free(path);
+        free(sys);
+        return NULL;
+    }
+    free(path);
+
+    vlc_mutex_init(&sys->lock);
+    vlc_vector_init(&sys->tracks);
+
+    /* Every event is prefixed by a comma: start with a metadata event */
+    fputs("[\n{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":1,"
+          "\"args\":{\"name\":\"VLC\"}}", sys->stream);
+
+    *sysp = sys;
+    return &chrome_ops;
+}
+
+#define TRACEFILE_NAME_TEXT N_("Trace filename")
+#define TRACEFILE_NAME_LONGTEXT N_("Specify the trace filename.")
+
+vlc_module_begin()
+    set_shortname(N_("Chrome tracer"))
+    set_description(N_("Chrome trace event format tracer"))
+    set_subcategory(SUBCAT_ADVANCED_MISC)
+    set_capability("tracer", 0)
+    set_callback(Open)
+
+    add_savefile("chrome-tracer-file", NULL, TRACEFILE_NAME_TEXT,
+                 TRACEFILE_NAME_LONGTEXT)
+vlc_module_end()
@@ -34,10 +34,20 @@
 #ifdef HAVE_DVBCSA
 # include <dvbcsa/dvbcsa.h>
 
+/* Payload bytes after the smallest TS header, a multiple of 8 as required
+ * by the bit-sliced cipher */
+#define CSA_PAYLOAD_MAX 184
+
 struct csa_t
 {
     bool    use_odd;
     struct dvbcsa_key_s *keys[2];
+
+    /* Bit-sliced keys, and the packets queued for them */
+    struct dvbcsa_bs_key_s *bs_keys[2];
+    struct dvbcsa_bs_batch_s *batches[2];
+    unsigned i_batch[2];
+    unsigned i_batch_size;
 };
 
 /*****************************************************************************
@@ -46,18 +56,25 @@ struct csa_t
 csa_t *csa_New( void )
 {
     csa_t *csa = calloc( 1, sizeof( csa_t ) );
-    if(csa)
+    if( !csa )
+        return NULL;
+
+    csa->i_batch_size = dvbcsa_bs_batch_size();
+
+    for( int i = 0; i < 2; i++ )
     {
-        csa->keys[0] = dvbcsa_key_alloc();
-        if(csa->keys[0])
-            csa->keys[1] = dvbcsa_key_alloc();
-        if(csa->keys[1])
-            return csa;
-        else
-            dvbcsa_key_free(csa->keys[0]);
+        csa->keys[i] = dvbcsa_key_alloc();
+        csa->bs_keys[i] = dvbcsa_bs_key_alloc();
+        /* NULL terminated */
+        csa->batches[i] = vlc_alloc( csa->i_batch_size + 1,
+                                     sizeof( *csa->batches[i] ) );
+        if( !csa->keys[i] || !csa->bs_keys[i] || !csa->batches[i] )
+        {
+            csa_Delete( csa );
+            return NULL;
+        }
     }
-    free(csa);
-    return NULL;
+    return csa;
 }
 
 /*****************************************************************************
@@ -65,8 +82,14 @@ csa_t *csa_New( void )
  *****************************************************************************/
 void csa_Delete( csa_t *c )
 {
-    dvbcsa_key_free( c->keys[0] );
-    dvbcsa_key_free( c->keys[1] );
+    for( int i = 0; i < 2; i++ )
+    {
+        if( c->keys[i] )
+            dvbcsa_key_free( c->keys[i] );
+        if( c->bs_keys[i] )
+            dvbcsa_bs_key_free( c->bs_keys[i] );
+        free( c->batches[i] );
+    }
     free( c );
 }
 
@@ -104,6 +127,7 @@ int csa_SetCW( vlc_object_t *p_caller, csa_t *c, char *psz_ck, bool set_odd )
 # endif
 
         dvbcsa_key_set( ck, c->keys[set_odd ? 1 : 0] );
+        dvbcsa_bs_key_set( ck, c->bs_keys[set_odd ? 1 : 0] );
 
         return VLC_SUCCESS;
     }
@@ -123,79 +147,141 @@ void csa_UseKey( vlc_object_t *p_caller, csa_t *c, bool use_odd )
 }
 
 /*****************************************************************************
- * csa_Decrypt:
+ * csa_Flush: processes the packets queued for one key
  *****************************************************************************/
-void csa_Decrypt( csa_t *c, uint8_t *pkt, int i_pkt_size )
+static void csa_Flush( csa_t *c, int i_key, bool b_encrypt )
 {
-    struct dvbcsa_key_s *key;
+    struct dvbcsa_bs_batch_s *batch = c->batches[i_key];
+    const unsigned n = c->i_batch[i_key];
 
-    int     i_hdr;
+    if( n == 0 )
+        return;
+    c->i_batch[i_key] = 0;
 
-    /* transport scrambling control */
-    if( (pkt[3]&0x80) == 0 )
+    /* The bit-sliced cipher costs the same whatever the batch fill, a few
+     * packets are faster one at a time */
+    if( n < __MAX(c->i_batch_size / 8, 2) )
     {
-        /* not scrambled */
+        for( unsigned i = 0; i < n; i++ )
+        {
+            if( b_encrypt )
+                dvbcsa_encrypt( c->keys[i_key], batch[i].data, batch[i].len );
+            else
+                dvbcsa_decrypt( c->keys[i_key], batch[i].data, batch[i].len );
+        }
         return;
     }
-    if( pkt[3]&0x40 )
-        key = c->keys[1];
+
+    batch[n].data = NULL;
+    if( b_encrypt )
+        dvbcsa_bs_encrypt( c->bs_keys[i_key], batch, CSA_PAYLOAD_MAX );
     else
-        key = c->keys[0];
+        dvbcsa_bs_decrypt( c->bs_keys[i_key], batch, CSA_PAYLOAD_MAX );
+}
+
+static void csa_Queue( csa_t *c, int i_key, bool b_encrypt,
+                       uint8_t *p_data, int i_data )
+{
+    struct dvbcsa_bs_batch_s *entry = &c->batches[i_key][c->i_batch[i_key]];
 
-    /* clear transport scrambling control */
-    pkt[3] &= 0x3f;
+    entry->data = p_data;
+    entry->len = i_data;
+    if( ++c->i_batch[i_key] == c->i_batch_size )
+        csa_Flush( c, i_key, b_encrypt );
+}
 
-    i_hdr = 4;
-    if( pkt[3]&0x20 )
+/*****************************************************************************
+ * csa_DecryptBatch:
+ *****************************************************************************/
+void csa_DecryptBatch( csa_t *c, uint8_t *const *pp_pkts, size_t i_count,
+                       int i_pkt_size )
+{
+    for( size_t i = 0; i < i_count; i++ )
     {
-        /* skip adaption field */
-        i_hdr += pkt[4] + 1;
-    }
+        uint8_t *pkt = pp_pkts[i];
+        int     i_key;
+        int     i_hdr;
 
-    if( 188 - i_hdr < 8 )
-        return;
+        /* transport scrambling control */
+        if( (pkt[3]&0x80) == 0 )
+        {
+            /* not scrambled */
+            continue;
+        }
+        i_key = (pkt[3]&0x40) ? 1 : 0;
 
-    dvbcsa_decrypt( key, &pkt[i_hdr], i_pkt_size - i_hdr );
+        /* clear transport scrambling control */
+        pkt[3] &= 0x3f;
+
+        i_hdr = 4;
+        if( pkt[3]&0x20 )
+        {
+            /* skip adaption field */
+            i_hdr += pkt[4] + 1;
+        }
+
+        if( i_pkt_size - i_hdr < 8 )
+            continue;
+
+        csa_Queue( c, i_key, false, &pkt[i_hdr], i_pkt_size - i_hdr );
+    }
+
+    csa_Flush( c, 0, false );
+    csa_Flush( c, 1, false );
 }
 
 /*****************************************************************************
- * csa_Encrypt:
+ * csa_EncryptBatch:
  *****************************************************************************/
-void csa_Encrypt( csa_t *c, uint8_t *pkt, int i_pkt_size )
+void csa_EncryptBatch( csa_t *c, uint8_t *const *pp_pkts, size_t i_count,
+                       int i_pkt_size )
 {
-    int i_hdr = 4; /* hdr len */
-    int n;
+    const int i_key = c->use_odd ? 1 : 0;
 
-    /* set transport scrambling control */
-    pkt[3] |= 0x80;
-
-    struct dvbcsa_key_s *key;
-    if( c->use_odd )
-    {
-        pkt[3] |= 0x40;
-        key = c->keys[1];
-    }
-    else
+    for( size_t i = 0; i < i_count; i++ )
     {
-        key = c->keys[0];
-    }
+        uint8_t *pkt = pp_pkts[i];
+        int     i_hdr;
 
-    /* hdr len */
-    i_hdr = 4;
-    if( pkt[3]&0x20 )
-    {
-        /* skip adaption field */
-        i_hdr += pkt[4] + 1;
-    }
-    n = (i_pkt_size - i_hdr) / 8;
+        /* set transport scrambling control */
+        pkt[3] |= 0x80;
+        if( c->use_odd )
+            pkt[3] |= 0x40;
 
-    if( n <= 0 )
-    {
-        pkt[3] &= 0x3f;
-        return;
+        /* hdr len */
+        i_hdr = 4;
+        if( pkt[3]&0x20 )
+        {
+            /* skip adaption field */
+            i_hdr += pkt[4] + 1;
+        }
+
+        if( (i_pkt_size - i_hdr) / 8 <= 0 )
+        {
+            pkt[3] &= 0x3f;
+            continue;
+        }
+
+        csa_Queue( c, i_key, true, &pkt[i_hdr], i_pkt_size - i_hdr );
     }
 
-    dvbcsa_encrypt(key, &pkt[i_hdr], i_pkt_size - i_hdr);
+    csa_Flush( c, i_key, true );
+}
+
+/*****************************************************************************
+ * csa_Decrypt:
+ *****************************************************************************/
+void csa_Decrypt( csa_t *c, uint8_t *pkt, int i_pkt_size )
+{
+    csa_DecryptBatch( c, &pkt, 1, i_pkt_size );
+}
+
+/*****************************************************************************
+ * csa_Encrypt:
+ *****************************************************************************/
+void csa_Encrypt( csa_t *c, uint8_t *pkt, int i_pkt_size )
+{
+    csa_EncryptBatch( c, &pkt, 1, i_pkt_size );
 }
 #else
 
@@ -239,4 +325,22 @@ void csa_Encrypt( csa_t *c, uint8_t *pkt, int i_pkt_size )
     VLC_UNUSED(i_pkt_size);
 }
 
+void csa_DecryptBatch( csa_t *c, uint8_t *const *pp_pkts, size_t i_count,
+                       int i_pkt_size )
+{
+    VLC_UNUSED(c);
+    VLC_UNUSED(pp_pkts);
+    VLC_UNUSED(i_count);
+    VLC_UNUSED(i_pkt_size);
+}
+
+void csa_EncryptBatch( csa_t *c, uint8_t *const *pp_pkts, size_t i_count,
+                       int i_pkt_size )
+{
+    VLC_UNUSED(c);
+    VLC_UNUSED(pp_pkts);
+    VLC_UNUSED(i_count);
+    VLC_UNUSED(i_pkt_size);
+}
+
 #endif
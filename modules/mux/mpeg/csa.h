@@ -34,4 +34,11 @@ void   csa_UseKey( vlc_object_t *p_caller, csa_t *, bool use_odd );
 void   csa_Decrypt( csa_t *, uint8_t *pkt, int i_pkt_size );
 void   csa_Encrypt( csa_t *, uint8_t *pkt, int i_pkt_size );
 
+/* Process many packets at once, using the bit-sliced cipher for packets
+ * sharing the same key */
+void   csa_DecryptBatch( csa_t *, uint8_t *const *pp_pkts, size_t i_count,
+                         int i_pkt_size );
+void   csa_EncryptBatch( csa_t *, uint8_t *const *pp_pkts, size_t i_count,
+                         int i_pkt_size );
+
 #endif /* _CSA_H */
@@ -186,6 +186,7 @@ static const char *const ts_standards_list_text[] =
 #define SOUT_CFG_PREFIX "sout-ts-"
 #define MAX_PMT 64       /* Maximum number of programs. FIXME: I just chose an arbitrary number. Where is the maximum in the spec? */
 #define MAX_PMT_PID 64       /* Maximum pids in each pmt.  FIXME: I just chose an arbitrary number. Where is the maximum in the spec? */
+#define TS_CSA_BATCH 256     /* Packets scrambled at once */
 
 static_assert (MAX_SDT_DESC >= MAX_PMT, "MAX_SDT_DESC < MAX_PMT");
 
@@ -1717,6 +1718,14 @@ static int TSSchedule( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
     return VLC_SUCCESS;
 }
 
+static void TSScramble( sout_mux_sys_t *p_sys, uint8_t *const *pp_pkts,
+                        size_t i_count )
+{
+    vlc_mutex_lock( &p_sys->csa_lock );
+    csa_EncryptBatch( p_sys->csa, pp_pkts, i_count, p_sys->i_csa_pkt_size );
+    vlc_mutex_unlock( &p_sys->csa_lock );
+}
+
 static int TSDate( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
                    vlc_tick_t i_pcr_length, vlc_tick_t i_pcr_dts )
 {
@@ -1733,6 +1742,8 @@ static int TSDate( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
     /* msg_Dbg( p_mux, "real pck=%d", i_packet_count ); */
     block_t *p_list = NULL;
     block_t **pp_last = &p_list;
+    uint8_t *pp_csa[TS_CSA_BATCH];
+    size_t i_csa = 0;
     for (int i = 0; i < i_packet_count; i++ )
     {
         block_t *p_ts = BufferChainGet( p_chain_ts );
@@ -1748,9 +1759,13 @@ static int TSDate( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
         }
         if( p_ts->i_flags & BLOCK_FLAG_SCRAMBLED )
         {
-            vlc_mutex_lock( &p_sys->csa_lock );
-            csa_Encrypt( p_sys->csa, p_ts->p_buffer, p_sys->i_csa_pkt_size );
-            vlc_mutex_unlock( &p_sys->csa_lock );
+            /* Scramble in batches, the cipher is much faster that way */
+            pp_csa[i_csa++] = p_ts->p_buffer;
+            if( i_csa == TS_CSA_BATCH )
+            {
+                TSScramble( p_sys, pp_csa, i_csa );
+                i_csa = 0;
+            }
         }
 
         /* latency */
@@ -1758,6 +1773,8 @@ static int TSDate( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
 
         block_ChainLastAppend( &pp_last, p_ts );
     }
+    if( i_csa > 0 )
+        TSScramble( p_sys, pp_csa, i_csa );
     ssize_t written = 0;
     if ( p_list != NULL )
         written = sout_AccessOutWrite( p_mux->p_access, p_list );
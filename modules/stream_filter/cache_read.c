@@ -495,6 +495,11 @@ static int Open(vlc_object_t *obj)
     if (s->s->pf_read == NULL && s->s->pf_block == NULL)
         return VLC_EGENERIC;
 
+    /* Blocks from a fast-seekable source, e.g. a memory-mapped file, are
+     * consumed in place; caching would only add a copy. */
+    if (s->s->pf_block != NULL && vlc_stream_CanFastSeek(s->s))
+        return VLC_EGENERIC;
+
     stream_sys_t *sys = malloc(sizeof (*sys));
     if (unlikely(sys == NULL))
         return VLC_ENOMEM;
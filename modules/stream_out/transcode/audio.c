@@ -183,9 +183,12 @@ int transcode_audio_init( sout_stream_t *p_stream, const es_format_t *p_fmt,
 
     vlc_mutex_unlock(&id->fifo.lock);
 
-    id->encoder = transcode_encoder_new( sout_EncoderCreate(p_stream, sizeof(encoder_t)), &encoder_tested_fmt_in );
+    encoder_t *p_encoder = sout_EncoderCreate( p_stream, sizeof(encoder_t) );
+    id->encoder = transcode_encoder_new( p_encoder, &encoder_tested_fmt_in );
     if( !id->encoder )
     {
+        if( p_encoder )
+            vlc_object_delete( p_encoder );
         module_unneed( id->p_decoder, id->p_decoder->p_module );
         id->p_decoder->p_module = NULL;
         es_format_Clean( &id->decoder_out );
@@ -334,7 +337,6 @@ int transcode_audio_process( sout_stream_t *p_stream,
 
             block_t *p_block = transcode_encoder_encode( id->encoder, p_audio_buf );
             block_ChainAppend( out, p_block );
-            block_Release( p_audio_buf );
         }
         continue;
 error:
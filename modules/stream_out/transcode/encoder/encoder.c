@@ -21,10 +21,12 @@
 #endif
 
 #include <vlc_common.h>
+#include <vlc_threads.h>
 #include <vlc_configuration.h>
 #include <vlc_modules.h>
 #include <vlc_codec.h>
-#include <vlc_picture_fifo.h>
+#include <vlc_picture.h>
+#include <vlc_subpicture.h>
 #include <vlc_aout.h>
 #include <vlc_sout.h>
 
@@ -43,16 +45,186 @@ void transcode_encoder_config_clean( transcode_encoder_config_t *p_cfg )
     config_ChainDestroy( p_cfg->p_config_chain );
 }
 
+static block_t * transcode_encoder_encode_inline( transcode_encoder_t *p_enc,
+                                                  void *in )
+{
+    switch( p_enc->p_encoder->fmt_in.i_cat )
+    {
+        case VIDEO_ES:
+            return transcode_encoder_video_encode( p_enc, in );
+        case AUDIO_ES:
+            return transcode_encoder_audio_encode( p_enc, in );
+        case SPU_ES:
+            return transcode_encoder_spu_encode( p_enc, in );
+        default:
+            vlc_assert_unreachable();
+            return NULL;
+    }
+}
+
+static void transcode_encoder_release_input( transcode_encoder_t *p_enc,
+                                             void *in )
+{
+    if( in == NULL )
+        return;
+
+    switch( p_enc->p_encoder->fmt_in.i_cat )
+    {
+        case VIDEO_ES:
+            picture_Release( in );
+            break;
+        case AUDIO_ES:
+            block_Release( in );
+            break;
+        case SPU_ES:
+            subpicture_Delete( in );
+            break;
+        default:
+            vlc_assert_unreachable();
+    }
+}
+
+static void* EncoderThread( void *obj )
+{
+    transcode_encoder_t *p_enc = obj;
+
+    switch( p_enc->p_encoder->fmt_in.i_cat )
+    {
+        case VIDEO_ES:
+            vlc_thread_set_name("vlc-encoder");
+            break;
+        case AUDIO_ES:
+            vlc_thread_set_name("vlc-aencoder");
+            break;
+        default:
+            vlc_thread_set_name("vlc-sencoder");
+            break;
+    }
+
+    int canc = vlc_savecancel ();
+
+    vlc_mutex_lock( &p_enc->lock_out );
+
+    for( ;; )
+    {
+        while( !p_enc->b_abort && p_enc->i_in_count == 0 )
+            vlc_cond_wait( &p_enc->cond, &p_enc->lock_out );
+
+        /* Encode what we have in the queue on closing */
+        if( p_enc->i_in_count == 0 )
+            break;
+
+        void *in = p_enc->pp_in[p_enc->i_in_first];
+        p_enc->i_in_first = (p_enc->i_in_first + 1) % p_enc->i_in_size;
+        p_enc->i_in_count--;
+        vlc_sem_post( &p_enc->in_has_room );
+
+        /* release lock while encoding */
+        vlc_mutex_unlock( &p_enc->lock_out );
+        vlc_tick_t i_start = vlc_tick_now();
+        block_t *p_block = transcode_encoder_encode_inline( p_enc, in );
+        vlc_tick_t i_time = vlc_tick_now() - i_start;
+        transcode_encoder_release_input( p_enc, in );
+        vlc_mutex_lock( &p_enc->lock_out );
+
+        block_ChainAppend( &p_enc->p_buffers, p_block );
+        p_enc->stats.i_encoded++;
+        p_enc->stats.i_encode_time += i_time;
+        if( i_time > p_enc->stats.i_encode_time_max )
+            p_enc->stats.i_encode_time_max = i_time;
+    }
+
+    vlc_mutex_unlock( &p_enc->lock_out );
+
+    /*Now flush encoder*/
+    if( p_enc->p_encoder->fmt_in.i_cat != SPU_ES )
+    {
+        block_t *p_block;
+        do {
+            p_block = transcode_encoder_encode_inline( p_enc, NULL );
+            vlc_mutex_lock( &p_enc->lock_out );
+            block_ChainAppend( &p_enc->p_buffers, p_block );
+            vlc_mutex_unlock( &p_enc->lock_out );
+        } while( p_block );
+    }
+
+    vlc_restorecancel (canc);
+
+    return NULL;
+}
+
+static int transcode_encoder_thread_start( transcode_encoder_t *p_enc,
+                                           const transcode_encoder_config_t *p_cfg )
+{
+    free( p_enc->pp_in );
+    p_enc->i_in_size = p_cfg->threads.pool_size;
+    p_enc->pp_in = vlc_alloc( p_enc->i_in_size, sizeof(*p_enc->pp_in) );
+    if( unlikely(p_enc->pp_in == NULL) )
+        return VLC_ENOMEM;
+    p_enc->i_in_first = 0;
+    p_enc->i_in_count = 0;
+
+    vlc_sem_init( &p_enc->in_has_room, p_enc->i_in_size );
+    p_enc->b_abort = false;
+    memset( &p_enc->stats, 0, sizeof(p_enc->stats) );
+
+    if( vlc_clone( &p_enc->thread, EncoderThread, p_enc ) )
+    {
+        free( p_enc->pp_in );
+        p_enc->pp_in = NULL;
+        return VLC_EGENERIC;
+    }
+    p_enc->b_threaded = true;
+    return VLC_SUCCESS;
+}
+
+/* Encodes the queued inputs, flushes the encoder then joins its thread.
+ * The output stays available through transcode_encoder_get_output_async() */
+static void transcode_encoder_thread_stop( transcode_encoder_t *p_enc )
+{
+    if( !p_enc->b_threaded || p_enc->b_abort )
+        return;
+
+    vlc_mutex_lock( &p_enc->lock_out );
+    p_enc->b_abort = true;
+    vlc_cond_signal( &p_enc->cond );
+    vlc_mutex_unlock( &p_enc->lock_out );
+    vlc_join( p_enc->thread, NULL );
+
+    if( p_enc->stats.i_encoded > 0 )
+        msg_Dbg( p_enc->p_encoder, "encoded %"PRIu64" frames on thread: "
+                 "%"PRId64" us average, %"PRId64" us max, "
+                 "queue depth %.1f average, %zu/%zu max",
+                 p_enc->stats.i_encoded,
+                 p_enc->stats.i_encode_time / (vlc_tick_t)p_enc->stats.i_encoded,
+                 p_enc->stats.i_encode_time_max,
+                 (double)p_enc->stats.i_queue_depth_sum / p_enc->stats.i_encoded,
+                 p_enc->stats.i_queue_depth_max, p_enc->i_in_size );
+}
+
+/* Queues an input for the encoder thread, waiting for room if needed */
+static void transcode_encoder_thread_push( transcode_encoder_t *p_enc,
+                                           void *in )
+{
+    vlc_sem_wait( &p_enc->in_has_room );
+    vlc_mutex_lock( &p_enc->lock_out );
+    size_t i_last = (p_enc->i_in_first + p_enc->i_in_count) % p_enc->i_in_size;
+    p_enc->pp_in[i_last] = in;
+    p_enc->i_in_count++;
+    p_enc->stats.i_queue_depth_sum += p_enc->i_in_count;
+    if( p_enc->i_in_count > p_enc->stats.i_queue_depth_max )
+        p_enc->stats.i_queue_depth_max = p_enc->i_in_count;
+    vlc_cond_signal( &p_enc->cond );
+    vlc_mutex_unlock( &p_enc->lock_out );
+}
+
 void transcode_encoder_delete( transcode_encoder_t *p_enc )
 {
     if( p_enc->p_encoder )
     {
-        if( p_enc->p_encoder->fmt_in.i_cat == VIDEO_ES )
-        {
-            transcode_encoder_video_stop( p_enc );
-            block_ChainRelease( p_enc->p_buffers );
-            picture_fifo_Delete( p_enc->pp_pics );
-        }
+        transcode_encoder_thread_stop( p_enc );
+        block_ChainRelease( p_enc->p_buffers );
+        free( p_enc->pp_in );
 
         vlc_encoder_Destroy( p_enc->p_encoder );
     }
@@ -75,12 +247,10 @@ transcode_encoder_t * transcode_encoder_new( encoder_t *p_encoder,
             return NULL;
     }
 
+    /* On failure, the caller keeps the encoder object */
     transcode_encoder_t *p_enc = calloc( 1, sizeof(*p_enc) );
     if( !p_enc )
-    {
-        vlc_object_delete(p_encoder);
         return NULL;
-    }
 
     p_enc->p_encoder = p_encoder;
     p_enc->p_encoder->p_module = NULL;
@@ -94,23 +264,8 @@ transcode_encoder_t * transcode_encoder_new( encoder_t *p_encoder,
     if( p_enc->p_encoder->fmt_in.psz_language )
         p_enc->p_encoder->fmt_out.psz_language = strdup( p_enc->p_encoder->fmt_in.psz_language );
 
-    switch( p_fmt->i_cat )
-    {
-        case VIDEO_ES:
-            p_enc->pp_pics = picture_fifo_New();
-            if( !p_enc->pp_pics )
-            {
-                es_format_Clean( &p_enc->p_encoder->fmt_in );
-                es_format_Clean( &p_enc->p_encoder->fmt_out );
-                vlc_object_delete(p_enc->p_encoder);
-                free( p_enc );
-                return NULL;
-            }
-            vlc_mutex_init( &p_enc->lock_out );
-            break;
-        default:
-            break;
-    }
+    vlc_mutex_init( &p_enc->lock_out );
+    vlc_cond_init( &p_enc->cond );
 
     return p_enc;
 }
@@ -156,18 +311,15 @@ bool transcode_encoder_opened( const transcode_encoder_t *p_enc )
 
 block_t * transcode_encoder_encode( transcode_encoder_t *p_enc, void *in )
 {
-    switch( p_enc->p_encoder->fmt_in.i_cat )
+    if( p_enc->b_threaded && !p_enc->b_abort )
     {
-        case VIDEO_ES:
-            return transcode_encoder_video_encode( p_enc, in );
-        case AUDIO_ES:
-            return transcode_encoder_audio_encode( p_enc, in );
-        case SPU_ES:
-            return transcode_encoder_spu_encode( p_enc, in );
-        default:
-            vlc_assert_unreachable();
-            return NULL;
+        transcode_encoder_thread_push( p_enc, in );
+        return transcode_encoder_get_output_async( p_enc );
     }
+
+    block_t *p_block = transcode_encoder_encode_inline( p_enc, in );
+    transcode_encoder_release_input( p_enc, in );
+    return p_block;
 }
 
 block_t * transcode_encoder_get_output_async( transcode_encoder_t *p_enc )
@@ -184,8 +336,7 @@ void transcode_encoder_close( transcode_encoder_t *p_enc )
     if( !p_enc->p_encoder->p_module )
         return;
 
-    if( p_enc->p_encoder->fmt_in.i_cat == VIDEO_ES )
-        transcode_encoder_video_stop( p_enc );
+    transcode_encoder_thread_stop( p_enc );
 
     if( p_enc->p_encoder->ops != NULL && p_enc->p_encoder->ops->close != NULL )
     {
@@ -202,17 +353,32 @@ void transcode_encoder_close( transcode_encoder_t *p_enc )
 int transcode_encoder_open( transcode_encoder_t *p_enc,
                             const transcode_encoder_config_t *p_cfg )
 {
+    int i_ret;
+
     switch( p_enc->p_encoder->fmt_in.i_cat )
     {
         case SPU_ES:
-            return transcode_encoder_spu_open( p_enc, p_cfg );
+            i_ret = transcode_encoder_spu_open( p_enc, p_cfg );
+            break;
         case AUDIO_ES:
-            return transcode_encoder_audio_open( p_enc, p_cfg );
+            i_ret = transcode_encoder_audio_open( p_enc, p_cfg );
+            break;
         case VIDEO_ES:
-            return transcode_encoder_video_open( p_enc, p_cfg );
+            i_ret = transcode_encoder_video_open( p_enc, p_cfg );
+            break;
         default:
             return VLC_EGENERIC;
     }
+
+    if( i_ret != VLC_SUCCESS || p_cfg->threads.i_count == 0 )
+        return i_ret;
+
+    /* Each ES gets its own encoder thread, fed through a bounded queue so
+     * that a slow encoder does not stall the other ones */
+    i_ret = transcode_encoder_thread_start( p_enc, p_cfg );
+    if( i_ret != VLC_SUCCESS )
+        transcode_encoder_close( p_enc );
+    return i_ret;
 }
 
 int transcode_encoder_drain( transcode_encoder_t *p_enc, block_t **out )
@@ -220,6 +386,13 @@ int transcode_encoder_drain( transcode_encoder_t *p_enc, block_t **out )
     if( !transcode_encoder_opened( p_enc ) )
         return VLC_EGENERIC;
 
+    if( p_enc->b_threaded )
+    {
+        transcode_encoder_thread_stop( p_enc );
+        block_ChainAppend( out, transcode_encoder_get_output_async( p_enc ) );
+        return VLC_SUCCESS;
+    }
+
     switch( p_enc->p_encoder->fmt_in.i_cat )
     {
         case VIDEO_ES:
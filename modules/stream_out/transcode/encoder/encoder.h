@@ -29,6 +29,11 @@ typedef struct
     char         *psz_name;
     char         *psz_lang;
     config_chain_t *p_config_chain;
+    struct
+    {
+        unsigned int i_count; /* encoder threads, 0 to encode inline */
+        uint32_t     pool_size; /* maximum number of queued inputs */
+    } threads;
     union
     {
         struct
@@ -39,11 +44,8 @@ typedef struct
             unsigned int    i_height, i_maxheight;
             bool            b_hurry_up;
             vlc_rational_t  fps;
-            struct
-            {
-                unsigned int i_count;
-                uint32_t     pool_size;
-            } threads;
+            unsigned int    i_segments; /* segments encoded concurrently */
+            unsigned int    i_segment_length; /* in pictures */
         } video;
         struct
         {
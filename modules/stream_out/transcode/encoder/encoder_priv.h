@@ -16,21 +16,32 @@
  * You should have received a copy of the GNU Lesser General Public License
  * along with this program; if not, If not, see https://www.gnu.org/licenses/
  *****************************************************************************/
-#include <vlc_picture_fifo.h>
-
 struct transcode_encoder_t
 {
     encoder_t       *p_encoder;
     vlc_thread_t    thread;
     vlc_mutex_t     lock_out;
     bool            b_abort;
-    picture_fifo_t *pp_pics;
-    vlc_sem_t       picture_pool_has_room;
+    void          **pp_in; /* ring of threads.pool_size queued inputs */
+    size_t          i_in_first;
+    size_t          i_in_count;
+    size_t          i_in_size;
+    vlc_sem_t       in_has_room;
     vlc_cond_t      cond;
 
     /* output buffers */
     block_t         *p_buffers;
     bool b_threaded;
+
+    /* thread statistics, protected by lock_out */
+    struct
+    {
+        uint64_t    i_encoded;
+        vlc_tick_t  i_encode_time;
+        vlc_tick_t  i_encode_time_max;
+        uint64_t    i_queue_depth_sum; /* sampled on each input */
+        size_t      i_queue_depth_max;
+    } stats;
 };
 
 int transcode_encoder_audio_open( transcode_encoder_t *p_enc,
@@ -40,8 +51,6 @@ int transcode_encoder_video_open( transcode_encoder_t *p_enc,
 int transcode_encoder_spu_open( transcode_encoder_t *p_enc,
                                 const transcode_encoder_config_t *p_cfg );
 
-void transcode_encoder_video_stop( transcode_encoder_t *p_enc );
-
 block_t * transcode_encoder_video_encode( transcode_encoder_t *p_enc, picture_t *p_pic );
 block_t * transcode_encoder_audio_encode( transcode_encoder_t *p_enc, block_t *p_block );
 block_t * transcode_encoder_spu_encode( transcode_encoder_t *p_enc, subpicture_t *p_spu );
@@ -28,7 +28,6 @@
 #endif
 
 #include <vlc_common.h>
-#include <vlc_threads.h>
 #include <vlc_modules.h>
 #include <vlc_codec.h>
 #include <vlc_sout.h>
@@ -292,102 +291,20 @@ void transcode_encoder_video_configure( vlc_object_t *p_obj,
              (const char *)&p_enc_in->i_chroma);
 }
 
-static void* EncoderThread( void *obj )
+int transcode_encoder_video_drain( transcode_encoder_t *p_enc, block_t **out )
 {
-    vlc_thread_set_name("vlc-encoder");
-
-    transcode_encoder_t *p_enc = obj;
-    picture_t *p_pic = NULL;
-    int canc = vlc_savecancel ();
-    block_t *p_block = NULL;
-
-    vlc_mutex_lock( &p_enc->lock_out );
-
-    for( ;; )
-    {
-        while( !p_enc->b_abort &&
-               (p_pic = picture_fifo_Pop( p_enc->pp_pics )) == NULL )
-            vlc_cond_wait( &p_enc->cond, &p_enc->lock_out );
-        vlc_sem_post( &p_enc->picture_pool_has_room );
-
-        if( p_pic )
-        {
-            /* release lock while encoding */
-            vlc_mutex_unlock( &p_enc->lock_out );
-            p_block = vlc_encoder_EncodeVideo( p_enc->p_encoder, p_pic );
-            picture_Release( p_pic );
-            vlc_mutex_lock( &p_enc->lock_out );
-
-            block_ChainAppend( &p_enc->p_buffers, p_block );
-        }
-
-        if( p_enc->b_abort )
-            break;
-    }
-
-    /*Encode what we have in the buffer on closing*/
-    while( (p_pic = picture_fifo_Pop( p_enc->pp_pics )) != NULL )
-    {
-        vlc_sem_post( &p_enc->picture_pool_has_room );
-        p_block = vlc_encoder_EncodeVideo( p_enc->p_encoder, p_pic );
-        picture_Release( p_pic );
-        block_ChainAppend( &p_enc->p_buffers, p_block );
-    }
-
-    /*Now flush encoder*/
+    block_t *p_block;
     do {
-        p_block = vlc_encoder_EncodeVideo(p_enc->p_encoder, NULL );
-        block_ChainAppend( &p_enc->p_buffers, p_block );
+        p_block = transcode_encoder_video_encode( p_enc, NULL );
+        block_ChainAppend( out, p_block );
     } while( p_block );
-
-    vlc_mutex_unlock( &p_enc->lock_out );
-
-    vlc_restorecancel (canc);
-
-    return NULL;
-}
-
-int transcode_encoder_video_drain( transcode_encoder_t *p_enc, block_t **out )
-{
-    if( !p_enc->b_threaded )
-    {
-        block_t *p_block;
-        do {
-            p_block = transcode_encoder_encode( p_enc, NULL );
-            block_ChainAppend( out, p_block );
-        } while( p_block );
-    }
-    else
-    {
-        if( p_enc->b_threaded && !p_enc->b_abort )
-        {
-            vlc_mutex_lock( &p_enc->lock_out );
-            p_enc->b_abort = true;
-            vlc_cond_signal( &p_enc->cond );
-            vlc_mutex_unlock( &p_enc->lock_out );
-            vlc_join( p_enc->thread, NULL );
-        }
-        block_ChainAppend( out, transcode_encoder_get_output_async( p_enc ) );
-    }
     return VLC_SUCCESS;
 }
 
-void transcode_encoder_video_stop( transcode_encoder_t *p_enc )
-{
-    if( p_enc->b_threaded && !p_enc->b_abort )
-    {
-        vlc_mutex_lock( &p_enc->lock_out );
-        p_enc->b_abort = true;
-        vlc_cond_signal( &p_enc->cond );
-        vlc_mutex_unlock( &p_enc->lock_out );
-        vlc_join( p_enc->thread, NULL );
-    }
-}
-
 int transcode_encoder_video_open( transcode_encoder_t *p_enc,
                                    const transcode_encoder_config_t *p_cfg )
 {
-    p_enc->p_encoder->i_threads = p_cfg->video.threads.i_count;
+    p_enc->p_encoder->i_threads = p_cfg->threads.i_count;
     p_enc->p_encoder->p_cfg = p_cfg->p_config_chain;
     p_enc->p_encoder->ops = NULL;
 
@@ -404,39 +321,10 @@ int transcode_encoder_video_open( transcode_encoder_t *p_enc,
     p_enc->p_encoder->fmt_out.i_codec =
         vlc_fourcc_GetCodec( VIDEO_ES, p_enc->p_encoder->fmt_out.i_codec );
 
-    vlc_sem_init( &p_enc->picture_pool_has_room, p_cfg->video.threads.pool_size );
-    vlc_cond_init( &p_enc->cond );
-    p_enc->p_buffers = NULL;
-    p_enc->b_abort = false;
-
-    if( p_cfg->video.threads.i_count > 0 )
-    {
-        if( vlc_clone( &p_enc->thread, EncoderThread, p_enc ) )
-        {
-            if (p_enc->p_encoder->ops->close)
-                p_enc->p_encoder->ops->close(p_enc->p_encoder);
-            module_unneed( p_enc->p_encoder, p_enc->p_encoder->p_module );
-            p_enc->p_encoder->p_module = NULL;
-            return VLC_EGENERIC;
-        }
-        p_enc->b_threaded = true;
-    }
-
     return VLC_SUCCESS;
 }
 
 block_t * transcode_encoder_video_encode( transcode_encoder_t *p_enc, picture_t *p_pic )
 {
-    if( !p_enc->b_threaded )
-    {
-        return vlc_encoder_EncodeVideo( p_enc->p_encoder, p_pic );
-    }
-
-    vlc_sem_wait( &p_enc->picture_pool_has_room );
-    vlc_mutex_lock( &p_enc->lock_out );
-    picture_Hold( p_pic );
-    picture_fifo_Push( p_enc->pp_pics, p_pic );
-    vlc_cond_signal( &p_enc->cond );
-    vlc_mutex_unlock( &p_enc->lock_out );
-    return NULL;
+    return vlc_encoder_EncodeVideo( p_enc->p_encoder, p_pic );
 }
@@ -112,9 +112,12 @@ int transcode_spu_init( sout_stream_t *p_stream, const es_format_t *p_fmt,
         /* Open encoder */
         /* Initialization of encoder format structures */
         assert(!id->encoder);
-        id->encoder = transcode_encoder_new( sout_EncoderCreate(p_stream, sizeof(encoder_t)), id->p_decoder->fmt_in );
+        encoder_t *p_encoder = sout_EncoderCreate( p_stream, sizeof(encoder_t) );
+        id->encoder = transcode_encoder_new( p_encoder, id->p_decoder->fmt_in );
         if( !id->encoder )
         {
+            if( p_encoder )
+                vlc_object_delete( p_encoder );
             module_unneed( id->p_decoder, id->p_decoder->p_module );
             id->p_decoder->p_module = NULL;
             return VLC_EGENERIC;
@@ -236,7 +239,6 @@ int transcode_spu_process( sout_stream_t *p_stream,
             es_format_Clean( &fmt );
 
             p_block = transcode_encoder_encode( id->encoder, p_subpic );
-            subpicture_Delete( p_subpic );
             if( p_block )
                 block_ChainAppend( out, p_block );
             else
@@ -80,6 +80,30 @@
 #define VFILTER_LONGTEXT N_( \
     "Video filters will be applied to the video streams (after overlays " \
     "are applied). You can enter a colon-separated list of filters." )
+#define VPIPELINE_TEXT N_("Video filter pipeline depth")
+#define VPIPELINE_LONGTEXT N_( \
+    "Runs each video filter, including deinterlacing, on its own thread, " \
+    "with up to this many pictures queued between two filters. " \
+    "0 runs the filters one after the other on the decoder thread." )
+#define SEGMENTS_TEXT N_("Concurrent video segments")
+#define SEGMENTS_LONGTEXT N_( \
+    "Splits the video into segments of consecutive pictures, each encoded " \
+    "from a keyframe by its own encoder, and encodes up to this many " \
+    "segments at once. The segments are output in order once complete, " \
+    "so this is meant for file to file transcoding. 0 or 1 disables it." )
+#define SEGMENT_LENGTH_TEXT N_("Video segment length")
+#define SEGMENT_LENGTH_LONGTEXT N_( \
+    "Number of pictures in each concurrently encoded video segment. Up to " \
+    "this many decoded pictures are queued for each segment encoder, so " \
+    "up to segments times this many pictures are kept in memory: about " \
+    "1.2 GB for 8 segments of 50 pictures in 1080p." )
+#define RENDITIONS_TEXT N_("Video renditions")
+#define RENDITIONS_LONGTEXT N_( \
+    "Comma-separated list of additional, smaller, video encodings as " \
+    "height:bitrate in kb/s (eg: 720:3000,480:1500). The video is decoded " \
+    "and filtered once, and each rendition is scaled from the next larger " \
+    "one. Each rendition is output as its own ES, whose ID is the one of " \
+    "the video ES followed by the height (eg: video/0/720p)." )
 
 #define AENC_TEXT N_("Audio encoder")
 #define AENC_LONGTEXT N_( \
@@ -124,14 +148,15 @@
 
 #define THREADS_TEXT N_("Number of threads")
 #define THREADS_LONGTEXT N_( \
-    "Number of threads used for the transcoding." )
+    "Number of threads used for the transcoding. If not zero, each audio " \
+    "and video encoder also runs on its own thread." )
 #define HP_TEXT N_("High priority")
 #define HP_LONGTEXT N_( \
     "Runs the optional encoder thread at the OUTPUT priority instead of " \
     "VIDEO." )
 #define POOL_TEXT N_("Picture pool size")
-#define POOL_LONGTEXT N_( "Defines how many pictures we allow to be in pool "\
-    "between decoder/encoder threads when threads > 0" )
+#define POOL_LONGTEXT N_( "Defines how many pictures or audio frames "\
+    "we allow to be queued before each encoder thread when threads > 0" )
 #define FORWARD_PCR_TEXT N_( "Forward PCR" )
 #define FORWARD_PCR_LONGTEXT N_( \
     "Enable PCR events forwarding to the next stream." )
@@ -186,6 +211,17 @@ vlc_module_begin ()
                  MAXHEIGHT_LONGTEXT )
     add_module_list(SOUT_CFG_PREFIX "vfilter", "video filter", NULL,
                     VFILTER_TEXT, VFILTER_LONGTEXT)
+    add_integer( SOUT_CFG_PREFIX "vfilter-pipeline", 0, VPIPELINE_TEXT,
+                 VPIPELINE_LONGTEXT )
+        change_integer_range( 0, 16 )
+    add_string( SOUT_CFG_PREFIX "renditions", NULL, RENDITIONS_TEXT,
+                RENDITIONS_LONGTEXT )
+    add_integer( SOUT_CFG_PREFIX "segments", 0, SEGMENTS_TEXT,
+                 SEGMENTS_LONGTEXT )
+        change_integer_range( 0, 32 )
+    add_integer( SOUT_CFG_PREFIX "segment-length", 50, SEGMENT_LENGTH_TEXT,
+                 SEGMENT_LENGTH_LONGTEXT )
+        change_integer_range( 1, 500 )
 
     set_section( N_("Audio"), NULL )
     add_module(SOUT_CFG_PREFIX "aenc", "audio encoder", "none",
@@ -232,7 +268,8 @@ static const char *const ppsz_sout_options[] = {
     "deinterlace-module", "threads", "aenc", "acodec", "ab", "alang",
     "afilter", "samplerate", "channels", "senc", "scodec", "soverlay",
     "sfilter", "high-priority", "maxwidth", "maxheight", "pool-size",
-    "forward-pcr", NULL
+    "forward-pcr", "vfilter-pipeline", "renditions",
+    "segments", "segment-length", NULL
 };
 
 /*****************************************************************************
@@ -243,6 +280,12 @@ static void  Del( sout_stream_t *, void * );
 static int   Send( sout_stream_t *, void *, block_t * );
 static void  SetPCR(sout_stream_t *, vlc_tick_t );
 
+static void SetEncoderThreadsConfig( sout_stream_t *p_stream, transcode_encoder_config_t *p_cfg )
+{
+    p_cfg->threads.i_count = var_GetInteger( p_stream, SOUT_CFG_PREFIX "threads" );
+    p_cfg->threads.pool_size = var_GetInteger( p_stream, SOUT_CFG_PREFIX "pool-size" );
+}
+
 static void SetAudioEncoderConfig( sout_stream_t *p_stream, transcode_encoder_config_t *p_cfg )
 {
     char *psz_string = var_GetString( p_stream, SOUT_CFG_PREFIX "aenc" );
@@ -289,6 +332,8 @@ static void SetAudioEncoderConfig( sout_stream_t *p_stream, transcode_encoder_co
     }
 
     p_cfg->psz_lang = var_GetNonEmptyString( p_stream, SOUT_CFG_PREFIX "alang" );
+
+    SetEncoderThreadsConfig( p_stream, p_cfg );
 }
 
 static void SetVideoEncoderConfig( sout_stream_t *p_stream, transcode_encoder_config_t *p_cfg )
@@ -327,9 +372,62 @@ static void SetVideoEncoderConfig( sout_stream_t *p_stream, transcode_encoder_co
     p_cfg->video.i_height = var_GetInteger( p_stream, SOUT_CFG_PREFIX "height" );
     p_cfg->video.i_maxwidth = var_GetInteger( p_stream, SOUT_CFG_PREFIX "maxwidth" );
     p_cfg->video.i_maxheight = var_GetInteger( p_stream, SOUT_CFG_PREFIX "maxheight" );
+    p_cfg->video.i_segments = var_GetInteger( p_stream, SOUT_CFG_PREFIX "segments" );
+    p_cfg->video.i_segment_length = var_GetInteger( p_stream, SOUT_CFG_PREFIX "segment-length" );
+
+    SetEncoderThreadsConfig( p_stream, p_cfg );
+}
 
-    p_cfg->video.threads.i_count = var_GetInteger( p_stream, SOUT_CFG_PREFIX "threads" );
-    p_cfg->video.threads.pool_size = var_GetInteger( p_stream, SOUT_CFG_PREFIX "pool-size" );
+static int CompareRenditions( const void *a, const void *b )
+{
+    const transcode_encoder_config_t *p_a = a, *p_b = b;
+    return (p_a->video.i_height < p_b->video.i_height) -
+           (p_a->video.i_height > p_b->video.i_height);
+}
+
+static void SetRenditionsConfig( sout_stream_t *p_stream, sout_stream_sys_t *p_sys )
+{
+    char *psz_string = var_GetNonEmptyString( p_stream, SOUT_CFG_PREFIX "renditions" );
+    if( psz_string == NULL )
+        return;
+
+    char *psz_save;
+    for( char *psz = strtok_r( psz_string, ",", &psz_save ); psz != NULL;
+         psz = strtok_r( NULL, ",", &psz_save ) )
+    {
+        unsigned i_height, i_bitrate = 0;
+        if( sscanf( psz, "%u:%u", &i_height, &i_bitrate ) < 1 || i_height < 2 )
+        {
+            msg_Warn( p_stream, "ignoring invalid rendition `%s'", psz );
+            continue;
+        }
+
+        transcode_encoder_config_t *p_cfgs =
+            realloc( p_sys->rendition_cfgs,
+                     (p_sys->i_rendition_cfgs + 1) * sizeof(*p_cfgs) );
+        if( unlikely(p_cfgs == NULL) )
+            break;
+        p_sys->rendition_cfgs = p_cfgs;
+
+        /* Same encoder as the main video, only the size and bitrate vary */
+        transcode_encoder_config_t *p_cfg = &p_cfgs[p_sys->i_rendition_cfgs++];
+        *p_cfg = p_sys->venc_cfg;
+        p_cfg->video.f_scale = 0;
+        p_cfg->video.i_width = p_cfg->video.i_maxwidth = 0;
+        p_cfg->video.i_height = i_height;
+        p_cfg->video.i_maxheight = 0;
+        if( i_bitrate > 0 )
+            p_cfg->video.i_bitrate = i_bitrate < 16000 ? i_bitrate * 1000
+                                                       : i_bitrate;
+        msg_Dbg( p_stream, "video rendition %up %ukb/s", i_height,
+                 p_cfg->video.i_bitrate / 1000 );
+    }
+    free( psz_string );
+
+    /* Each rendition is scaled from the previous one */
+    if( p_sys->i_rendition_cfgs > 0 )
+        qsort( p_sys->rendition_cfgs, p_sys->i_rendition_cfgs,
+               sizeof(*p_sys->rendition_cfgs), CompareRenditions );
 }
 
 static void SetSPUEncoderConfig( sout_stream_t *p_stream, transcode_encoder_config_t *p_cfg )
@@ -352,6 +450,8 @@ static void SetSPUEncoderConfig( sout_stream_t *p_stream, transcode_encoder_conf
     }
     free( psz_string );
 
+    /* The subtitles stay encoded inline: they are rare and cheap to encode,
+     * and a threaded encoder would only output each one with the next */
 }
 /*****************************************************************************
  * Control
@@ -458,6 +558,7 @@ static int Open( vlc_object_t *p_this )
                  p_sys->venc_cfg.video.i_height,
                  p_sys->venc_cfg.video.f_scale,
                  p_sys->venc_cfg.video.i_bitrate / 1000 );
+        SetRenditionsConfig( p_stream, p_sys );
     }
 
     /* Video Filter Parameters */
@@ -469,6 +570,9 @@ static int Open( vlc_object_t *p_this )
     else
         free( psz_string );
 
+    p_sys->vfilters_cfg.video.i_pipeline =
+        var_GetInteger( p_stream, SOUT_CFG_PREFIX "vfilter-pipeline" );
+
     if( var_GetBool( p_stream, SOUT_CFG_PREFIX "deinterlace" ) )
     {
         psz_string = var_GetString( p_stream,
@@ -515,6 +619,7 @@ static void Close( sout_stream_t *p_stream )
 {
     sout_stream_sys_t   *p_sys = p_stream->p_sys;
 
+    free( p_sys->rendition_cfgs );
     transcode_encoder_config_clean( &p_sys->venc_cfg );
     sout_filters_config_clean( &p_sys->vfilters_cfg );
 
@@ -712,9 +817,37 @@ Add( sout_stream_t *p_stream, const es_format_t *p_fmt, const char *es_id )
     if( p_sys->pcr_forwarding_enabled )
     {
         // TODO properly estimate the delay
-        id->pcr_helper = transcode_track_pcr_helper_New( p_sys->pcr_sync, VLC_TICK_FROM_SEC( 4 ) );
+        vlc_tick_t max_delay = VLC_TICK_FROM_SEC( 4 );
+        /* Video segments are only output once fully encoded */
+        if( p_fmt->i_cat == VIDEO_ES && p_sys->venc_cfg.video.i_segments > 1 )
+            max_delay += p_sys->venc_cfg.video.i_segments *
+                         p_sys->venc_cfg.video.i_segment_length *
+                         VLC_TICK_FROM_MS( 100 );
+        id->pcr_helper = transcode_track_pcr_helper_New( p_sys->pcr_sync, max_delay );
         if( unlikely( id->pcr_helper == NULL ) )
             goto error;
+
+        /* The renditions are encoded from the same input, but on their own
+         * encoders: the PCR must not pass the DTS of any of them */
+        for( size_t i = 0; p_fmt->i_cat == VIDEO_ES && i < id->i_renditions;
+             i++ )
+        {
+            struct transcode_rendition *r = &id->p_renditions[i];
+
+            r->pcr_helper = transcode_track_pcr_helper_New( p_sys->pcr_sync,
+                                                            max_delay );
+            if( unlikely( r->pcr_helper == NULL ) )
+            {
+                while( i-- > 0 )
+                {
+                    transcode_track_pcr_helper_Delete(
+                        id->p_renditions[i].pcr_helper );
+                    id->p_renditions[i].pcr_helper = NULL;
+                }
+                transcode_track_pcr_helper_Delete( id->pcr_helper );
+                goto error;
+            }
+        }
     }
     else
     {
@@ -758,6 +891,10 @@ static void Del( sout_stream_t *p_stream, void *_id )
             if( id == p_sys->id_video )
                 p_sys->id_video = NULL;
             vlc_mutex_unlock( &p_sys->lock );
+            for( size_t i = 0; i < id->i_renditions; i++ )
+                if( id->p_renditions[i].downstream_id )
+                    sout_StreamIdDel( p_stream->p_next,
+                                      id->p_renditions[i].downstream_id );
             transcode_video_clean( id );
             break;
         case SPU_ES:
@@ -779,6 +916,48 @@ static void Del( sout_stream_t *p_stream, void *_id )
     DeleteSoutStreamID( id );
 }
 
+/* Sends the encoded blocks of a track, and forwards the PCR they allow */
+static int SendEncoded( sout_stream_t *p_stream,
+                        transcode_track_pcr_helper_t *pcr_helper,
+                        void *downstream_id, block_t *p_out )
+{
+    sout_stream_sys_t *sys = p_stream->p_sys;
+
+    for( block_t *it = p_out; it != NULL; )
+    {
+        block_t *next = it->p_next;
+        it->p_next = NULL;
+
+        vlc_tick_t pcr = VLC_TICK_INVALID;
+        if( sys->pcr_forwarding_enabled )
+        {
+            const int status = transcode_track_pcr_helper_SignalLeavingFrame(
+                pcr_helper, it, &pcr );
+            if( status != VLC_SUCCESS )
+            {
+                msg_Err( p_stream,
+                         "Failed to match transcode input with encoder output. "
+                         "Disabling PCR forwarding..." );
+                sys->pcr_forwarding_enabled = false;
+            }
+        }
+
+        if( sout_StreamIdSend( p_stream->p_next, downstream_id, it ) != VLC_SUCCESS )
+        {
+            block_ChainRelease( next );
+            return VLC_EGENERIC;
+        }
+
+        if( pcr != VLC_TICK_INVALID )
+        {
+            sout_StreamSetPCR( p_stream->p_next, pcr );
+        }
+
+        it = next;
+    }
+    return VLC_SUCCESS;
+}
+
 static int Send( sout_stream_t *p_stream, void *_id, block_t *p_buffer )
 {
     sout_stream_id_sys_t *id = (sout_stream_id_sys_t *)_id;
@@ -808,6 +987,15 @@ static int Send( sout_stream_t *p_stream, void *_id, block_t *p_buffer )
         {
             sout_StreamSetPCR( p_stream->p_next, dropped_frame_ts );
         }
+
+        for( size_t i = 0; id->p_decoder->fmt_in->i_cat == VIDEO_ES &&
+                           i < id->i_renditions; i++ )
+        {
+            transcode_track_pcr_helper_SignalEnteringFrame(
+                id->p_renditions[i].pcr_helper, p_buffer, &dropped_frame_ts );
+            if( dropped_frame_ts != VLC_TICK_INVALID )
+                sout_StreamSetPCR( p_stream->p_next, dropped_frame_ts );
+        }
     }
 
     int i_ret;
@@ -829,37 +1017,21 @@ static int Send( sout_stream_t *p_stream, void *_id, block_t *p_buffer )
         goto error;
     }
 
-    for( block_t *it = p_out; it != NULL; )
-    {
-        block_t *next = it->p_next;
-        it->p_next = NULL;
-
-        vlc_tick_t pcr = VLC_TICK_INVALID;
-        if( sys->pcr_forwarding_enabled )
-        {
-            const int status = transcode_track_pcr_helper_SignalLeavingFrame(
-                id->pcr_helper, it, &pcr );
-            if( status != VLC_SUCCESS )
-            {
-                msg_Err( p_stream,
-                         "Failed to match transcode input with encoder output. "
-                         "Disabling PCR forwarding..." );
-                sys->pcr_forwarding_enabled = false;
-            }
-        }
+    if( SendEncoded( p_stream, id->pcr_helper, id->downstream_id,
+                     p_out ) != VLC_SUCCESS )
+        return VLC_EGENERIC;
 
-        if( sout_StreamIdSend( p_stream->p_next, id->downstream_id, it ) != VLC_SUCCESS )
+    if( id->p_decoder->fmt_in->i_cat == VIDEO_ES )
+    {
+        for( size_t i = 0; i < id->i_renditions; i++ )
         {
-            p_buffer = next;
-            goto error;
-        }
+            struct transcode_rendition *r = &id->p_renditions[i];
 
-        if( pcr != VLC_TICK_INVALID )
-        {
-            sout_StreamSetPCR( p_stream->p_next, pcr );
+            if( SendEncoded( p_stream, r->pcr_helper, r->downstream_id,
+                             transcode_video_rendition_dequeue( id, i ) )
+                    != VLC_SUCCESS )
+                i_ret = VLC_EGENERIC;
         }
-
-        it = next;
     }
 
     if (i_ret != VLC_SUCCESS)
@@ -19,6 +19,7 @@ typedef struct
             config_chain_t  *p_deinterlace_cfg;
             char            *psz_spu_sources;
             bool             b_reorient;
+            unsigned         i_pipeline;
         } video;
     };
 } sout_filters_config_t;
@@ -54,6 +55,10 @@ typedef struct
     /* Video */
     transcode_encoder_config_t venc_cfg;
     sout_filters_config_t vfilters_cfg;
+    /* Extra video renditions, from the largest to the smallest; the
+     * configurations borrow the strings of venc_cfg */
+    transcode_encoder_config_t *rendition_cfgs;
+    size_t          i_rendition_cfgs;
 
     /* SPU */
     transcode_encoder_config_t senc_cfg;
@@ -75,6 +80,28 @@ typedef struct
 
 struct aout_filters;
 
+/* Range of consecutive pictures encoded by its own encoder, so that it
+ * starts with a keyframe and can be concatenated to the previous one */
+struct transcode_segment
+{
+    transcode_encoder_t *encoder;
+    block_t             *p_out; /**< output until the segment is complete */
+};
+
+/* Additional encoding of a transcoded video ES, at a lower resolution */
+struct transcode_rendition
+{
+    const transcode_encoder_config_t *p_enccfg;
+    /* Scales the pictures of the previous rendition, or of the main
+     * encoder for the first one */
+    filter_chain_t      *p_scaler;
+    transcode_encoder_t *encoder;
+    void                *downstream_id;
+    char                *psz_es_id;
+    block_t             *p_out; /**< protected by the output_fifo lock */
+    transcode_track_pcr_helper_t *pcr_helper;
+};
+
 struct sout_stream_id_sys_t
 {
     bool            b_transcode;
@@ -134,6 +161,17 @@ struct sout_stream_id_sys_t
              spu_t           *p_spu;
              vlc_decoder_device *dec_dev;
              vlc_video_context *enc_vctx_in;
+             struct transcode_rendition *p_renditions;
+             size_t          i_renditions;
+             struct
+             {
+                 transcode_encoder_config_t cfg;
+                 struct transcode_segment *p_ring; /**< in-flight segments */
+                 size_t          i_first;
+                 size_t          i_count;
+                 unsigned        i_pictures; /**< in the last segment */
+                 vlc_tick_t      i_last_dts; /**< of the segments output */
+             } segments;
          };
          struct
          {
@@ -232,5 +270,6 @@ void transcode_video_flush  ( sout_stream_id_sys_t * );
 int transcode_video_get_output_dimensions( sout_stream_id_sys_t *,
                                            unsigned *w, unsigned *h );
 void transcode_video_push_spu( sout_stream_t *, sout_stream_id_sys_t *, subpicture_t * );
+block_t *transcode_video_rendition_dequeue( sout_stream_id_sys_t *, size_t );
 int  transcode_video_init    ( sout_stream_t *, const es_format_t *,
                                sout_stream_id_sys_t *);
@@ -114,6 +114,10 @@ static int transcode_video_filters_init( sout_stream_t *p_stream,
                                          const es_format_t *p_dst,
                                          sout_stream_id_sys_t *id );
 
+static void transcode_video_renditions_open( sout_stream_t *p_stream,
+                                             sout_stream_id_sys_t *id,
+                                             vlc_video_context *vctx );
+
 static int video_update_format_decoder( decoder_t *p_dec, vlc_video_context *vctx )
 {
     struct decoder_owner *p_owner = dec_get_owner( p_dec );
@@ -194,6 +198,9 @@ static int video_update_format_decoder( decoder_t *p_dec, vlc_video_context *vct
                    enc_vctx,
                    id->encoder);
 
+        /* With segments, this encoder is never fed. It is still opened:
+         * it negotiates the input format the segment encoders are created
+         * with, and the output format announced downstream. */
         if( transcode_encoder_open( id->encoder, id->p_enccfg ) != VLC_SUCCESS )
             goto error;
     }
@@ -225,6 +232,14 @@ static int video_update_format_decoder( decoder_t *p_dec, vlc_video_context *vct
                                              id->p_decoder->fmt_in,
                                              transcode_encoder_format_out( id->encoder ),
                                              id->es_id );
+
+    /* The renditions and the segments take the encoder input, which does
+     * not change once the encoder is opened */
+    id->enc_vctx_in = id->p_final_conv_static ?
+        filter_chain_GetVideoCtxOut( id->p_final_conv_static ) : enc_vctx;
+    if( id->i_renditions > 0 && id->p_renditions[0].encoder == NULL )
+        transcode_video_renditions_open( p_owner->p_stream, id,
+                                         id->enc_vctx_in );
     msg_Info( p_dec, "video format update succeed" );
 
 end:
@@ -251,15 +266,335 @@ static picture_t *video_new_buffer_encoder( transcode_encoder_t *p_enc )
 
 static int transcode_process_picture( sout_stream_id_sys_t *id,
                                       picture_t *p_pic, block_t **out);
+static int transcode_process_stages( sout_stream_id_sys_t *id, size_t i_stage,
+                                     picture_t *p_pic, block_t **out );
 
-static void decoder_queue_video( decoder_t *p_dec, picture_t *p_pic )
+static void transcode_video_rendition_clean( struct transcode_rendition *r )
 {
-    struct decoder_owner *p_owner = dec_get_owner( p_dec );
-    sout_stream_id_sys_t *id = p_owner->id;
+    if( r->encoder != NULL )
+        transcode_encoder_delete( r->encoder );
+    transcode_remove_filters( &r->p_scaler );
+    free( r->psz_es_id );
+    if( r->p_out != NULL )
+        block_ChainRelease( r->p_out );
+    if( r->pcr_helper != NULL )
+        transcode_track_pcr_helper_Delete( r->pcr_helper );
+
+    r->encoder = NULL;
+    r->pcr_helper = NULL;
+    r->psz_es_id = NULL;
+    r->p_out = NULL;
+}
 
-    block_t *p_block = NULL;
-    int ret = transcode_process_picture( id, p_pic, &p_block );
+/* Opens an additional encoder, fed with pictures in the p_src format */
+static transcode_encoder_t *
+transcode_video_encoder_create( sout_stream_t *p_stream,
+                                sout_stream_id_sys_t *id,
+                                const transcode_encoder_config_t *p_cfg,
+                                const es_format_t *p_src,
+                                vlc_video_context *vctx )
+{
+    struct encoder_owner *p_enc_owner =
+       (struct encoder_owner *)sout_EncoderCreate( VLC_OBJECT(p_stream), sizeof(struct encoder_owner) );
+    if( unlikely(p_enc_owner == NULL) )
+        return NULL;
+
+    p_enc_owner->id = id;
+    p_enc_owner->enc.cbs = &encoder_video_transcode_cbs;
+
+    transcode_encoder_t *p_enc = transcode_encoder_new( &p_enc_owner->enc, p_src );
+    if( p_enc == NULL )
+    {
+        vlc_object_delete( &p_enc_owner->enc );
+        return NULL;
+    }
+
+    transcode_encoder_video_configure( VLC_OBJECT(p_stream),
+                                       &id->p_decoder->fmt_out.video,
+                                       p_cfg, &p_src->video, vctx, p_enc );
+    if( transcode_encoder_open( p_enc, p_cfg ) != VLC_SUCCESS )
+    {
+        transcode_encoder_delete( p_enc );
+        return NULL;
+    }
+    return p_enc;
+}
+
+static int transcode_video_rendition_open( sout_stream_t *p_stream,
+                                           sout_stream_id_sys_t *id,
+                                           struct transcode_rendition *r,
+                                           const es_format_t *p_src,
+                                           vlc_video_context *vctx )
+{
+    r->encoder = transcode_video_encoder_create( p_stream, id, r->p_enccfg,
+                                                 p_src, vctx );
+    if( r->encoder == NULL )
+        return VLC_EGENERIC;
+
+    const es_format_t *encoder_fmt = transcode_encoder_format_in( r->encoder );
+    if( !video_format_IsSimilar( &encoder_fmt->video, &p_src->video ) )
+    {
+        filter_owner_t chain_owner = {
+           .video = &transcode_filter_video_cbs,
+           .sys = id,
+        };
+
+        r->p_scaler = filter_chain_NewVideo( p_stream, false, &chain_owner );
+        if( r->p_scaler == NULL )
+            return VLC_ENOMEM;
+        filter_chain_Reset( r->p_scaler, p_src, vctx, encoder_fmt );
+        if( filter_chain_AppendConverter( r->p_scaler, NULL ) != VLC_SUCCESS )
+            return VLC_EGENERIC;
+    }
+
+    const es_format_t *p_fmt_out = transcode_encoder_format_out( r->encoder );
+    if( id->es_id != NULL &&
+        asprintf( &r->psz_es_id, "%s/%up", id->es_id,
+                  p_fmt_out->video.i_visible_height ) < 0 )
+    {
+        r->psz_es_id = NULL;
+        return VLC_ENOMEM;
+    }
+
+    /* Let the muxers pick an ID, the original one is used by the main
+     * encoding */
+    es_format_t orig = *id->p_decoder->fmt_in;
+    orig.i_id = -1;
+    r->downstream_id = id->pf_transcode_downstream_add( p_stream, &orig,
+                                                        p_fmt_out,
+                                                        r->psz_es_id );
+    if( r->downstream_id == NULL )
+        return VLC_EGENERIC;
+
+    msg_Dbg( p_stream, "video rendition %s %ux%u %ukb/s",
+             r->psz_es_id ? r->psz_es_id : "",
+             p_fmt_out->video.i_visible_width,
+             p_fmt_out->video.i_visible_height,
+             p_fmt_out->i_bitrate / 1000 );
+    return VLC_SUCCESS;
+}
+
+static void transcode_video_renditions_open( sout_stream_t *p_stream,
+                                             sout_stream_id_sys_t *id,
+                                             vlc_video_context *vctx )
+{
+    /* Each rendition is scaled from the previous, larger, one rather than
+     * from the full size pictures */
+    const es_format_t *p_src = transcode_encoder_format_in( id->encoder );
+
+    for( size_t i = 0; i < id->i_renditions; i++ )
+    {
+        struct transcode_rendition *r = &id->p_renditions[i];
+
+        if( transcode_video_rendition_open( p_stream, id, r, p_src,
+                                            vctx ) != VLC_SUCCESS )
+        {
+            msg_Warn( p_stream, "cannot open video rendition %zu, dropping "
+                      "it and the smaller ones", i );
+            if( r->downstream_id != NULL )
+                sout_StreamIdDel( p_stream->p_next, r->downstream_id );
+            r->downstream_id = NULL;
+            for( size_t j = i; j < id->i_renditions; j++ )
+                transcode_video_rendition_clean( &id->p_renditions[j] );
+            id->i_renditions = i;
+            break;
+        }
+
+        p_src = transcode_encoder_format_in( r->encoder );
+        if( r->p_scaler != NULL )
+            vctx = filter_chain_GetVideoCtxOut( r->p_scaler );
+    }
+}
+
+static void transcode_video_rendition_queue( sout_stream_id_sys_t *id,
+                                             struct transcode_rendition *r,
+                                             block_t *p_block )
+{
+    if( p_block == NULL )
+        return;
+
+    vlc_fifo_Lock( id->output_fifo );
+    block_ChainAppend( &r->p_out, p_block );
+    vlc_fifo_Unlock( id->output_fifo );
+}
+
+static void transcode_video_renditions_encode( sout_stream_id_sys_t *id,
+                                               picture_t *p_pic )
+{
+    for( size_t i = 0; i < id->i_renditions && p_pic != NULL; i++ )
+    {
+        struct transcode_rendition *r = &id->p_renditions[i];
+
+        if( r->p_scaler != NULL )
+            p_pic = filter_chain_VideoFilter( r->p_scaler, p_pic );
+        if( p_pic == NULL )
+            break;
+
+        /* The next rendition is scaled from this one */
+        picture_t *p_next = i + 1 < id->i_renditions ? picture_Hold( p_pic )
+                                                     : NULL;
+        block_t *p_block = transcode_encoder_encode( r->encoder, p_pic );
+        transcode_video_rendition_queue( id, r, p_block );
+        p_pic = p_next;
+    }
+}
+
+static void transcode_video_renditions_drain( sout_stream_id_sys_t *id )
+{
+    for( size_t i = 0; i < id->i_renditions; i++ )
+    {
+        struct transcode_rendition *r = &id->p_renditions[i];
+        block_t *p_block = NULL;
+
+        if( r->encoder == NULL ||
+            transcode_encoder_drain( r->encoder, &p_block ) != VLC_SUCCESS )
+            continue;
+        transcode_video_rendition_queue( id, r, p_block );
+    }
+}
+
+block_t *transcode_video_rendition_dequeue( sout_stream_id_sys_t *id,
+                                            size_t i )
+{
+    struct transcode_rendition *r = &id->p_renditions[i];
+
+    vlc_fifo_Lock( id->output_fifo );
+    block_t *p_out = r->p_out;
+    r->p_out = NULL;
+    vlc_fifo_Unlock( id->output_fifo );
+    return p_out;
+}
+
+static void transcode_video_segments_init( sout_stream_id_sys_t *id )
+{
+    const video_format_t *p_fmt =
+        &transcode_encoder_format_in( id->encoder )->video;
+
+    /* Same encoder as the main one, at its final size, each one on its own
+     * thread with room for a whole segment, so that the decoder can run
+     * ahead of the slowest encoders */
+    id->segments.cfg = *id->p_enccfg;
+    id->segments.cfg.video.f_scale = 0;
+    id->segments.cfg.video.i_width = p_fmt->i_visible_width;
+    id->segments.cfg.video.i_height = p_fmt->i_visible_height;
+    id->segments.cfg.video.i_maxwidth = id->segments.cfg.video.i_maxheight = 0;
+    if( id->segments.cfg.threads.i_count == 0 )
+        id->segments.cfg.threads.i_count = 1;
+    id->segments.cfg.threads.pool_size =
+        __MAX( id->segments.cfg.threads.pool_size,
+               id->p_enccfg->video.i_segment_length );
+    id->segments.i_last_dts = VLC_TICK_INVALID;
+}
+
+/* Waits for the oldest segment to be encoded and outputs it */
+static void transcode_video_segment_finish( sout_stream_id_sys_t *id,
+                                            block_t **out )
+{
+    struct transcode_segment *p_seg = &id->segments.p_ring[id->segments.i_first];
+
+    transcode_encoder_drain( p_seg->encoder, &p_seg->p_out );
+    transcode_encoder_delete( p_seg->encoder );
+
+    /* Each encoder starts its own DTS offset: one reordering the pictures
+     * can start a segment below the end of the previous one, so the DTS
+     * are clamped to keep increasing across the joins */
+    for( block_t *p_block = p_seg->p_out; p_block != NULL;
+         p_block = p_block->p_next )
+    {
+        if( p_block->i_dts == VLC_TICK_INVALID )
+            continue;
+        if( id->segments.i_last_dts != VLC_TICK_INVALID &&
+            p_block->i_dts <= id->segments.i_last_dts )
+            p_block->i_dts = id->segments.i_last_dts + 1;
+        id->segments.i_last_dts = p_block->i_dts;
+    }
 
+    block_ChainAppend( out, p_seg->p_out );
+    p_seg->encoder = NULL;
+    p_seg->p_out = NULL;
+
+    id->segments.i_first = (id->segments.i_first + 1) %
+                           id->p_enccfg->video.i_segments;
+    id->segments.i_count--;
+}
+
+static int transcode_video_segments_encode( sout_stream_id_sys_t *id,
+                                            picture_t *p_pic, block_t **out )
+{
+    const unsigned i_size = id->p_enccfg->video.i_segments;
+
+    if( id->segments.i_count == 0 ||
+        id->segments.i_pictures >= id->p_enccfg->video.i_segment_length )
+    {
+        /* All the encoders are busy: the decoder waits for the oldest */
+        if( id->segments.i_count == i_size )
+            transcode_video_segment_finish( id, out );
+
+        if( id->segments.p_ring == NULL )
+        {
+            id->segments.p_ring = calloc( i_size, sizeof(*id->segments.p_ring) );
+            if( unlikely(id->segments.p_ring == NULL) )
+            {
+                picture_Release( p_pic );
+                return VLC_ENOMEM;
+            }
+            transcode_video_segments_init( id );
+        }
+
+        struct decoder_owner *p_owner = dec_get_owner( id->p_decoder );
+        transcode_encoder_t *p_enc =
+            transcode_video_encoder_create( p_owner->p_stream, id,
+                                            &id->segments.cfg,
+                                            transcode_encoder_format_in( id->encoder ),
+                                            id->enc_vctx_in );
+        if( p_enc == NULL )
+        {
+            msg_Err( p_owner->p_stream, "cannot open a segment encoder" );
+            picture_Release( p_pic );
+            return VLC_EGENERIC;
+        }
+
+        size_t i_last = (id->segments.i_first + id->segments.i_count) % i_size;
+        id->segments.p_ring[i_last].encoder = p_enc;
+        id->segments.i_count++;
+        id->segments.i_pictures = 0;
+    }
+
+    size_t i_last = (id->segments.i_first + id->segments.i_count - 1) % i_size;
+    struct transcode_segment *p_seg = &id->segments.p_ring[i_last];
+
+    /* The output of a segment is only complete once it is drained */
+    block_ChainAppend( &p_seg->p_out,
+                       transcode_encoder_encode( p_seg->encoder, p_pic ) );
+    id->segments.i_pictures++;
+    return VLC_SUCCESS;
+}
+
+static void transcode_video_segments_drain( sout_stream_id_sys_t *id,
+                                            block_t **out )
+{
+    while( id->segments.i_count > 0 )
+        transcode_video_segment_finish( id, out );
+}
+
+static void transcode_video_segments_clean( sout_stream_id_sys_t *id )
+{
+    for( ; id->segments.i_count > 0; id->segments.i_count-- )
+    {
+        struct transcode_segment *p_seg =
+            &id->segments.p_ring[id->segments.i_first];
+        transcode_encoder_delete( p_seg->encoder );
+        if( p_seg->p_out != NULL )
+            block_ChainRelease( p_seg->p_out );
+        id->segments.i_first = (id->segments.i_first + 1) %
+                               id->p_enccfg->video.i_segments;
+    }
+    free( id->segments.p_ring );
+}
+
+static void transcode_video_queue_blocks( sout_stream_id_sys_t *id, int ret,
+                                         block_t *p_block )
+{
     if( p_block == NULL )
         return;
 
@@ -276,6 +611,35 @@ static void decoder_queue_video( decoder_t *p_dec, picture_t *p_pic )
     vlc_fifo_Unlock( id->output_fifo );
 }
 
+static void decoder_queue_video( decoder_t *p_dec, picture_t *p_pic )
+{
+    struct decoder_owner *p_owner = dec_get_owner( p_dec );
+    sout_stream_id_sys_t *id = p_owner->id;
+
+    block_t *p_block = NULL;
+    int ret = transcode_process_picture( id, p_pic, &p_block );
+    transcode_video_queue_blocks( id, ret, p_block );
+}
+
+static void transcode_video_drain_filters( sout_stream_id_sys_t *id )
+{
+    /* Wait for the pipelined chains, one after the other, so that each one
+     * gets all the pictures out of the previous one before being drained */
+    filter_chain_t *chains[] = { id->p_f_chain, id->p_uf_chain,
+                                 id->p_final_conv_static };
+    for( size_t i = 0; i < ARRAY_SIZE(chains); i++ )
+    {
+        if( chains[i] == NULL )
+            continue;
+        filter_chain_VideoDrain( chains[i] );
+
+        /* Only the pictures held by this chain and the next ones are left */
+        block_t *p_block = NULL;
+        int ret = transcode_process_stages( id, i, NULL, &p_block );
+        transcode_video_queue_blocks( id, ret, p_block );
+    }
+}
+
 int transcode_video_init( sout_stream_t *p_stream, const es_format_t *p_fmt,
                           sout_stream_id_sys_t *id )
 {
@@ -287,6 +651,21 @@ int transcode_video_init( sout_stream_t *p_stream, const es_format_t *p_fmt,
     if( id->output_fifo == NULL )
         return VLC_ENOMEM;
 
+    const sout_stream_sys_t *p_sys = p_stream->p_sys;
+    if( p_sys->i_rendition_cfgs > 0 )
+    {
+        id->p_renditions = calloc( p_sys->i_rendition_cfgs,
+                                   sizeof(*id->p_renditions) );
+        if( id->p_renditions == NULL )
+        {
+            block_FifoRelease( id->output_fifo );
+            return VLC_ENOMEM;
+        }
+        id->i_renditions = p_sys->i_rendition_cfgs;
+        for( size_t i = 0; i < id->i_renditions; i++ )
+            id->p_renditions[i].p_enccfg = &p_sys->rendition_cfgs[i];
+    }
+
     id->b_transcode = true;
     es_format_Init( &id->decoder_out, VIDEO_ES, 0 );
 
@@ -314,6 +693,9 @@ int transcode_video_init( sout_stream_t *p_stream, const es_format_t *p_fmt,
     {
         msg_Err( p_stream, "cannot find video decoder" );
         es_format_Clean( &id->decoder_out );
+        free( id->p_renditions );
+        id->p_renditions = NULL;
+        id->i_renditions = 0;
         return VLC_EGENERIC;
     }
     if( id->decoder_out.i_codec == 0 ) /* format_update can happen on open() */
@@ -340,6 +722,7 @@ static int transcode_video_filters_init( sout_stream_t *p_stream,
     id->p_f_chain = filter_chain_NewVideo( p_stream, false, &owner );
     if( !id->p_f_chain )
         return VLC_EGENERIC;
+    filter_chain_SetPipelined( id->p_f_chain, p_cfg->video.i_pipeline );
     filter_chain_Reset( id->p_f_chain, p_src, src_ctx, p_src );
 
     /* Deinterlace */
@@ -375,6 +758,7 @@ static int transcode_video_filters_init( sout_stream_t *p_stream,
         id->p_uf_chain = filter_chain_NewVideo( p_stream, true, &owner );
         if(!id->p_uf_chain)
             return VLC_EGENERIC;
+        filter_chain_SetPipelined( id->p_uf_chain, p_cfg->video.i_pipeline );
         filter_chain_Reset( id->p_uf_chain, p_src, src_ctx, p_dst );
         filter_chain_AppendFromString( id->p_uf_chain, p_cfg->psz_filters );
         p_src = filter_chain_GetFmtOut( id->p_uf_chain );
@@ -402,6 +786,9 @@ void transcode_video_flush( sout_stream_id_sys_t *id )
         filter_chain_VideoFlush( id->p_uf_chain );
     if ( id->p_final_conv_static != NULL )
         filter_chain_VideoFlush( id->p_final_conv_static );
+    for( size_t i = 0; i < id->i_renditions; i++ )
+        if( id->p_renditions[i].p_scaler != NULL )
+            filter_chain_VideoFlush( id->p_renditions[i].p_scaler );
 }
 
 void transcode_video_clean( sout_stream_id_sys_t *id )
@@ -410,6 +797,11 @@ void transcode_video_clean( sout_stream_id_sys_t *id )
     if ( id->encoder )
         transcode_encoder_delete( id->encoder );
 
+    for( size_t i = 0; i < id->i_renditions; i++ )
+        transcode_video_rendition_clean( &id->p_renditions[i] );
+    free( id->p_renditions );
+    transcode_video_segments_clean( id );
+
     es_format_Clean( &id->decoder_out );
 
     /* Close filters */
@@ -509,51 +901,71 @@ static void tag_last_block_with_flag( block_t **out, int i_flag )
     }
 }
 
-static int transcode_process_picture( sout_stream_id_sys_t *id,
-                                      picture_t *p_pic, block_t **out)
+static int transcode_encode_picture( sout_stream_id_sys_t *id,
+                                     picture_t *p_pic, block_t **out )
+{
+    int i_ret = VLC_SUCCESS;
+
+    /* Blend subpictures */
+    p_pic = RenderSubpictures( id, p_pic );
+    if( !p_pic )
+        return VLC_SUCCESS;
+
+    /* The renditions share the picture with the main encoder */
+    picture_t *p_rendition = id->i_renditions > 0 ? picture_Hold( p_pic )
+                                                  : NULL;
+
+    if( id->p_enccfg->video.i_segments > 1 )
+    {
+        if( transcode_video_segments_encode( id, p_pic, out ) != VLC_SUCCESS )
+            i_ret = VLC_EGENERIC;
+    }
+    else
+    {
+        /* If a packetizer is used, multiple blocks might be returned, in w */
+        block_t *p_encoded = transcode_encoder_encode( id->encoder, p_pic );
+        block_ChainAppend( out, p_encoded );
+    }
+
+    if( p_rendition != NULL )
+        transcode_video_renditions_encode( id, p_rendition );
+
+    return i_ret;
+}
+
+static int transcode_process_stages( sout_stream_id_sys_t *id, size_t i_stage,
+                                     picture_t *p_pic, block_t **out )
 {
-    /* Run the filter and output chains; first with the picture,
+    /* Run the filter chains from i_stage; first with the picture,
      * and then with NULL as many times as we need until they
      * stop outputting frames.
      */
-    for ( picture_t *p_in = p_pic ;; p_in = NULL /* drain second time */ )
-    {
-        /* Run filter chain */
-        if( id->p_f_chain )
-            p_in = filter_chain_VideoFilter( id->p_f_chain, p_in );
+    filter_chain_t *chains[] = { id->p_f_chain, id->p_uf_chain,
+                                 id->p_final_conv_static };
+    while( i_stage < ARRAY_SIZE(chains) && chains[i_stage] == NULL )
+        i_stage++;
+
+    if( i_stage == ARRAY_SIZE(chains) )
+        return p_pic ? transcode_encode_picture( id, p_pic, out ) : VLC_SUCCESS;
 
+    int i_ret = VLC_SUCCESS;
+    for( picture_t *p_in = p_pic ;; p_in = NULL /* drain second time */ )
+    {
+        p_in = filter_chain_VideoFilter( chains[i_stage], p_in );
         if( !p_in )
             break;
 
-        for( ;; p_in = NULL /* drain second time */ )
-        {
-            /* Run user specified filter chain */
-            filter_chain_t * secondary_chains[] = { id->p_uf_chain,
-                                                    id->p_final_conv_static };
-            for( size_t i=0; i<ARRAY_SIZE(secondary_chains); i++ )
-            {
-                if( !secondary_chains[i] )
-                    continue;
-                p_in = filter_chain_VideoFilter( secondary_chains[i], p_in );
-            }
-
-            if( !p_in )
-                break;
-
-            /* Blend subpictures */
-            p_in = RenderSubpictures( id, p_in );
-
-            if( p_in )
-            {
-                /* If a packetizer is used, multiple blocks might be returned, in w */
-                block_t *p_encoded = transcode_encoder_encode( id->encoder, p_in );
-                picture_Release( p_in );
-                block_ChainAppend( out, p_encoded );
-            }
-        }
+        if( transcode_process_stages( id, i_stage + 1, p_in, out ) != VLC_SUCCESS )
+            i_ret = VLC_EGENERIC;
     }
 
-    return VLC_SUCCESS;
+    return i_ret;
+}
+
+static int transcode_process_picture( sout_stream_id_sys_t *id,
+                                      picture_t *p_pic, block_t **out)
+{
+    return transcode_process_stages( id, 0, p_pic, out );
 }
 
 int transcode_video_process( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
@@ -574,10 +986,17 @@ int transcode_video_process( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
     if( id->encoder == NULL )
         return VLC_SUCCESS;
 
+    if( in == NULL )
+    {
+        transcode_video_drain_filters( id );
+        transcode_video_renditions_drain( id );
+    }
+
     vlc_fifo_Lock( id->output_fifo );
     if( unlikely( !id->b_error && in == NULL ) && transcode_encoder_opened( id->encoder ) )
     {
         msg_Dbg( p_stream, "Draining thread and waiting for that");
+        transcode_video_segments_drain( id, out );
         if( transcode_encoder_drain( id->encoder, out ) == VLC_SUCCESS )
             msg_Dbg( p_stream, "Draining done");
         else
@@ -22,6 +22,7 @@
 # include "config.h"
 #endif
 
+#include <assert.h>
 #include <errno.h>
 #include <stdlib.h>
 #include <string.h>
@@ -29,6 +30,9 @@
 #ifdef HAVE_ARPA_INET_H
 #include <arpa/inet.h>
 #endif
+#ifdef __linux__
+#include <netinet/udp.h>
+#endif
 
 #include <vlc_common.h>
 #include <vlc_configuration.h>
@@ -40,6 +44,13 @@
 #include <vlc_memstream.h>
 #include "sdp_helper.h"
 
+/* Datagrams per system call at most */
+#define MAX_BATCH 64
+/* Blocks per datagram at most */
+#define MAX_DGRAM_IOV 16
+/* Largest UDP payload */
+#define MAX_PAYLOAD 65507
+
 struct sout_stream_udp
 {
     sout_access_out_t *access;
@@ -47,6 +58,8 @@ struct sout_stream_udp
     session_descriptor_t *sap;
     int fd;
     uint_fast16_t mtu;
+    unsigned batch;
+    bool gso;
 };
 
 static void *
@@ -148,39 +161,176 @@ static int Control(sout_stream_t *stream, int query, va_list args)
     return VLC_SUCCESS;
 }
 
+#ifndef HAVE_SENDMMSG
+# define mmsghdr vlc_mmsghdr
+# define sendmmsg vlc_sendmmsg
+
+struct mmsghdr
+{
+    struct msghdr msg_hdr;
+    unsigned msg_len;
+};
+
+static int sendmmsg(int fd, struct mmsghdr *msgs, unsigned count, int flags)
+{
+    for (unsigned i = 0; i < count; i++) {
+        ssize_t val = sendmsg(fd, &msgs[i].msg_hdr, flags);
+
+        if (val < 0)
+            return i > 0 ? (int)i : -1;
+        msgs[i].msg_len = val;
+    }
+    return count;
+}
+#endif
+
+/**
+ * Gathers blocks into one datagram, up to the MTU.
+ * \return the first block not part of the datagram
+ */
+static block_t *Gather(const struct sout_stream_udp *sys, block_t *block,
+                       struct msghdr *hdr, struct iovec *iov,
+                       size_t *restrict len)
+{
+    unsigned iovlen = 0;
+    size_t tosend = 0;
+
+    do {
+        if (iovlen >= MAX_DGRAM_IOV)
+            break;
+        if (block->i_buffer + tosend > sys->mtu && likely(iovlen > 0))
+            break;
+
+        iov[iovlen].iov_base = block->p_buffer;
+        iov[iovlen].iov_len = block->i_buffer;
+        iovlen++;
+        tosend += block->i_buffer;
+        block = block->p_next;
+    } while (block != NULL);
+
+    *hdr = (struct msghdr){ .msg_iov = iov, .msg_iovlen = iovlen };
+    *len = tosend;
+    return block;
+}
+
+#ifdef UDP_SEGMENT
+typedef union
+{
+    char buf[CMSG_SPACE(sizeof (uint16_t))];
+    struct cmsghdr align;
+} gso_cmsg_t;
+
+/**
+ * Merges runs of equally sized consecutive datagrams, so that the kernel
+ * segments each run (only the last datagram of a run may be shorter).
+ * \param firsts index of the first datagram of each output message [OUT]
+ * \return the number of messages to send
+ */
+static unsigned Coalesce(const struct mmsghdr *msgs, const size_t *lens,
+                         unsigned count, struct mmsghdr *out,
+                         gso_cmsg_t *cmsgs, unsigned *firsts)
+{
+    unsigned n = 0;
+
+    for (unsigned i = 0; i < count;) {
+        struct msghdr *hdr = &out[n].msg_hdr;
+        const size_t segment = lens[i];
+        size_t total = segment;
+        unsigned j = i + 1;
+
+        *hdr = msgs[i].msg_hdr;
+        firsts[n] = i;
+
+        while (j < count && lens[j] <= segment
+            && total + lens[j] <= MAX_PAYLOAD) {
+            /* Datagrams are gathered contiguously */
+            assert(hdr->msg_iov + hdr->msg_iovlen == msgs[j].msg_hdr.msg_iov);
+            hdr->msg_iovlen += msgs[j].msg_hdr.msg_iovlen;
+            total += lens[j];
+            if (lens[j++] < segment)
+                break;
+        }
+
+        if (j - i > 1) {
+            struct cmsghdr *cmsg;
+
+            hdr->msg_control = cmsgs[n].buf;
+            hdr->msg_controllen = sizeof (cmsgs[n].buf);
+            cmsg = CMSG_FIRSTHDR(hdr);
+            cmsg->cmsg_level = SOL_UDP;
+            cmsg->cmsg_type = UDP_SEGMENT;
+            cmsg->cmsg_len = CMSG_LEN(sizeof (uint16_t));
+            *(uint16_t *)CMSG_DATA(cmsg) = segment;
+        }
+
+        n++;
+        i = j;
+    }
+    return n;
+}
+#endif
+
 static ssize_t AccessOutWrite(sout_access_out_t *access, block_t *block)
 {
     struct sout_stream_udp *sys = access->p_sys;
     ssize_t total = 0;
 
     while (block != NULL) {
-        struct iovec iov[16];
+        struct iovec iov[MAX_BATCH * MAX_DGRAM_IOV];
+        struct mmsghdr msgs[MAX_BATCH];
+        size_t lens[MAX_BATCH];
         block_t *unsent = block;
-        unsigned iovlen = 0;
-        size_t tosend = 0;
+        unsigned count = 0, iovlen = 0;
 
-        /* Count how many blocks to gather */
+        /* Gather as many datagrams as allowed in one system call */
         do {
-            if (iovlen >= ARRAY_SIZE(iov))
-                break;
-            if (unsent->i_buffer + tosend > sys->mtu && likely(iovlen > 0))
-                break;
-
-            iov[iovlen].iov_base = unsent->p_buffer;
-            iov[iovlen].iov_len = unsent->i_buffer;
-            iovlen++;
-            tosend += unsent->i_buffer;
-            unsent = unsent->p_next;
-        } while (unsent != NULL);
+            unsent = Gather(sys, unsent, &msgs[count].msg_hdr, iov + iovlen,
+                            &lens[count]);
+            iovlen += msgs[count].msg_hdr.msg_iovlen;
+            count++;
+        } while (unsent != NULL && count < sys->batch);
+
+        struct mmsghdr *tosend = msgs;
+#ifdef UDP_SEGMENT
+        struct mmsghdr gsomsgs[MAX_BATCH];
+        gso_cmsg_t cmsgs[MAX_BATCH];
+        unsigned firsts[MAX_BATCH];
+        const unsigned datagrams = count;
+
+        if (sys->gso) {
+            count = Coalesce(msgs, lens, count, gsomsgs, cmsgs, firsts);
+            tosend = gsomsgs;
+        }
+#endif
 
         /* Send */
-        struct msghdr hdr = { .msg_iov = iov, .msg_iovlen = iovlen };
-        ssize_t val = sendmsg(sys->fd, &hdr, 0);
+        for (unsigned i = 0; i < count;) {
+            int val = sendmmsg(sys->fd, tosend + i, count - i, 0);
+
+            if (val < 0) {
+                int err = errno;
+#ifdef UDP_SEGMENT
+                if (tosend[i].msg_hdr.msg_control != NULL
+                 && (err == EIO || err == EINVAL || err == ENOPROTOOPT)) {
+                    msg_Warn(access, "segmentation offload not available: %s",
+                             vlc_strerror_c(err));
+                    sys->gso = false;
+                    /* Send the rest of the batch as plain datagrams */
+                    i = firsts[i];
+                    count = datagrams;
+                    tosend = msgs;
+                    continue;
+                }
+#endif
+                msg_Err(access, "send error: %s", vlc_strerror_c(err));
+                i++; /* skip the failed message */
+                continue;
+            }
 
-        if (val < 0)
-            msg_Err(access, "send error: %s", vlc_strerror_c(errno));
-        else
-            total += val;
+            for (int j = 0; j < val; j++)
+                total += tosend[i + j].msg_len;
+            i += val;
+        }
 
         /* Free */
         do {
@@ -217,7 +367,7 @@ static const struct sout_stream_operations ops = {
 };
 
 static const char *const chain_options[] = {
-    "avformat", "dst", "sap", "name", "description", NULL
+    "avformat", "dst", "sap", "name", "description", "batch", "gso", NULL
 };
 
 #define DEFAULT_PORT 1234
@@ -315,6 +465,13 @@ static int Open(vlc_object_t *obj)
     sys->access = access;
     sys->fd = fd;
     sys->mtu = var_InheritInteger(stream, "mtu");
+    sys->batch = var_GetInteger(stream, SOUT_CFG_PREFIX "batch");
+    sys->batch = VLC_CLIP(sys->batch, 1, MAX_BATCH);
+#ifdef UDP_SEGMENT
+    sys->gso = var_GetBool(stream, SOUT_CFG_PREFIX "gso");
+#else
+    sys->gso = false;
+#endif
 
     sout_mux_t *mux = sout_MuxNew(access, muxmod);
     if (mux == NULL) {
@@ -353,6 +510,13 @@ error:
 #define DESC_TEXT N_("SAP description")
 #define DESC_LONGTEXT N_( \
     "Short description of the stream that will be announced with SAP.")
+#define BATCH_TEXT N_("Datagrams per system call")
+#define BATCH_LONGTEXT N_( \
+    "Maximum number of datagrams sent at once. Smaller values make for " \
+    "smaller bursts on the network.")
+#define GSO_TEXT N_("Segmentation offload")
+#define GSO_LONGTEXT N_( \
+    "Let the kernel split bursts of datagrams (Linux UDP GSO).")
 
 vlc_module_begin()
     set_shortname(N_("UDP"))
@@ -366,6 +530,9 @@ vlc_module_begin()
     add_bool(SOUT_CFG_PREFIX "sap", false, SAP_TEXT, SAP_LONGTEXT)
     add_string(SOUT_CFG_PREFIX "name", "", NAME_TEXT, NAME_LONGTEXT)
     add_string(SOUT_CFG_PREFIX "description", "", DESC_TEXT, DESC_LONGTEXT)
+    add_integer_with_range(SOUT_CFG_PREFIX "batch", 16, 1, MAX_BATCH,
+                           BATCH_TEXT, BATCH_LONGTEXT)
+    add_bool(SOUT_CFG_PREFIX "gso", false, GSO_TEXT, GSO_LONGTEXT)
 
     set_callback(Open)
 vlc_module_end()
@@ -33,6 +33,10 @@
 #include <vlc_picture.h>
 #include "filter_picture.h"
 
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+
 /*****************************************************************************
  * Module descriptor
  *****************************************************************************/
@@ -83,6 +87,19 @@ public:
     {
         return true;
     }
+    unsigned getX() const
+    {
+        return x;
+    }
+    /* Start of the (y + dy) row of a plane, vertically subsampled by ry */
+    uint8_t *getRow(unsigned plane, unsigned dy, unsigned ry = 1) const
+    {
+        return &picture->p[plane].p_pixels[(y + dy) / ry * picture->p[plane].i_pitch];
+    }
+    unsigned getY() const
+    {
+        return y;
+    }
 
 protected:
     template <unsigned ry>
@@ -604,6 +621,278 @@ void Blend(const CPicture &dst_data, const CPicture &src_data,
     }
 }
 
+/*****************************************************************************
+ * Row blending
+ *****************************************************************************
+ * Subtitles and OSD are blended from YUVA or RGBA pictures, mostly onto
+ * 8-bits 4:2:0 or 32-bits RGB pictures. For those, chunks of source rows are
+ * first converted to the layout of the destination, then blended in one go
+ * with vectorised code. The results are the same as with Blend().
+ *****************************************************************************/
+#define BLEND_CHUNK 256u
+
+static void BlendBytesC(uint8_t *dst, const uint8_t *src, const uint8_t *a,
+                        unsigned count)
+{
+    /* div255() is exact on 8 bits: a null alpha leaves dst unchanged */
+    for (unsigned i = 0; i < count; i++)
+        dst[i] = div255((255 - a[i]) * dst[i] + src[i] * a[i]);
+}
+
+static void ScaleAlphaC(uint8_t *a, const uint8_t *src, unsigned count,
+                        unsigned alpha)
+{
+    for (unsigned i = 0; i < count; i++)
+        a[i] = div255(alpha * src[i]);
+}
+
+#ifdef __SSE2__
+/* All the intermediate values fit in 16 bits as long as alpha <= 255 */
+static inline __m128i Div255SSE2(__m128i v)
+{
+    const __m128i one = _mm_set1_epi16(1);
+
+    return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(_mm_srli_epi16(v, 8),
+                                                      v), one), 8);
+}
+
+static inline __m128i MergeSSE2(__m128i d, __m128i s, __m128i a)
+{
+    const __m128i max = _mm_set1_epi16(255);
+
+    return Div255SSE2(_mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(max, a), d),
+                                    _mm_mullo_epi16(s, a)));
+}
+
+static void BlendBytes(uint8_t *dst, const uint8_t *src, const uint8_t *a,
+                       unsigned count)
+{
+    const __m128i zero = _mm_setzero_si128();
+    unsigned i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        const __m128i d = _mm_loadu_si128((const __m128i *)&dst[i]);
+        const __m128i s = _mm_loadu_si128((const __m128i *)&src[i]);
+        const __m128i f = _mm_loadu_si128((const __m128i *)&a[i]);
+        const __m128i lo = MergeSSE2(_mm_unpacklo_epi8(d, zero),
+                                     _mm_unpacklo_epi8(s, zero),
+                                     _mm_unpacklo_epi8(f, zero));
+        const __m128i hi = MergeSSE2(_mm_unpackhi_epi8(d, zero),
+                                     _mm_unpackhi_epi8(s, zero),
+                                     _mm_unpackhi_epi8(f, zero));
+
+        _mm_storeu_si128((__m128i *)&dst[i], _mm_packus_epi16(lo, hi));
+    }
+    BlendBytesC(&dst[i], &src[i], &a[i], count - i);
+}
+
+static void ScaleAlpha(uint8_t *a, const uint8_t *src, unsigned count,
+                       unsigned alpha)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i f = _mm_set1_epi16(alpha);
+    unsigned i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        const __m128i s = _mm_loadu_si128((const __m128i *)&src[i]);
+        const __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), f);
+        const __m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), f);
+
+        _mm_storeu_si128((__m128i *)&a[i],
+                         _mm_packus_epi16(Div255SSE2(lo), Div255SSE2(hi)));
+    }
+    ScaleAlphaC(&a[i], &src[i], count - i, alpha);
+}
+#else
+/* Plain loops without branches, left to the compiler to vectorise */
+# define BlendBytes BlendBytesC
+# define ScaleAlpha ScaleAlphaC
+#endif
+
+namespace {
+
+/* Chunk of a YUVA or RGBA source row */
+template <bool rgba>
+class CSourceRow {
+public:
+    CSourceRow(const CPicture &src) : src(src)
+    {
+    }
+    /* Gets separate Y, U, V and A planes */
+    void getYUVA(const uint8_t *planes[4], unsigned dy, unsigned dx,
+                 unsigned count)
+    {
+        if (!rgba) {
+            for (unsigned i = 0; i < 4; i++)
+                planes[i] = &src.getRow(i, dy)[src.getX() + dx];
+            return;
+        }
+
+        const uint8_t *p = &src.getRow(0, dy)[(src.getX() + dx) * 4];
+        for (unsigned i = 0; i < count; i++, p += 4) {
+            rgb_to_yuv(&yuva[0][i], &yuva[1][i], &yuva[2][i], p[0], p[1], p[2]);
+            yuva[3][i] = p[3];
+        }
+        for (unsigned i = 0; i < 4; i++)
+            planes[i] = yuva[i];
+    }
+    /* Gets colours packed in 32-bits words, shifted as given, with the
+     * remaining byte set to 255, and separate alpha */
+    void getRGB(uint32_t *rgb, const uint8_t **alpha, const unsigned shifts[4],
+                unsigned dy, unsigned dx, unsigned count)
+    {
+        const uint32_t opaque = UINT32_C(255) << shifts[3];
+
+        if (rgba) {
+            const uint8_t *p = &src.getRow(0, dy)[(src.getX() + dx) * 4];
+            for (unsigned i = 0; i < count; i++, p += 4) {
+                rgb[i] = ((uint32_t)p[0] << shifts[0]) |
+                         ((uint32_t)p[1] << shifts[1]) |
+                         ((uint32_t)p[2] << shifts[2]) | opaque;
+                yuva[3][i] = p[3];
+            }
+            *alpha = yuva[3];
+            return;
+        }
+
+        const uint8_t *planes[4];
+        getYUVA(planes, dy, dx, count);
+        for (unsigned i = 0; i < count; i++) {
+            int r, g, b;
+            yuv_to_rgb(&r, &g, &b, planes[0][i], planes[1][i], planes[2][i]);
+            rgb[i] = ((uint32_t)r << shifts[0]) | ((uint32_t)g << shifts[1]) |
+                     ((uint32_t)b << shifts[2]) | opaque;
+        }
+        *alpha = planes[3];
+    }
+private:
+    const CPicture &src;
+    uint8_t yuva[4][BLEND_CHUNK];
+};
+
+} // namespace
+
+/* YUVA or RGBA onto 8-bits I420, YV12, NV12 or NV21 */
+template <bool rgba, bool semiplanar, bool swap_uv>
+void BlendRows420(const CPicture &dst, const CPicture &src_data,
+                  unsigned width, unsigned height, int alpha)
+{
+    CSourceRow<rgba> src(src_data);
+    const unsigned x = dst.getX();
+
+    for (unsigned dy = 0; dy < height; dy++) {
+        const bool has_chroma = ((dst.getY() + dy) % 2) == 0;
+
+        for (unsigned dx = 0; dx < width; dx += BLEND_CHUNK) {
+            const unsigned count = __MIN(width - dx, BLEND_CHUNK);
+            const uint8_t *planes[4];
+            uint8_t a[BLEND_CHUNK];
+
+            src.getYUVA(planes, dy, dx, count);
+            ScaleAlpha(a, planes[3], count, alpha);
+            BlendBytes(&dst.getRow(0, dy)[x + dx], planes[0], a, count);
+            if (!has_chroma)
+                continue;
+
+            /* Chroma is blended with the even pixels, as chunks are even */
+            const unsigned first = (x + dx) % 2;
+            const unsigned chroma_count = (count - first + 1) / 2;
+            const unsigned chroma_x = (x + dx + first) / 2;
+            uint8_t u[BLEND_CHUNK / 2], v[BLEND_CHUNK / 2];
+            uint8_t ca[BLEND_CHUNK / 2];
+
+            for (unsigned i = 0; i < chroma_count; i++) {
+                u[i] = planes[1][first + 2 * i];
+                v[i] = planes[2][first + 2 * i];
+                ca[i] = a[first + 2 * i];
+            }
+
+            if (semiplanar) {
+                uint8_t uv[BLEND_CHUNK], uva[BLEND_CHUNK];
+
+                for (unsigned i = 0; i < chroma_count; i++) {
+                    uv[2 * i +  swap_uv] = u[i];
+                    uv[2 * i + !swap_uv] = v[i];
+                    uva[2 * i] = uva[2 * i + 1] = ca[i];
+                }
+                BlendBytes(&dst.getRow(1, dy, 2)[2 * chroma_x], uv, uva,
+                           2 * chroma_count);
+            } else {
+                BlendBytes(&dst.getRow(swap_uv ? 2 : 1, dy, 2)[chroma_x], u,
+                           ca, chroma_count);
+                BlendBytes(&dst.getRow(swap_uv ? 1 : 2, dy, 2)[chroma_x], v,
+                           ca, chroma_count);
+            }
+        }
+    }
+}
+
+/* YUVA or RGBA onto 32-bits RGB, with or without alpha */
+template <bool rgba>
+void BlendRowsRGB32(const CPicture &dst, const CPicture &src_data,
+                    unsigned width, unsigned height, int alpha)
+{
+    CSourceRow<rgba> src(src_data);
+    int offsets[4];
+
+    if (GetPackedRgbIndexes(dst.getFormat()->i_chroma, &offsets[0],
+                            &offsets[1], &offsets[2], &offsets[3]))
+        vlc_assert_unreachable();
+
+    const bool has_alpha = offsets[3] != -1;
+    /* The padding byte of RGBX formats is never modified */
+    if (!has_alpha)
+        offsets[3] = 6 - offsets[0] - offsets[1] - offsets[2];
+
+    /* Pixels are handled as 32-bits words, the byte order of which depends
+     * on the endianness */
+    unsigned shifts[4];
+    for (unsigned i = 0; i < 4; i++)
+#ifdef WORDS_BIGENDIAN
+        shifts[i] = 8 * (3 - offsets[i]);
+#else
+        shifts[i] = 8 * offsets[i];
+#endif
+    const uint32_t colour_mask = (UINT32_C(1) << shifts[0]) |
+                                 (UINT32_C(1) << shifts[1]) |
+                                 (UINT32_C(1) << shifts[2]);
+    const uint32_t blend_mask = colour_mask |
+                                (has_alpha ? UINT32_C(1) << shifts[3] : 0);
+
+    for (unsigned dy = 0; dy < height; dy++) {
+        for (unsigned dx = 0; dx < width; dx += BLEND_CHUNK) {
+            const unsigned count = __MIN(width - dx, BLEND_CHUNK);
+            uint8_t *p = &dst.getRow(0, dy)[(dst.getX() + dx) * 4];
+            uint32_t rgb[BLEND_CHUNK], f[BLEND_CHUNK];
+            uint8_t a[BLEND_CHUNK];
+            const uint8_t *src_a;
+
+            src.getRGB(rgb, &src_a, shifts, dy, dx, count);
+            if (has_alpha) {
+                ScaleAlpha(a, src_a, count, alpha);
+
+                /* First blend the existing colour based on its alpha with
+                 * the incoming colour, as CPictureRGBX::merge() */
+                for (unsigned i = 0; i < count; i++) {
+                    const uint32_t dst_f = a[i] ? 255 - p[4 * i + offsets[3]]
+                                                : 0;
+                    f[i] = dst_f * colour_mask;
+                }
+                BlendBytes(p, (const uint8_t *)rgb, (const uint8_t *)f,
+                           4 * count);
+            } else {
+                /* Opaque source, as with convertAddOpaque */
+                memset(a, div255(alpha * 255), count);
+            }
+
+            /* Then blend the new colour, and the alpha with full opacity */
+            for (unsigned i = 0; i < count; i++)
+                f[i] = a[i] * blend_mask;
+            BlendBytes(p, (const uint8_t *)rgb, (const uint8_t *)f, 4 * count);
+        }
+    }
+}
+
 typedef void (*blend_function_t)(const CPicture &dst_data, const CPicture &src_data,
                                  unsigned width, unsigned height, int alpha);
 
@@ -624,6 +913,14 @@ static const struct {
     { csp, VLC_CODEC_YUVA, Blend<picture, CPictureYUVA, compose<cvt, convertNone> > }, \
     { csp, VLC_CODEC_RGBA, Blend<picture, CPictureRGBA, compose<cvt, convertRgbToYuv8> > }, \
     { csp, VLC_CODEC_YUVP, Blend<picture, CPictureYUVP, compose<cvt, convertYuvpToYuva8> > }
+#define RGB32(csp, picture, cvt) \
+    { csp, VLC_CODEC_YUVA, BlendRowsRGB32<false> }, \
+    { csp, VLC_CODEC_RGBA, BlendRowsRGB32<true> }, \
+    { csp, VLC_CODEC_YUVP, Blend<picture, CPictureYUVP, compose<cvt, convertYuvpToRgba> > }
+#define YUV420(csp, picture, semiplanar, swap_uv) \
+    { csp, VLC_CODEC_YUVA, BlendRows420<false, semiplanar, swap_uv> }, \
+    { csp, VLC_CODEC_RGBA, BlendRows420<true, semiplanar, swap_uv> }, \
+    { csp, VLC_CODEC_YUVP, Blend<picture, CPictureYUVP, compose<convertNone, convertYuvpToYuva8> > }
 
     RGB(VLC_CODEC_RGB555,   CPictureRGB16,    convertRgbToRgbSmall),
     RGB(VLC_CODEC_BGR555,   CPictureRGB16,    convertRgbToRgbSmall),
@@ -631,23 +928,23 @@ static const struct {
     RGB(VLC_CODEC_BGR565,   CPictureRGB16,    convertRgbToRgbSmall),
     RGB(VLC_CODEC_RGB24,    CPictureRGB24,    convertNone),
     RGB(VLC_CODEC_BGR24,    CPictureRGB24,    convertNone),
-    RGB(VLC_CODEC_RGBA,     CPictureRGBA,     convertNone),
-    RGB(VLC_CODEC_ARGB,     CPictureRGBA,     convertNone),
-    RGB(VLC_CODEC_BGRA,     CPictureBGRA,     convertNone),
-    RGB(VLC_CODEC_ABGR,     CPictureBGRA,     convertNone),
-    RGB(VLC_CODEC_RGBX,     CPictureRGB32,    convertAddOpaque),
-    RGB(VLC_CODEC_XRGB,     CPictureRGB32,    convertAddOpaque),
-    RGB(VLC_CODEC_BGRX,     CPictureRGB32,    convertAddOpaque),
-    RGB(VLC_CODEC_XBGR,     CPictureRGB32,    convertAddOpaque),
+    RGB32(VLC_CODEC_RGBA,   CPictureRGBA,     convertNone),
+    RGB32(VLC_CODEC_ARGB,   CPictureRGBA,     convertNone),
+    RGB32(VLC_CODEC_BGRA,   CPictureBGRA,     convertNone),
+    RGB32(VLC_CODEC_ABGR,   CPictureBGRA,     convertNone),
+    RGB32(VLC_CODEC_RGBX,   CPictureRGB32,    convertAddOpaque),
+    RGB32(VLC_CODEC_XRGB,   CPictureRGB32,    convertAddOpaque),
+    RGB32(VLC_CODEC_BGRX,   CPictureRGB32,    convertAddOpaque),
+    RGB32(VLC_CODEC_XBGR,   CPictureRGB32,    convertAddOpaque),
 
     YUV(VLC_CODEC_I410,     CPictureI410_8,   convertNone),
 
     YUV(VLC_CODEC_I411,     CPictureI411_8,   convertNone),
 
-    YUV(VLC_CODEC_YV12,     CPictureYV12,     convertNone),
-    YUV(VLC_CODEC_NV12,     CPictureNV12,     convertNone),
-    YUV(VLC_CODEC_NV21,     CPictureNV21,     convertNone),
-    YUV(VLC_CODEC_I420,     CPictureI420_8,   convertNone),
+    YUV420(VLC_CODEC_YV12,  CPictureYV12,     false, true),
+    YUV420(VLC_CODEC_NV12,  CPictureNV12,     true,  false),
+    YUV420(VLC_CODEC_NV21,  CPictureNV21,     true,  true),
+    YUV420(VLC_CODEC_I420,  CPictureI420_8,   false, false),
 #ifdef WORDS_BIGENDIAN
     YUV(VLC_CODEC_I420_9B,  CPictureI420_16,  convert8To9Bits),
     YUV(VLC_CODEC_I420_10B, CPictureI420_16,  convert8To10Bits),
@@ -684,7 +981,9 @@ static const struct {
     YUV(VLC_CODEC_VYUY,     CPictureVYUY,     convertNone),
 
 #undef RGB
+#undef RGB32
 #undef YUV
+#undef YUV420
 };
 
 struct filter_sys_t {
@@ -289,6 +289,12 @@ static int Mouse( filter_t *p_filter,
                                     "in the Phosphor framerate doubler. "\
                                     "Default: Low.")
 
+#define THREADS_TEXT N_("Threads")
+#define THREADS_LONGTEXT N_("Number of threads rendering slices of each "\
+                            "picture with the Yadif and X algorithms, "\
+                            "0 meaning auto. The output does not depend "\
+                            "on it.")
+
 vlc_module_begin ()
     set_description( N_("Deinterlacing video filter") )
     set_shortname( N_("Deinterlace" ))
@@ -306,6 +312,10 @@ vlc_module_begin ()
                 PHOSPHOR_DIMMER_LONGTEXT )
         change_integer_list( phosphor_dimmer_list, phosphor_dimmer_list_text )
         change_safe ()
+    add_integer_with_range( FILTER_CFG_PREFIX "threads", 0, 0,
+                            DEINTERLACE_MAX_THREADS, THREADS_TEXT,
+                            THREADS_LONGTEXT )
+        change_safe ()
     set_deinterlace_callback( Open )
 vlc_module_end ()
 
@@ -320,7 +330,7 @@ vlc_module_end ()
  * and reading logic for them implemented in Open().
  */
 static const char *const ppsz_filter_options[] = {
-    "mode", "phosphor-chroma", "phosphor-dimmer",
+    "mode", "phosphor-chroma", "phosphor-dimmer", "threads",
     NULL
 };
 
@@ -479,8 +489,12 @@ int Mouse( filter_t *p_filter,
  */
 static void Close( filter_t *p_filter )
 {
+    filter_sys_t *p_sys = p_filter->p_sys;
+
     Flush( p_filter );
-    free( p_filter->p_sys );
+    if( p_sys->executor != NULL )
+        vlc_executor_Delete( p_sys->executor );
+    free( p_sys );
 }
 
 static const struct vlc_filter_operations filter_ops = {
@@ -504,7 +518,7 @@ int Open( filter_t *p_filter )
 
     const vlc_fourcc_t fourcc = p_filter->fmt_in.video.i_chroma;
     const vlc_chroma_description_t *chroma = vlc_fourcc_GetChromaDescription( fourcc );
-    if( chroma == NULL || chroma->pixel_size > 2 )
+    if( chroma == NULL || chroma->pixel_size == 0 || chroma->pixel_size > 2 )
     {
 notsupp:
         msg_Dbg( p_filter, "unsupported chroma %4.4s", (char*)&fourcc );
@@ -538,11 +552,17 @@ notsupp:
         return VLC_ENOMEM;
 
     p_sys->chroma = chroma;
+    p_sys->executor = NULL;
 
     InitDeinterlacingContext( &p_sys->context );
 
     config_ChainParse( p_filter, FILTER_CFG_PREFIX, ppsz_filter_options,
                        p_filter->p_cfg );
+
+    int i_threads = var_InheritInteger( p_filter, FILTER_CFG_PREFIX "threads" );
+    if( i_threads <= 0 )
+        i_threads = vlc_GetCPUCount();
+    p_sys->i_threads = __MIN( (unsigned)i_threads, DEINTERLACE_MAX_THREADS );
     char *psz_mode = var_InheritString( p_filter, FILTER_CFG_PREFIX "mode" );
     int ret = SetFilterMethod( p_filter, psz_mode, packed );
     if (ret != VLC_SUCCESS)
@@ -554,26 +574,25 @@ notsupp:
 
     IVTCClearState( p_filter );
 
+    /* ISA plugins (e.g. AVX2) take precedence over the built-in SIMD */
+    vlc_CPU_functions_init_once("deinterlace functions", &funcs);
+    p_sys->pf_merge = funcs.merges[stdc_trailing_zeros(pixel_size)];
+#if defined(__i386__) || defined(__x86_64__)
+    p_sys->pf_end_merge = NULL;
+#endif
+
 #if defined(CAN_COMPILE_C_ALTIVEC)
-    if( pixel_size == 1 && vlc_CPU_ALTIVEC() )
+    if( p_sys->pf_merge == Merge8BitGeneric && vlc_CPU_ALTIVEC() )
         p_sys->pf_merge = MergeAltivec;
-    else
 #endif
 #if defined(CAN_COMPILE_SSE2)
-    if( vlc_CPU_SSE2() )
+    if( ( p_sys->pf_merge == Merge8BitGeneric ||
+          p_sys->pf_merge == Merge16BitGeneric ) && vlc_CPU_SSE2() )
     {
         p_sys->pf_merge = pixel_size == 1 ? Merge8BitSSE2 : Merge16BitSSE2;
         p_sys->pf_end_merge = EndSSE;
     }
-    else
-#endif
-    {
-        vlc_CPU_functions_init_once("deinterlace functions", &funcs);
-        p_sys->pf_merge = funcs.merges[stdc_trailing_zeros(pixel_size)];
-#if defined(__i386__) || defined(__x86_64__)
-        p_sys->pf_end_merge = NULL;
 #endif
-    }
 
     /* */
     video_format_t fmt;
@@ -33,6 +33,7 @@ struct picture_t;
 struct vlc_object_t;
 
 #include <vlc_common.h>
+#include <vlc_executor.h>
 #include <vlc_mouse.h>
 
 /* Local algorithm headers */
@@ -57,6 +58,9 @@ static const char *const mode_list_text[] = {
     N_("Discard"), N_("Blend"), N_("Mean"), N_("Bob"), N_("Linear"), "X",
     "Yadif", "Yadif (2x)", N_("Phosphor"), N_("Film NTSC (IVTC)") };
 
+/** Maximum number of threads rendering slices of a picture. */
+#define DEINTERLACE_MAX_THREADS 16
+
 /*****************************************************************************
  * Data structures
  *****************************************************************************/
@@ -77,6 +81,11 @@ typedef struct
 
     struct deinterlace_ctx   context;
 
+    /** Number of threads rendering slices, including the calling thread */
+    unsigned i_threads;
+    /** Worker threads for RenderSlices(), NULL until first needed */
+    vlc_executor_t *executor;
+
     /* Algorithm-specific substructures */
     union {
         phosphor_sys_t phosphor; /**< Phosphor algorithm state. */
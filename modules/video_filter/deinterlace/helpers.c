@@ -29,6 +29,7 @@
 
 #include <vlc_common.h>
 #include <vlc_cpu.h>
+#include <vlc_executor.h>
 #include <vlc_filter.h>
 #include <vlc_picture.h>
 
@@ -452,3 +453,96 @@ int CalculateInterlaceScore( const picture_t* p_pic_top,
     return i_score;
 }
 #undef T
+
+/*****************************************************************************
+ * Slice rendering
+ *****************************************************************************/
+
+/* Below this, the synchronisation costs more than what threads bring */
+#define SLICE_MIN_LINES 32
+
+struct slice_task
+{
+    struct vlc_runnable runnable;
+    render_slice_t pf_slice;
+    void *opaque;
+    int i_plane;
+    int i_start;
+    int i_end;
+    vlc_sem_t *p_done;
+};
+
+static void RunSlice( void *userdata )
+{
+    struct slice_task *task = userdata;
+
+    task->pf_slice( task->opaque, task->i_plane, task->i_start, task->i_end );
+    if( task->p_done != NULL )
+        vlc_sem_post( task->p_done );
+}
+
+void RenderSlices( filter_t *p_filter, const picture_t *p_dst, int i_align,
+                   render_slice_t pf_slice, void *opaque )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+    struct slice_task tasks[DEINTERLACE_MAX_THREADS * PICTURE_PLANE_MAX];
+    unsigned i_tasks = 0;
+    vlc_sem_t done;
+
+    assert( i_align > 0 );
+
+    /* Threads are only started for the algorithms rendering slices */
+    if( p_sys->executor == NULL && p_sys->i_threads > 1 )
+    {
+        p_sys->executor = vlc_executor_New( p_sys->i_threads - 1 );
+        if( unlikely(p_sys->executor == NULL) )
+            p_sys->i_threads = 1;
+    }
+    vlc_sem_init( &done, 0 );
+
+    for( int i_plane = 0; i_plane < p_dst->i_planes; i_plane++ )
+    {
+        const int i_lines = p_dst->p[i_plane].i_visible_lines;
+        int i_slices = __MIN( (int)p_sys->i_threads, i_lines / SLICE_MIN_LINES );
+        if( i_slices < 1 )
+            i_slices = 1;
+
+        for( int i = 0; i < i_slices; i++ )
+        {
+            const int i_start = i_lines * i / i_slices / i_align * i_align;
+            const int i_end = i + 1 < i_slices
+                            ? i_lines * (i + 1) / i_slices / i_align * i_align
+                            : i_lines;
+            if( i_end <= i_start )
+                continue;
+
+            struct slice_task *task = &tasks[i_tasks++];
+            task->runnable.run = RunSlice;
+            task->runnable.userdata = task;
+            task->pf_slice = pf_slice;
+            task->opaque = opaque;
+            task->i_plane = i_plane;
+            task->i_start = i_start;
+            task->i_end = i_end;
+            task->p_done = NULL;
+        }
+    }
+
+    if( p_sys->executor == NULL || i_tasks < 2 )
+    {
+        for( unsigned i = 0; i < i_tasks; i++ )
+            RunSlice( &tasks[i] );
+        return;
+    }
+
+    /* The first slice is rendered by the calling thread */
+    for( unsigned i = 1; i < i_tasks; i++ )
+    {
+        tasks[i].p_done = &done;
+        vlc_executor_Submit( p_sys->executor, &tasks[i].runnable );
+    }
+    RunSlice( &tasks[0] );
+
+    for( unsigned i = 1; i < i_tasks; i++ )
+        vlc_sem_wait( &done );
+}
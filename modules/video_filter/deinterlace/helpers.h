@@ -165,4 +165,47 @@ int EstimateNumBlocksWithMotion( const picture_t* p_prev,
 int CalculateInterlaceScore( const picture_t* p_pic_top,
                              const picture_t* p_pic_bot );
 
+/**
+ * Slice renderer callback for RenderSlices().
+ *
+ * Renders the lines [i_start, i_end) of the plane i_plane of the output.
+ * Slices of the same picture may be rendered concurrently, so a slice
+ * renderer may read anything from the inputs, but must not write outside
+ * its lines of the output, except for lines that no other slice writes
+ * (e.g. when duplicating the first or last line).
+ *
+ * @param opaque Private data given to RenderSlices().
+ * @param i_plane Plane index.
+ * @param i_start First line of the slice.
+ * @param i_end Line after the last line of the slice.
+ * @see RenderSlices()
+ */
+typedef void (*render_slice_t)( void *opaque, int i_plane,
+                                int i_start, int i_end );
+
+/**
+ * Helper function: renders all the planes of p_dst in horizontal slices.
+ *
+ * Each plane is split into as many slices as the filter has threads (see
+ * the "threads" option), but slices are never shorter than a few dozen
+ * lines. Slices start on multiples of i_align lines, for algorithms working
+ * on blocks of lines. The slices are spread over the worker threads of the
+ * filter, the calling thread rendering one of them, and the function returns
+ * once all of them are rendered.
+ *
+ * As slices write disjoint lines, the output does not depend on the number
+ * of threads.
+ *
+ * @param p_filter The filter instance.
+ * @param p_dst Output picture, to get the plane layout from.
+ * @param i_align Alignment of the slices, in lines. Must be > 0.
+ * @param pf_slice Slice renderer.
+ * @param opaque Private data given to pf_slice.
+ * @see render_slice_t
+ * @see RenderYadif()
+ * @see RenderX()
+ */
+void RenderSlices( filter_t *p_filter, const picture_t *p_dst, int i_align,
+                   render_slice_t pf_slice, void *opaque );
+
 #endif
@@ -869,6 +869,7 @@ int vlc_aout_stream_Play(vlc_aout_stream *stream, block_t *block)
 
     vlc_tick_t play_date = VLC_TICK_INVALID;
     vlc_tick_t system_now;
+    struct vlc_tracer *tracer = aout_stream_tracer(stream);
 
     if (stream->filters && (block->i_flags & BLOCK_FLAG_CORE_PRIVATE_FILTERED) == 0)
     {
@@ -887,11 +888,19 @@ int vlc_aout_stream_Play(vlc_aout_stream *stream, block_t *block)
             vlc_mutex_unlock (&owner->vp.lock);
         }
 
+        if (tracer != NULL)
+            vlc_tracer_TraceStreamPTS(tracer, "FILTER", stream->str_id, "IN",
+                                      prefilter_pts);
+
         block = aout_FiltersPlay(stream->filters, block, stream->sync.rate);
         if (block == NULL)
             return ret;
         assert (block->i_pts != VLC_TICK_INVALID);
 
+        if (tracer != NULL)
+            vlc_tracer_TraceStreamPTS(tracer, "FILTER", stream->str_id, "OUT",
+                                      block->i_pts);
+
         /* Re-trigger a clock convert if the filtered ts is different */
         if (prefilter_pts != block->i_pts)
             play_date = VLC_TICK_INVALID;
@@ -934,7 +943,13 @@ int vlc_aout_stream_Play(vlc_aout_stream *stream, block_t *block)
     /* Output */
     stream->sync.played = true;
     stream->timing.played_samples += block->i_nb_samples;
+
+    const vlc_tick_t pts = block->i_pts;
+    if (tracer != NULL)
+        vlc_tracer_TraceStreamPTS(tracer, "DISPLAY", stream->str_id, "IN", pts);
     aout->play(aout, block, play_date);
+    if (tracer != NULL)
+        vlc_tracer_TraceStreamPTS(tracer, "DISPLAY", stream->str_id, "OUT", pts);
 
     atomic_fetch_add_explicit(&stream->buffers_played, 1, memory_order_relaxed);
     return ret;
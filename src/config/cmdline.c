@@ -170,19 +170,24 @@ int config_LoadCmdLine( libvlc_int_t *p_this, int i_argc,
 
     /* Short options */
     i_shortopts = 0;
-    const module_config_t *pp_shortopts[256] = { NULL };
+    const struct vlc_param_entry *pp_shortopts[256] = { NULL };
     char *psz_shortopts;
 
     /*
      * Generate the longopts and shortopts structures used by getopt_long
      */
 
+    /* The options are listed from the index, without loading their items
+     * from the plugins cache */
+    size_t count;
+    const struct vlc_param_entry *entries = config_GetEntries(&count);
+
     i_opts = 0;
-    for (const vlc_plugin_t *p = vlc_plugins; p != NULL; p = p->next)
+    for (size_t i = 0; i < count; i++)
         /* count the number of exported configuration options (to allocate
          * longopts). We also need to allocate space for two options when
          * dealing with boolean to allow for --foo and --no-foo */
-        i_opts += p->conf.count + 2 * p->conf.booleans;
+        i_opts += 1 + 2 * (entries[i].type == CONFIG_ITEM_BOOL);
 
     p_longopts = vlc_alloc( i_opts + 1, sizeof(*p_longopts)  );
     if( p_longopts == NULL )
@@ -202,65 +207,57 @@ int config_LoadCmdLine( libvlc_int_t *p_this, int i_argc,
 
     /* Fill the p_longopts and psz_shortopts structures */
     i_index = 0;
-    for (const vlc_plugin_t *p = vlc_plugins; p != NULL; p = p->next)
+    for (size_t i = 0; i < count; i++)
     {
-        for (size_t i = 0; i < p->conf.size; i++)
+        const struct vlc_param_entry *entry = entries + i;
+
+        /* Add item to long options */
+        p_longopts[i_index].name = strdup( entry->name );
+        if( p_longopts[i_index].name == NULL ) continue;
+        p_longopts[i_index].flag = &flag;
+        p_longopts[i_index].val = 0;
+        p_longopts[i_index].is_obsolete = entry->obsolete;
+
+        if( CONFIG_CLASS(entry->type) != CONFIG_ITEM_BOOL )
+            p_longopts[i_index].has_arg = true;
+        else
+        /* Booleans also need --no-foo and --nofoo options */
         {
-            const struct vlc_param *param = p->conf.params + i;
-            const module_config_t *p_item = &param->item;
+            char *psz_name;
 
-            /* Ignore hints */
-            if( !CONFIG_ITEM(p_item->i_type) )
-                continue;
+            p_longopts[i_index].has_arg = false;
+            i_index++;
 
-            /* Add item to long options */
-            p_longopts[i_index].name = strdup( p_item->psz_name );
-            if( p_longopts[i_index].name == NULL ) continue;
+            if( asprintf( &psz_name, "no%s", entry->name ) == -1 )
+                continue;
+            p_longopts[i_index].name = psz_name;
+            p_longopts[i_index].has_arg = false;
+            p_longopts[i_index].is_obsolete = entry->obsolete;
             p_longopts[i_index].flag = &flag;
-            p_longopts[i_index].val = 0;
-            p_longopts[i_index].is_obsolete = param->obsolete;
-
-            if( CONFIG_CLASS(p_item->i_type) != CONFIG_ITEM_BOOL )
-                p_longopts[i_index].has_arg = true;
-            else
-            /* Booleans also need --no-foo and --nofoo options */
-            {
-                char *psz_name;
+            p_longopts[i_index].val = 1;
+            i_index++;
 
-                p_longopts[i_index].has_arg = false;
-                i_index++;
+            if( asprintf( &psz_name, "no-%s", entry->name ) == -1 )
+                continue;
+            p_longopts[i_index].name = psz_name;
+            p_longopts[i_index].has_arg = false;
+            p_longopts[i_index].is_obsolete = entry->obsolete;
+            p_longopts[i_index].flag = &flag;
+            p_longopts[i_index].val = 1;
+        }
+        i_index++;
 
-                if( asprintf( &psz_name, "no%s", p_item->psz_name ) == -1 )
-                    continue;
-                p_longopts[i_index].name = psz_name;
-                p_longopts[i_index].has_arg = false;
-                p_longopts[i_index].is_obsolete = param->obsolete;
-                p_longopts[i_index].flag = &flag;
-                p_longopts[i_index].val = 1;
-                i_index++;
-
-                if( asprintf( &psz_name, "no-%s", p_item->psz_name ) == -1 )
-                    continue;
-                p_longopts[i_index].name = psz_name;
-                p_longopts[i_index].has_arg = false;
-                p_longopts[i_index].is_obsolete = param->obsolete;
-                p_longopts[i_index].flag = &flag;
-                p_longopts[i_index].val = 1;
-            }
-            i_index++;
+        /* If item also has a short option, add it */
+        if (entry->shortname)
+        {
+            pp_shortopts[entry->shortname] = entry;
+            psz_shortopts[i_shortopts++] = entry->shortname;
 
-            /* If item also has a short option, add it */
-            if (param->shortname)
+            if( entry->type != CONFIG_ITEM_BOOL
+             && entry->shortname != 'v' )
             {
-                pp_shortopts[param->shortname] = p_item;
-                psz_shortopts[i_shortopts++] = param->shortname;
-
-                if( p_item->i_type != CONFIG_ITEM_BOOL
-                 && param->shortname != 'v' )
-                {
-                    psz_shortopts[i_shortopts] = ':';
-                    i_shortopts++;
-                }
+                psz_shortopts[i_shortopts] = ':';
+                i_shortopts++;
             }
         }
     }
@@ -346,8 +343,8 @@ int config_LoadCmdLine( libvlc_int_t *p_this, int i_argc,
         /* A short option has been recognized */
         if( i_cmd != '?' && i_cmd != ':' && pp_shortopts[i_cmd] != NULL )
         {
-            const char *name = pp_shortopts[i_cmd]->psz_name;
-            switch( CONFIG_CLASS(pp_shortopts[i_cmd]->i_type) )
+            const char *name = pp_shortopts[i_cmd]->name;
+            switch( CONFIG_CLASS(pp_shortopts[i_cmd]->type) )
             {
                 case CONFIG_ITEM_STRING:
                     var_Create( p_this, name, VLC_VAR_STRING );
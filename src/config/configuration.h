@@ -64,9 +64,31 @@ bool config_PrintHelp (libvlc_int_t *);
 void config_Lock(void);
 void config_Unlock(void);
 
+/**
+ * Configuration option, as indexed by name
+ */
+struct vlc_param_entry
+{
+    const char *name; /**< Option name */
+    struct vlc_plugin_t *owner; /**< Plug-in declaring the option */
+    uint16_t index; /**< Index of the item within the plug-in */
+    uint8_t type; /**< Item type */
+    unsigned char shortname; /**< Optional short option name */
+    bool obsolete; /**< Ignored for backward compatibility */
+};
+
 int config_SortConfig (void);
 void config_UnsortConfig (void);
 
+/**
+ * Lists the configuration options sorted by name.
+ *
+ * Unlike vlc_param_Find(), this does not load the items of the options.
+ *
+ * \param count storage for the number of options [OUT]
+ */
+const struct vlc_param_entry *config_GetEntries(size_t *count);
+
 bool config_IsSafe (const char *);
 
 /**
@@ -385,26 +385,28 @@ error:
 
 static int confcmp (const void *a, const void *b)
 {
-    const struct vlc_param *const *ca = a, *const *cb = b;
+    const struct vlc_param_entry *ca = a, *cb = b;
 
-    return strcmp ((*ca)->item.psz_name, (*cb)->item.psz_name);
+    return strcmp (ca->name, cb->name);
 }
 
 static int confnamecmp (const void *key, const void *elem)
 {
-    const struct vlc_param *const *conf = elem;
+    const struct vlc_param_entry *conf = elem;
 
-    return strcmp (key, (*conf)->item.psz_name);
+    return strcmp (key, conf->name);
 }
 
 static struct
 {
-    struct vlc_param **list;
+    struct vlc_param_entry *list;
     size_t count;
 } config = { NULL, 0 };
 
 /**
  * Index the configuration items by name for faster lookups.
+ *
+ * Items from the plugins cache are indexed without being loaded.
  */
 int config_SortConfig (void)
 {
@@ -414,13 +416,34 @@ int config_SortConfig (void)
     for (p = vlc_plugins; p != NULL; p = p->next)
         nconf += p->conf.count;
 
-    struct vlc_param **clist = vlc_alloc(nconf, sizeof (*clist));
+    struct vlc_param_entry *clist = vlc_alloc(nconf, sizeof (*clist));
     if (unlikely(clist == NULL))
         return VLC_ENOMEM;
 
     size_t index = 0;
     for (p = vlc_plugins; p != NULL; p = p->next)
     {
+#ifdef HAVE_DYNAMIC_PLUGINS
+        if (p->conf.cache != NULL)
+        {
+            const char *names = p->conf.cache;
+
+            for (size_t i = 0; i < p->conf.count; i++)
+            {
+                const struct vlc_cache_param *cached = p->conf.index + i;
+                struct vlc_param_entry *entry = clist + index++;
+
+                assert(index <= nconf);
+                entry->name = names + cached->name;
+                entry->owner = p;
+                entry->index = cached->index;
+                entry->type = cached->type;
+                entry->shortname = cached->shortname;
+                entry->obsolete = cached->obsolete;
+            }
+            continue;
+        }
+#endif
         for (size_t i = 0; i < p->conf.size; i++)
         {
             struct vlc_param *param = p->conf.params + i;
@@ -429,7 +452,15 @@ int config_SortConfig (void)
             if (!CONFIG_ITEM(item->i_type))
                 continue; /* ignore hints */
             assert(index < nconf);
-            clist[index++] = param;
+
+            struct vlc_param_entry *entry = clist + index++;
+
+            entry->name = item->psz_name;
+            entry->owner = p;
+            entry->index = i;
+            entry->type = item->i_type;
+            entry->shortname = param->shortname;
+            entry->obsolete = param->obsolete;
         }
     }
 
@@ -442,7 +473,7 @@ int config_SortConfig (void)
 
 void config_UnsortConfig (void)
 {
-    struct vlc_param **clist;
+    struct vlc_param_entry *clist;
 
     clist = config.list;
     config.list = NULL;
@@ -451,13 +482,27 @@ void config_UnsortConfig (void)
     free (clist);
 }
 
+const struct vlc_param_entry *config_GetEntries(size_t *count)
+{
+    *count = config.count;
+    return config.list;
+}
+
 struct vlc_param *vlc_param_Find(const char *name)
 {
-    struct vlc_param *const *p;
+    const struct vlc_param_entry *entry;
 
     assert(name != NULL);
-    p = bsearch (name, config.list, config.count, sizeof (*p), confnamecmp);
-    return (p != NULL) ? *p : NULL;
+    entry = bsearch (name, config.list, config.count, sizeof (*entry),
+                     confnamecmp);
+    if (entry == NULL)
+        return NULL;
+
+    /* Loads the items of the plug-in if they are still in the cache */
+    size_t size;
+    struct vlc_param *params = vlc_plugin_get_params(entry->owner, &size);
+
+    return (entry->index < size) ? params + entry->index : NULL;
 }
 
 module_config_t *config_FindConfig(const char *name)
@@ -501,9 +546,12 @@ void config_ResetAll(void)
     vlc_mutex_lock(&config_lock);
     for (vlc_plugin_t *p = vlc_plugins; p != NULL; p = p->next)
     {
-        for (size_t i = 0; i < p->conf.size; i++ )
+        size_t size;
+        struct vlc_param *params = vlc_plugin_get_params(p, &size);
+
+        for (size_t i = 0; i < size; i++ )
         {
-            struct vlc_param *param = p->conf.params + i;
+            struct vlc_param *param = params + i;
             module_config_t *p_config = &param->item;
 
             if (IsConfigIntegerType (p_config->i_type))
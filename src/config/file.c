@@ -411,8 +411,10 @@ int (config_SaveConfigFile) (libvlc_int_t *p_this)
         else
             fprintf( file, "\n\n" );
 
-        for (struct vlc_param *param = p->conf.params,
-                              *end = param + p->conf.size;
+        size_t size;
+        struct vlc_param *params = vlc_plugin_get_params(p, &size);
+
+        for (struct vlc_param *param = params, *end = param + size;
              param < end;
              param++)
         {
@@ -564,11 +564,14 @@ static bool module_match(const module_t *m, const char *pattern, bool strict)
     return false;
 }
 
-static bool plugin_show(const vlc_plugin_t *plugin)
+static bool plugin_show(vlc_plugin_t *plugin)
 {
-    for (size_t i = 0; i < plugin->conf.size; i++)
+    size_t size;
+    const struct vlc_param *params = vlc_plugin_get_params(plugin, &size);
+
+    for (size_t i = 0; i < size; i++)
     {
-        const struct vlc_param *param = plugin->conf.params + i;
+        const struct vlc_param *param = params + i;
         const module_config_t *item = &param->item;
 
         if (!CONFIG_ITEM(item->i_type))
@@ -599,7 +602,7 @@ static void Usage (libvlc_int_t *p_this, char const *psz_search)
     const bool desc = var_InheritBool(p_this, "help-verbose");
 
     /* Enumerate the config for each module */
-    for (const vlc_plugin_t *p = vlc_plugins; p != NULL; p = p->next)
+    for (vlc_plugin_t *p = vlc_plugins; p != NULL; p = p->next)
     {
         const module_t *m = p->module;
         const module_config_t *section = NULL;
@@ -625,9 +628,12 @@ static void Usage (libvlc_int_t *p_this, char const *psz_search)
             printf("  %s\n", _("This module has no options."));
 
         /* Print module options */
-        for (size_t j = 0; j < p->conf.size; j++)
+        size_t size;
+        const struct vlc_param *params = vlc_plugin_get_params(p, &size);
+
+        for (size_t j = 0; j < size; j++)
         {
-            const struct vlc_param *param = p->conf.params + j;
+            const struct vlc_param *param = params + j;
 
             if (param->obsolete)
                 continue; /* Skip removed options */
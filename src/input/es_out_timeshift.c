@@ -27,6 +27,7 @@
 # include "config.h"
 #endif
 
+#include <stdalign.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <assert.h>
@@ -36,9 +37,16 @@
 #endif
 #include <sys/stat.h>
 #include <unistd.h>
+#ifdef HAVE_MMAP
+#  include <sys/mman.h>
+#endif
+#ifdef HAVE_POSIX_FALLOCATE
+#  include <fcntl.h>
+#endif
 
 #include <vlc_common.h>
 #include <vlc_arrays.h>
+#include <vlc_atomic.h>
 #include <vlc_fs.h>
 #include <vlc_mouse.h>
 #include <vlc_es_out.h>
@@ -191,6 +199,27 @@ static_assert(offsetof(ts_cmd_t, header) == offsetof(ts_cmd_send_t, header), "in
 static_assert(offsetof(ts_cmd_t, header) == offsetof(ts_cmd_control_t, header), "invalid packing");
 static_assert(offsetof(ts_cmd_t, header) == offsetof(ts_cmd_privcontrol_t, header), "invalid packing");
 
+/* Header of a stored block, followed by its payload */
+typedef struct
+{
+    alignas(16) vlc_tick_t i_dts;
+    vlc_tick_t i_pts;
+    vlc_tick_t i_length;
+    uint32_t   i_flags;
+    unsigned   i_nb_samples;
+    size_t     i_buffer;
+} ts_storage_record_t;
+
+/* Mapping of a whole storage file, shared with the blocks read from it */
+typedef struct
+{
+    vlc_atomic_rc_t rc;
+    uint8_t *p_base;
+    size_t   i_size;
+    int      fd;
+    size_t   i_reserved; /* Bytes of the file actually allocated */
+} ts_storage_map_t;
+
 typedef struct ts_storage_t ts_storage_t;
 struct ts_storage_t
 {
@@ -202,6 +231,7 @@ struct ts_storage_t
 #endif
     size_t  i_file_max; /* Max size in bytes */
     int64_t i_file_size;/* Current size in bytes */
+    ts_storage_map_t *p_map; /* File mapping, or NULL to use the FILE handles */
     FILE    *p_filew;   /* FILE handle for data writing */
     FILE    *p_filer;   /* FILE handle for data reading */
 
@@ -243,6 +273,7 @@ typedef struct
     /* */
     ts_storage_t   *p_storage_r;
     ts_storage_t   *p_storage_w;
+    ts_storage_map_t *p_map_spare; /* Read out mapping, reused by the next storage */
 
     vlc_tick_t     i_cmd_delay;
 
@@ -297,8 +328,11 @@ static int          TsChangeRate( ts_thread_t *, float src_rate, float rate );
 
 static void         *TsRun( void * );
 
-static ts_storage_t *TsStorageNew( const char *psz_path, int64_t i_tmp_size_max );
-static void         TsStorageDelete( ts_storage_t * );
+static ts_storage_t *TsStorageNew( const char *psz_path, int64_t i_tmp_size_max,
+                                   bool b_map, ts_storage_map_t **pp_spare );
+static size_t       TsStorageRecordSize( size_t i_buffer );
+static void         TsStorageDelete( ts_storage_t *, ts_storage_map_t **pp_spare );
+static void         TsStorageMapRelease( ts_storage_map_t * );
 static void         TsStoragePack( ts_storage_t *p_storage );
 static bool         TsStorageIsFull( ts_storage_t *, const ts_cmd_t *p_cmd );
 static bool         TsStorageIsEmpty( ts_storage_t * );
@@ -980,6 +1014,7 @@ static int TsStart(struct es_out_timeshift *p_sys)
     p_ts->i_cmd_delay = 0;
     p_ts->p_storage_r = NULL;
     p_ts->p_storage_w = NULL;
+    p_ts->p_map_spare = NULL;
 
     p_sys->b_delayed = true;
     if( vlc_clone( &p_ts->thread, TsRun, p_ts ) )
@@ -1026,7 +1061,9 @@ static void TsStop( ts_thread_t *p_ts )
     }
     assert( !p_ts->p_storage_r || !p_ts->p_storage_r->p_next );
     if( p_ts->p_storage_r )
-        TsStorageDelete( p_ts->p_storage_r );
+        TsStorageDelete( p_ts->p_storage_r, NULL );
+    if( p_ts->p_map_spare )
+        TsStorageMapRelease( p_ts->p_map_spare );
     vlc_mutex_unlock( &p_ts->lock );
 
     TsDestroy( p_ts );
@@ -1037,7 +1074,22 @@ static void TsPushCmd( ts_thread_t *p_ts, ts_cmd_t *p_cmd )
 
     if( !p_ts->p_storage_w || TsStorageIsFull( p_ts->p_storage_w, p_cmd ) )
     {
-        ts_storage_t *p_storage = TsStorageNew( p_ts->psz_tmp_path, p_ts->i_tmp_size_max );
+        /* A block larger than the granularity gets a stdio storage of its
+         * own, as it does not fit in a mapping */
+        int64_t i_size = p_ts->i_tmp_size_max;
+        bool b_map = true;
+        if( p_cmd->header.i_type == C_SEND )
+        {
+            size_t i_record = TsStorageRecordSize( p_cmd->send.p_block->i_buffer );
+            if( i_record >= (size_t)i_size )
+            {
+                i_size = i_record + 1;
+                b_map = false;
+            }
+        }
+
+        ts_storage_t *p_storage = TsStorageNew( p_ts->psz_tmp_path, i_size,
+                                                b_map, &p_ts->p_map_spare );
 
         if( !p_storage )
         {
@@ -1081,7 +1133,7 @@ static int TsPopCmdLocked( ts_thread_t *p_ts, ts_cmd_t *p_cmd, bool b_flush )
         if( !p_next )
             break;
 
-        TsStorageDelete( p_ts->p_storage_r );
+        TsStorageDelete( p_ts->p_storage_r, &p_ts->p_map_spare );
         p_ts->p_storage_r = p_next;
     }
 
@@ -1284,13 +1336,123 @@ static const size_t TsStorageSizeofCommand[] =
     [C_PRIVCONTROL] = sizeof(ts_cmd_privcontrol_t)
 };
 
-static ts_storage_t *TsStorageNew( const char *psz_tmp_path, int64_t i_tmp_size_max )
+/* Records are aligned, and so are the payloads handed out from a mapping */
+#define TS_STORAGE_ALIGN alignof(ts_storage_record_t)
+
+static size_t TsStorageRecordSize( size_t i_buffer )
+{
+    return (sizeof(ts_storage_record_t) + i_buffer + TS_STORAGE_ALIGN - 1)
+           & ~(TS_STORAGE_ALIGN - 1);
+}
+
+/* The file of a mapping grows by this step as it is written */
+#define TS_STORAGE_MAP_STEP (1024 * 1024)
+
+static ts_storage_map_t *TsStorageMapNew( int fd, size_t i_size )
+{
+#if defined(HAVE_MMAP) && defined(HAVE_POSIX_FALLOCATE)
+    /* Only the address space is taken for the whole granularity: the file
+     * is allocated as it is written (see TsStorageMapReserve()) */
+    void *p_base = mmap( NULL, i_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                         fd, 0 );
+    if( p_base == MAP_FAILED )
+        return NULL;
+
+    ts_storage_map_t *p_map = malloc( sizeof (*p_map) );
+    if( unlikely(p_map == NULL) )
+    {
+        munmap( p_base, i_size );
+        return NULL;
+    }
+    vlc_atomic_rc_init( &p_map->rc );
+    p_map->p_base = p_base;
+    p_map->i_size = i_size;
+    p_map->fd = fd;
+    p_map->i_reserved = 0;
+    return p_map;
+#else
+    VLC_UNUSED(fd); VLC_UNUSED(i_size);
+    return NULL;
+#endif
+}
+
+static int TsStorageMapReserve( ts_storage_map_t *p_map, size_t i_needed )
+{
+    if( i_needed <= p_map->i_reserved )
+        return VLC_SUCCESS;
+#ifdef HAVE_POSIX_FALLOCATE
+    /* The blocks must really be allocated: writing to a sparse mapping once
+     * the filesystem is full raises SIGBUS instead of failing */
+    size_t i_reserve = (i_needed + TS_STORAGE_MAP_STEP - 1)
+                       & ~(size_t)(TS_STORAGE_MAP_STEP - 1);
+    if( i_reserve > p_map->i_size )
+        i_reserve = p_map->i_size;
+    if( posix_fallocate( p_map->fd, p_map->i_reserved,
+                         i_reserve - p_map->i_reserved ) != 0 )
+        return VLC_EGENERIC;
+    p_map->i_reserved = i_reserve;
+    return VLC_SUCCESS;
+#else
+    return VLC_EGENERIC;
+#endif
+}
+
+static void TsStorageMapRelease( ts_storage_map_t *p_map )
+{
+    if( !vlc_atomic_rc_dec( &p_map->rc ) )
+        return;
+#ifdef HAVE_MMAP
+    munmap( p_map->p_base, p_map->i_size );
+#endif
+    vlc_close( p_map->fd );
+    free( p_map );
+}
+
+/* Block pointing straight into a storage mapping */
+typedef struct
+{
+    block_t           block;
+    ts_storage_map_t *p_map;
+} ts_storage_block_t;
+
+static void TsStorageBlockRelease( block_t *p_block )
+{
+    ts_storage_block_t *p_sblock =
+        container_of( p_block, ts_storage_block_t, block );
+
+    TsStorageMapRelease( p_sblock->p_map );
+    free( p_sblock );
+}
+
+static const struct vlc_block_callbacks TsStorageBlockCbs =
+{
+    TsStorageBlockRelease,
+};
+
+static ts_storage_t *TsStorageNew( const char *psz_tmp_path, int64_t i_tmp_size_max,
+                                   bool b_map, ts_storage_map_t **pp_spare )
 {
     ts_storage_t *p_storage = malloc( sizeof (*p_storage) );
     if( unlikely(p_storage == NULL) )
         return NULL;
 
-    char *psz_file;
+    char *psz_file = NULL;
+    p_storage->p_map = NULL;
+    p_storage->p_filew = NULL;
+    p_storage->p_filer = NULL;
+#ifdef _WIN32
+    p_storage->psz_file = NULL;
+#endif
+
+    if( b_map && pp_spare != NULL && *pp_spare != NULL &&
+        (*pp_spare)->i_size == (size_t)i_tmp_size_max )
+    {
+        /* Reuse the mapping of a storage that was read out */
+        p_storage->p_map = *pp_spare;
+        *pp_spare = NULL;
+        goto done;
+    }
+
     int fd = GetTmpFile( &psz_file, psz_tmp_path );
     if( fd == -1 )
     {
@@ -1298,6 +1460,16 @@ static ts_storage_t *TsStorageNew( const char *psz_tmp_path, int64_t i_tmp_size_
         return NULL;
     }
 
+    if( b_map )
+        p_storage->p_map = TsStorageMapNew( fd, i_tmp_size_max );
+    if( p_storage->p_map != NULL )
+    {
+        vlc_unlink( psz_file );
+        free( psz_file );
+        goto done;
+    }
+
+    /* If mmap() is not implemented by the OS _or_ the filesystem... */
     p_storage->p_filew = fdopen( fd, "w+b" );
     if( p_storage->p_filew == NULL )
     {
@@ -1320,6 +1492,7 @@ static ts_storage_t *TsStorageNew( const char *psz_tmp_path, int64_t i_tmp_size_
 #else
     p_storage->psz_file = psz_file;
 #endif
+done:
     p_storage->p_next = NULL;
 
     /* */
@@ -1335,7 +1508,7 @@ static ts_storage_t *TsStorageNew( const char *psz_tmp_path, int64_t i_tmp_size_
 
     if( !p_storage->p_cmd_buf )
     {
-        TsStorageDelete( p_storage );
+        TsStorageDelete( p_storage, pp_spare );
         return NULL;
     }
     return p_storage;
@@ -1345,7 +1518,7 @@ error:
     return NULL;
 }
 
-static void TsStorageDelete( ts_storage_t *p_storage )
+static void TsStorageDelete( ts_storage_t *p_storage, ts_storage_map_t **pp_spare )
 {
     while( p_storage->p_cmd_r < p_storage->p_cmd_w )
     {
@@ -1357,6 +1530,19 @@ static void TsStorageDelete( ts_storage_t *p_storage )
     }
     free( p_storage->p_cmd_buf );
 
+    if( p_storage->p_map != NULL )
+    {
+        /* Keep the mapping for the next storage, unless blocks read from it
+         * are still in use */
+        if( pp_spare != NULL && *pp_spare == NULL &&
+            vlc_atomic_rc_get( &p_storage->p_map->rc ) == 1 )
+            *pp_spare = p_storage->p_map;
+        else
+            TsStorageMapRelease( p_storage->p_map );
+        free( p_storage );
+        return;
+    }
+
     fclose( p_storage->p_filer );
     fclose( p_storage->p_filew );
 #ifdef _WIN32
@@ -1387,7 +1573,7 @@ static bool TsStorageIsFull( ts_storage_t *p_storage, const ts_cmd_t *p_cmd )
 {
     if( p_cmd && p_cmd->header.i_type == C_SEND && p_storage->p_cmd_w )
     {
-        size_t i_size = sizeof(*p_cmd->send.p_block) + p_cmd->send.p_block->i_buffer;
+        size_t i_size = TsStorageRecordSize( p_cmd->send.p_block->i_buffer );
 
         if( p_storage->i_file_size + i_size >= p_storage->i_file_max )
             return true;
@@ -1400,6 +1586,97 @@ static bool TsStorageIsEmpty( ts_storage_t *p_storage )
     return !p_storage || p_storage->p_cmd_r >= p_storage->p_cmd_w;
 }
 
+static int TsStorageWrite( ts_storage_t *p_storage, const block_t *p_block,
+                           bool b_flush )
+{
+    const ts_storage_record_t record = {
+        .i_dts = p_block->i_dts,
+        .i_pts = p_block->i_pts,
+        .i_length = p_block->i_length,
+        .i_flags = p_block->i_flags,
+        .i_nb_samples = p_block->i_nb_samples,
+        .i_buffer = p_block->i_buffer,
+    };
+
+    if( p_storage->p_map != NULL )
+    {
+        const size_t i_size = TsStorageRecordSize( p_block->i_buffer );
+        uint8_t *p = &p_storage->p_map->p_base[p_storage->i_file_size];
+
+        if( p_storage->i_file_size + i_size > p_storage->p_map->i_size ||
+            TsStorageMapReserve( p_storage->p_map,
+                                 p_storage->i_file_size + i_size ) != VLC_SUCCESS )
+            return VLC_EGENERIC;
+
+        memcpy( p, &record, sizeof(record) );
+        if( p_block->i_buffer > 0 )
+            memcpy( &p[sizeof(record)], p_block->p_buffer, p_block->i_buffer );
+        p_storage->i_file_size += i_size;
+        return VLC_SUCCESS;
+    }
+
+    if( fwrite( &record, sizeof(record), 1, p_storage->p_filew ) != 1 )
+        return VLC_EGENERIC;
+    p_storage->i_file_size += sizeof(record);
+    if( p_block->i_buffer > 0 )
+    {
+        if( fwrite( p_block->p_buffer, p_block->i_buffer, 1, p_storage->p_filew ) != 1 )
+            return VLC_EGENERIC;
+    }
+    p_storage->i_file_size += p_block->i_buffer;
+
+    if( b_flush )
+        fflush( p_storage->p_filew );
+    return VLC_SUCCESS;
+}
+
+static block_t *TsStorageRead( ts_storage_t *p_storage, int i_offset )
+{
+    ts_storage_record_t record;
+    block_t *p_block;
+
+    if( p_storage->p_map != NULL )
+    {
+        /* Hand out the payload in place, the mapping stays alive until the
+         * block is released */
+        ts_storage_map_t *p_map = p_storage->p_map;
+        uint8_t *p = &p_map->p_base[i_offset];
+
+        memcpy( &record, p, sizeof(record) );
+
+        ts_storage_block_t *p_sblock = malloc( sizeof (*p_sblock) );
+        if( unlikely(p_sblock == NULL) )
+            return NULL;
+
+        vlc_atomic_rc_inc( &p_map->rc );
+        p_sblock->p_map = p_map;
+        p_block = block_Init( &p_sblock->block, &TsStorageBlockCbs,
+                              &p[sizeof(record)], record.i_buffer );
+    }
+    else
+    {
+        /* The storage may have been written while another one was read,
+         * without flushing */
+        if( fflush( p_storage->p_filew ) ||
+            fseek( p_storage->p_filer, i_offset, SEEK_SET ) ||
+            fread( &record, sizeof(record), 1, p_storage->p_filer ) != 1 )
+            return NULL;
+
+        p_block = block_Alloc( record.i_buffer );
+        if( p_block == NULL )
+            return NULL;
+        p_block->i_buffer = fread( p_block->p_buffer, 1, record.i_buffer,
+                                   p_storage->p_filer );
+    }
+
+    p_block->i_dts      = record.i_dts;
+    p_block->i_pts      = record.i_pts;
+    p_block->i_flags    = record.i_flags;
+    p_block->i_length   = record.i_length;
+    p_block->i_nb_samples = record.i_nb_samples;
+    return p_block;
+}
+
 static void TsStoragePushCmd( ts_storage_t *p_storage, const ts_cmd_t *p_cmd, bool b_flush )
 {
     assert( !TsStorageIsFull( p_storage, p_cmd ) );
@@ -1411,27 +1688,13 @@ static void TsStoragePushCmd( ts_storage_t *p_storage, const ts_cmd_t *p_cmd, bo
         block_t *p_block = cmd.send.p_block;
 
         cmd.send.p_block = NULL;
-        cmd.send.i_offset = ftell( p_storage->p_filew );
+        cmd.send.i_offset = p_storage->p_map != NULL ? p_storage->i_file_size
+                                                     : ftell( p_storage->p_filew );
 
-        if( fwrite( p_block, sizeof(*p_block), 1, p_storage->p_filew ) != 1 )
-        {
-            block_Release( p_block );
-            return;
-        }
-        p_storage->i_file_size += sizeof(*p_block);
-        if( p_block->i_buffer > 0 )
-        {
-            if( fwrite( p_block->p_buffer, p_block->i_buffer, 1, p_storage->p_filew ) != 1 )
-            {
-                block_Release( p_block );
-                return;
-            }
-        }
-        p_storage->i_file_size += p_block->i_buffer;
+        int i_ret = TsStorageWrite( p_storage, p_block, b_flush );
         block_Release( p_block );
-
-        if( b_flush )
-            fflush( p_storage->p_filew );
+        if( i_ret != VLC_SUCCESS )
+            return;
     }
     size_t i_cmdsize = TsStorageSizeofCommand[ cmd.header.i_type ];
     memcpy( p_storage->p_cmd_w, &cmd, i_cmdsize );
@@ -1449,29 +1712,16 @@ static void TsStoragePopCmd( ts_storage_t *p_storage, ts_cmd_t *p_cmd, bool b_fl
 
     if( p_cmd->header.i_type == C_SEND )
     {
-        block_t block;
+        block_t *p_block = NULL;
 
-        if( !b_flush &&
-            !fseek( p_storage->p_filer, p_cmd->send.i_offset, SEEK_SET ) &&
-            fread( &block, sizeof(block), 1, p_storage->p_filer ) == 1 )
-        {
-            block_t *p_block = block_Alloc( block.i_buffer );
-            if( p_block )
-            {
-                p_block->i_dts      = block.i_dts;
-                p_block->i_pts      = block.i_pts;
-                p_block->i_flags    = block.i_flags;
-                p_block->i_length   = block.i_length;
-                p_block->i_nb_samples = block.i_nb_samples;
-                p_block->i_buffer = fread( p_block->p_buffer, 1, block.i_buffer, p_storage->p_filer );
-            }
-            p_cmd->send.p_block = p_block;
-        }
-        else
+        if( !b_flush )
+            p_block = TsStorageRead( p_storage, p_cmd->send.i_offset );
+        if( p_block == NULL )
         {
             //perror( "TsStoragePopCmd" );
-            p_cmd->send.p_block = block_Alloc( 1 );
+            p_block = block_Alloc( 1 );
         }
+        p_cmd->send.p_block = p_block;
     }
 }
 
@@ -0,0 +1,174 @@
+/*****************************************************************************
+ * es_out_timeshift.c: test for the timeshift storage
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#undef NDEBUG
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+/* The storage functions are static */
+#include "../es_out_timeshift.c"
+
+const char vlc_module_name[] = MODULE_STRING;
+
+/* The storage is tested on its own, without any input thread */
+bool input_CanPaceControl(input_thread_t *input)
+{
+    (void)input;
+    return false;
+}
+
+int input_ControlPush(input_thread_t *input, int type,
+                      const input_control_param_t *param)
+{
+    (void)input; (void)type; (void)param;
+    return VLC_SUCCESS;
+}
+
+/* Larger than the steps the mappings grow by */
+#define GRANULARITY (4 * 1024 * 1024)
+/* Only used as an identifier by the commands */
+#define TEST_ES ((es_out_id_t *)(uintptr_t)0x1)
+
+static void PushBlock(ts_thread_t *ts, size_t size, unsigned index)
+{
+    block_t *block = block_Alloc(size);
+    assert(block != NULL);
+    memset(block->p_buffer, index, size);
+    block->i_dts = block->i_pts = VLC_TICK_0 + index;
+
+    ts_cmd_t cmd;
+    CmdInitSend(&cmd.send, TEST_ES, block);
+    TsPushCmd(ts, &cmd);
+}
+
+static void CheckBlock(const block_t *block, size_t size, unsigned index)
+{
+    assert(block->i_buffer == size);
+    assert(block->i_dts == VLC_TICK_0 + index);
+    assert(block->i_pts == VLC_TICK_0 + index);
+    for (size_t i = 0; i < size; i++)
+        assert(block->p_buffer[i] == (uint8_t)index);
+}
+
+static block_t *PopBlock(ts_thread_t *ts, size_t size, unsigned index)
+{
+    ts_cmd_t cmd;
+
+    vlc_mutex_lock(&ts->lock);
+    assert(TsPopCmdLocked(ts, &cmd, false) == VLC_SUCCESS);
+    vlc_mutex_unlock(&ts->lock);
+
+    assert(cmd.header.i_type == C_SEND);
+    assert(cmd.send.p_es == TEST_ES);
+    CheckBlock(cmd.send.p_block, size, index);
+    return cmd.send.p_block;
+}
+
+/* The file of a mapped storage is only allocated as it is written */
+static void CheckReserved(const ts_storage_t *storage)
+{
+    if (storage->p_map == NULL)
+        return;
+    assert(storage->p_map->i_reserved >= (size_t)storage->i_file_size);
+    assert(storage->p_map->i_reserved <
+           (size_t)storage->i_file_size + TS_STORAGE_MAP_STEP);
+}
+
+static void TestStorageSwitch(ts_thread_t *ts)
+{
+    const size_t size = 64 * 1024;
+    const unsigned count = 2 * GRANULARITY / size;
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        PushBlock(ts, size, i);
+        CheckReserved(ts->p_storage_w);
+    }
+    assert(ts->p_storage_r != ts->p_storage_w);
+
+    /* The first block outlives its storage */
+    block_t *first = PopBlock(ts, size, 0);
+    for (unsigned i = 1; i < count; i++)
+        block_Release(PopBlock(ts, size, i));
+    assert(TsStorageIsEmpty(ts->p_storage_r));
+    assert(ts->p_storage_r == ts->p_storage_w);
+    CheckBlock(first, size, 0);
+    block_Release(first);
+}
+
+static void TestLargeBlock(ts_thread_t *ts)
+{
+    const size_t small = 1000, large = 2 * GRANULARITY;
+
+    PushBlock(ts, small, 1);
+    PushBlock(ts, large, 2);
+    /* Larger than the granularity, it gets a stdio storage of its own */
+    assert(ts->p_storage_w->p_map == NULL);
+    assert(ts->p_storage_w->i_file_size >= (int64_t)large);
+    PushBlock(ts, small, 3);
+    assert(ts->p_storage_w->i_file_size < (int64_t)large);
+
+    block_Release(PopBlock(ts, small, 1));
+    block_Release(PopBlock(ts, large, 2));
+    block_Release(PopBlock(ts, small, 3));
+    assert(TsStorageIsEmpty(ts->p_storage_r));
+}
+
+static void TestCommandLimit(ts_thread_t *ts)
+{
+    const size_t size = 16;
+    const unsigned count = TS_STORAGE_COMMAND_PREALLOC * MAX_COMMAND_SIZE
+                         / TsStorageSizeofCommand[C_SEND] + 10;
+
+    /* Small blocks fill the commands before the file, the next storage
+     * must not allocate the whole granularity */
+    for (unsigned i = 0; i < count; i++)
+    {
+        PushBlock(ts, size, i);
+        CheckReserved(ts->p_storage_w);
+    }
+    assert(ts->p_storage_r != ts->p_storage_w);
+
+    for (unsigned i = 0; i < count; i++)
+        block_Release(PopBlock(ts, size, i));
+    assert(TsStorageIsEmpty(ts->p_storage_r));
+}
+
+int main(void)
+{
+    ts_thread_t *ts = calloc(1, sizeof (*ts));
+    assert(ts != NULL);
+    vlc_mutex_init(&ts->lock);
+    vlc_cond_init(&ts->wait);
+    ts->i_tmp_size_max = GRANULARITY;
+    ts->psz_tmp_path = NULL;
+
+    TestStorageSwitch(ts);
+    TestLargeBlock(ts);
+    TestCommandLimit(ts);
+
+    TsStorageDelete(ts->p_storage_r, NULL);
+    if (ts->p_map_spare != NULL)
+        TsStorageMapRelease(ts->p_map_spare);
+    TsDestroy(ts);
+    return 0;
+}
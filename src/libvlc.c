@@ -58,6 +58,7 @@
 #include <vlc_dialog.h>
 #include <vlc_keystore.h>
 #include <vlc_fs.h>
+#include <vlc_frame.h>
 #include <vlc_cpu.h>
 #include <vlc_url.h>
 #include <vlc_modules.h>
@@ -401,6 +402,8 @@ void libvlc_InternalCleanup( libvlc_int_t *p_libvlc )
         vlc_tracer_Destroy(priv->tracer);
     /* Free module bank. It is refcounted, so we call this each time  */
     module_EndBank (true);
+    /* Free the released frames kept for reuse */
+    vlc_frame_TrimCaches();
 #if defined(_WIN32) || defined(__OS2__)
     system_End( );
 #endif
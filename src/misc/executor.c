@@ -29,6 +29,8 @@
 #include <vlc_threads.h>
 #include "libvlc.h"
 
+#define PRIORITY_COUNT (VLC_EXECUTOR_PRIORITY_HIGH + 1)
+
 /**
  * An executor can spawn several threads.
  *
@@ -46,6 +48,9 @@ struct vlc_executor_thread {
 
     /** The current task executed by the thread, NULL if none */
     struct vlc_runnable *current_task;
+
+    /** Runnables submitted from this thread, one deque per priority */
+    struct vlc_list deque[PRIORITY_COUNT];
 };
 
 /**
@@ -70,46 +75,110 @@ struct vlc_executor {
     /** Wait for the executor to be idle (i.e. unfinished == 0) */
     vlc_cond_t idle_wait;
 
-    /** Queue of vlc_runnable */
-    struct vlc_list queue;
+    /** Queues of vlc_runnable submitted from outside, one per priority */
+    struct vlc_list queue[PRIORITY_COUNT];
+
+    /** Number of runnables in all the queues and deques */
+    size_t queued;
 
     /** Wait for the queue to be non-empty */
     vlc_cond_t queue_wait;
 
     /** True if executor deletion is requested */
     bool closing;
+
+    /** Statistics, protected by the lock */
+    struct vlc_executor_stats stats;
 };
 
+/** The executor thread running on the current thread, if any */
+static thread_local struct vlc_executor_thread *current_thread;
+
 static void
 QueuePush(vlc_executor_t *executor, struct vlc_runnable *runnable)
 {
     vlc_mutex_assert(&executor->lock);
 
-    vlc_list_append(&runnable->node, &executor->queue);
+    struct vlc_executor_thread *thread = current_thread;
+    struct vlc_list *queue;
+
+    /* Sub-tasks are kept on the submitting thread, for locality */
+    if (thread != NULL && thread->owner == executor)
+        queue = &thread->deque[runnable->priority];
+    else
+        queue = &executor->queue[runnable->priority];
+
+    vlc_list_append(&runnable->node, queue);
+    executor->queued++;
+    executor->stats.queued[runnable->priority]++;
     vlc_cond_signal(&executor->queue_wait);
 }
 
 static struct vlc_runnable *
-QueueTake(vlc_executor_t *executor)
+QueuePop(vlc_executor_t *executor, struct vlc_executor_thread *self,
+         unsigned priority)
+{
+    struct vlc_runnable *runnable;
+
+    /* Most recent sub-task of this thread first */
+    runnable = vlc_list_last_entry_or_null(&self->deque[priority],
+                                           struct vlc_runnable, node);
+    if (runnable)
+        return runnable;
+
+    runnable = vlc_list_first_entry_or_null(&executor->queue[priority],
+                                            struct vlc_runnable, node);
+    if (runnable)
+        return runnable;
+
+    /* Steal the oldest sub-task of another thread */
+    struct vlc_executor_thread *thread;
+    vlc_list_foreach(thread, &executor->threads, node)
+    {
+        if (thread == self)
+            continue;
+
+        runnable = vlc_list_first_entry_or_null(&thread->deque[priority],
+                                                struct vlc_runnable, node);
+        if (runnable)
+        {
+            executor->stats.stolen++;
+            return runnable;
+        }
+    }
+
+    return NULL;
+}
+
+static struct vlc_runnable *
+QueueTake(vlc_executor_t *executor, struct vlc_executor_thread *self)
 {
     vlc_mutex_assert(&executor->lock);
 
-    while (!executor->closing && vlc_list_is_empty(&executor->queue))
+    while (!executor->closing && executor->queued == 0)
         vlc_cond_wait(&executor->queue_wait, &executor->lock);
 
     if (executor->closing)
         return NULL;
 
-    struct vlc_runnable *runnable =
-        vlc_list_first_entry_or_null(&executor->queue, struct vlc_runnable,
-                                     node);
+    struct vlc_runnable *runnable = NULL;
+    for (unsigned i = PRIORITY_COUNT; runnable == NULL && i > 0; --i)
+        runnable = QueuePop(executor, self, i - 1);
+
     assert(runnable);
     vlc_list_remove(&runnable->node);
+    executor->queued--;
+    executor->stats.queued[runnable->priority]--;
 
     /* Set links to NULL to know that it has been taken by a thread in
      * vlc_executor_Cancel() */
     runnable->node.prev = runnable->node.next = NULL;
 
+    vlc_tick_t wait = vlc_tick_now() - runnable->submitted;
+    executor->stats.wait_time += wait;
+    if (wait > executor->stats.max_wait_time)
+        executor->stats.max_wait_time = wait;
+
     return runnable;
 }
 
@@ -120,21 +189,28 @@ ThreadRun(void *userdata)
     vlc_executor_t *executor = thread->owner;
 
     vlc_thread_set_name("vlc-exec-runner");
+    current_thread = thread;
 
     vlc_mutex_lock(&executor->lock);
 
     struct vlc_runnable *runnable;
     /* When the executor is closing, QueueTake() returns NULL */
-    while ((runnable = QueueTake(executor)))
+    while ((runnable = QueueTake(executor, thread)))
     {
         thread->current_task = runnable;
+        executor->stats.running++;
         vlc_mutex_unlock(&executor->lock);
 
         /* Execute the user-provided runnable, without the executor lock */
+        vlc_tick_t start = vlc_tick_now();
         runnable->run(runnable->userdata);
+        vlc_tick_t duration = vlc_tick_now() - start;
 
         vlc_mutex_lock(&executor->lock);
         thread->current_task = NULL;
+        executor->stats.running--;
+        executor->stats.completed++;
+        executor->stats.run_time += duration;
 
         vlc_thread_set_name("vlc-exec-runner");
 
@@ -160,6 +236,8 @@ SpawnThread(vlc_executor_t *executor)
 
     thread->owner = executor;
     thread->current_task = NULL;
+    for (unsigned i = 0; i < PRIORITY_COUNT; ++i)
+        vlc_list_init(&thread->deque[i]);
 
     if (vlc_clone(&thread->thread, ThreadRun, thread))
     {
@@ -168,6 +246,7 @@ SpawnThread(vlc_executor_t *executor)
     }
 
     executor->nthreads++;
+    executor->stats.threads++;
     vlc_list_append(&thread->node, &executor->threads);
 
     return VLC_SUCCESS;
@@ -188,7 +267,10 @@ vlc_executor_New(unsigned max_threads)
     executor->unfinished = 0;
 
     vlc_list_init(&executor->threads);
-    vlc_list_init(&executor->queue);
+    for (unsigned i = 0; i < PRIORITY_COUNT; ++i)
+        vlc_list_init(&executor->queue[i]);
+    executor->queued = 0;
+    memset(&executor->stats, 0, sizeof(executor->stats));
 
     vlc_cond_init(&executor->idle_wait);
     vlc_cond_init(&executor->queue_wait);
@@ -207,13 +289,20 @@ vlc_executor_New(unsigned max_threads)
 }
 
 void
-vlc_executor_Submit(vlc_executor_t *executor, struct vlc_runnable *runnable)
+vlc_executor_SubmitPriority(vlc_executor_t *executor,
+                            struct vlc_runnable *runnable,
+                            enum vlc_executor_priority priority)
 {
+    assert(priority < PRIORITY_COUNT);
+    runnable->priority = priority;
+    runnable->submitted = vlc_tick_now();
+
     vlc_mutex_lock(&executor->lock);
 
     assert(!executor->closing);
 
     QueuePush(executor, runnable);
+    executor->stats.submitted++;
 
     if (++executor->unfinished > executor->nthreads
             && executor->nthreads < executor->max_threads)
@@ -223,6 +312,13 @@ vlc_executor_Submit(vlc_executor_t *executor, struct vlc_runnable *runnable)
     vlc_mutex_unlock(&executor->lock);
 }
 
+void
+vlc_executor_Submit(vlc_executor_t *executor, struct vlc_runnable *runnable)
+{
+    vlc_executor_SubmitPriority(executor, runnable,
+                                VLC_EXECUTOR_PRIORITY_NORMAL);
+}
+
 bool
 vlc_executor_Cancel(vlc_executor_t *executor, struct vlc_runnable *runnable)
 {
@@ -235,6 +331,10 @@ vlc_executor_Cancel(vlc_executor_t *executor, struct vlc_runnable *runnable)
     if (in_queue)
     {
         vlc_list_remove(&runnable->node);
+        runnable->node.prev = runnable->node.next = NULL;
+        executor->queued--;
+        executor->stats.queued[runnable->priority]--;
+        executor->stats.canceled++;
 
         assert(executor->unfinished > 0);
         --executor->unfinished;
@@ -256,6 +356,15 @@ vlc_executor_WaitIdle(vlc_executor_t *executor)
     vlc_mutex_unlock(&executor->lock);
 }
 
+void
+vlc_executor_GetStats(vlc_executor_t *executor,
+                      struct vlc_executor_stats *stats)
+{
+    vlc_mutex_lock(&executor->lock);
+    *stats = executor->stats;
+    vlc_mutex_unlock(&executor->lock);
+}
+
 void
 vlc_executor_Delete(vlc_executor_t *executor)
 {
@@ -264,7 +373,7 @@ vlc_executor_Delete(vlc_executor_t *executor)
     executor->closing = true;
 
     /* All the tasks must be canceled on delete */
-    assert(vlc_list_is_empty(&executor->queue));
+    assert(executor->queued == 0);
 
     /* "closing" is now true, this will wake up threads */
     vlc_cond_broadcast(&executor->queue_wait);
@@ -282,8 +391,8 @@ vlc_executor_Delete(vlc_executor_t *executor)
         free(thread);
     }
 
-    /* The queue must still be empty (no runnable submitted a new runnable) */
-    assert(vlc_list_is_empty(&executor->queue));
+    /* The queues must still be empty (no runnable submitted a new runnable) */
+    assert(executor->queued == 0);
 
     /* There are no tasks anymore */
     assert(!executor->unfinished);
@@ -124,6 +124,12 @@ typedef struct chained_filter_t
     struct vlc_list node;
     vlc_mouse_t mouse;
     vlc_picture_chain_t pending;
+
+    /* Pipelined mode, protected by the chain lock */
+    vlc_thread_t thread;
+    vlc_picture_chain_t queue; /**< Input pictures waiting for the filter */
+    unsigned queue_length;
+    bool busy; /**< The filter is processing a picture */
 } chained_filter_t;
 
 /* */
@@ -140,12 +146,24 @@ struct filter_chain_t
     bool b_allow_fmt_out_change; /**< Each filter can change the output */
     const char *filter_cap; /**< Filter modules capability */
     const char *conv_cap; /**< Converter modules capability */
+
+    struct
+    {
+        unsigned depth; /**< Maximum queue length per stage, 0 if disabled */
+        bool running; /**< Stage threads are started */
+        bool stopping;
+        bool flushing;
+        vlc_mutex_t lock;
+        vlc_cond_t wait; /**< Signaled whenever a queue or stage changes */
+        vlc_picture_chain_t output; /**< Pictures out of the last stage */
+    } pipeline;
 };
 
 /**
  * Local prototypes
  */
 static void FilterDeletePictures( vlc_picture_chain_t * );
+static void FilterChainPipelineStop( filter_chain_t * );
 
 static filter_chain_t *filter_chain_NewInner( vlc_object_t *obj,
     const char *cap, const char *conv_cap, bool fmt_out_change,
@@ -166,6 +184,13 @@ static filter_chain_t *filter_chain_NewInner( vlc_object_t *obj,
     chain->b_allow_fmt_out_change = fmt_out_change;
     chain->filter_cap = cap;
     chain->conv_cap = conv_cap;
+    chain->pipeline.depth = 0;
+    chain->pipeline.running = false;
+    chain->pipeline.stopping = false;
+    chain->pipeline.flushing = false;
+    vlc_mutex_init( &chain->pipeline.lock );
+    vlc_cond_init( &chain->pipeline.wait );
+    vlc_picture_chain_Init( &chain->pipeline.output );
     return chain;
 }
 
@@ -251,6 +276,7 @@ void filter_chain_Clear( filter_chain_t *p_chain )
 void filter_chain_Delete( filter_chain_t *p_chain )
 {
     filter_chain_Clear( p_chain );
+    FilterDeletePictures( &p_chain->pipeline.output );
 
     es_format_Clean( &p_chain->fmt_in );
     if ( p_chain->vctx_in )
@@ -284,6 +310,9 @@ static filter_t *filter_chain_AppendInner( filter_chain_t *chain,
     const char *name, const char *capability, const config_chain_t *cfg,
     const es_format_t *fmt_out )
 {
+    /* The stage threads walk the list of filters */
+    FilterChainPipelineStop( chain );
+
     chained_filter_t *chained =
         vlc_custom_create( chain->obj, sizeof(*chained), "filter" );
     if( unlikely(chained == NULL) )
@@ -347,6 +376,9 @@ static filter_t *filter_chain_AppendInner( filter_chain_t *chain,
 
     vlc_mouse_Init( &chained->mouse );
     vlc_picture_chain_Init( &chained->pending );
+    vlc_picture_chain_Init( &chained->queue );
+    chained->queue_length = 0;
+    chained->busy = false;
 
     msg_Dbg( chain->obj, "Filter '%s' (%p) appended to chain (%p)",
              (name != NULL) ? name : module_GetShortName(filter->p_module),
@@ -384,6 +416,8 @@ void filter_chain_DeleteFilter( filter_chain_t *chain, filter_t *filter )
 {
     chained_filter_t *chained = container_of(filter, chained_filter_t, filter);
 
+    FilterChainPipelineStop( chain );
+
     /* Remove it from the chain */
     vlc_list_remove( &chained->node );
 
@@ -391,6 +425,7 @@ void filter_chain_DeleteFilter( filter_chain_t *chain, filter_t *filter )
 
     msg_Dbg( chain->obj, "Filter %p removed from chain", (void *)filter );
     FilterDeletePictures( &chained->pending );
+    assert( vlc_picture_chain_IsEmpty( &chained->queue ) );
 
     es_format_Clean( &filter->fmt_out );
     es_format_Clean( &filter->fmt_in );
@@ -504,8 +539,202 @@ static picture_t *FilterSingleChainedFilter( chained_filter_t *f, picture_t *p_p
     return p_pic;
 }
 
+/* Pipelined mode: each filter runs on its own thread and passes its output
+ * pictures to the queue of the next one. The queue of a stage is bounded by
+ * the chain depth: a stage only pulls a picture once there is room
+ * downstream, while the last stage always outputs to the chain so that it
+ * never waits on the caller. */
+
+static chained_filter_t *FilterChainNextStage( filter_chain_t *chain,
+                                               chained_filter_t *f )
+{
+    if( vlc_list_is_last( &f->node, &chain->filter_list ) )
+        return NULL;
+    return container_of( f->node.next, chained_filter_t, node );
+}
+
+static bool FilterChainPipelineIdle( filter_chain_t *chain )
+{
+    chained_filter_t *f;
+    vlc_list_foreach( f, &chain->filter_list, node )
+        if( f->busy || f->queue_length > 0 )
+            return false;
+    return true;
+}
+
+static void FilterChainPipelineQueue( filter_chain_t *chain,
+                                      chained_filter_t *f, picture_t *pic )
+{
+    if( f != NULL )
+    {
+        vlc_picture_chain_Append( &f->queue, pic );
+        f->queue_length++;
+    }
+    else
+        vlc_picture_chain_Append( &chain->pipeline.output, pic );
+}
+
+static void *FilterChainStageThread( void *data )
+{
+    chained_filter_t *f = data;
+    filter_chain_t *chain = f->filter.owner.sys;
+    chained_filter_t *next = FilterChainNextStage( chain, f );
+
+    vlc_thread_set_name( "vlc-filter-pipe" );
+
+    vlc_mutex_lock( &chain->pipeline.lock );
+    for( ;; )
+    {
+        while( !chain->pipeline.stopping
+            && ( f->queue_length == 0 || chain->pipeline.flushing
+              || ( next != NULL
+                && next->queue_length >= chain->pipeline.depth ) ) )
+            vlc_cond_wait( &chain->pipeline.wait, &chain->pipeline.lock );
+
+        if( chain->pipeline.stopping )
+            break;
+
+        picture_t *pic = vlc_picture_chain_PopFront( &f->queue );
+        f->queue_length--;
+        f->busy = true;
+        vlc_cond_broadcast( &chain->pipeline.wait );
+        vlc_mutex_unlock( &chain->pipeline.lock );
+
+        pic = f->filter.ops->filter_video( &f->filter, pic );
+
+        vlc_picture_chain_t outputs;
+        if( pic != NULL )
+            outputs = picture_GetAndResetChain( pic );
+        else
+            vlc_picture_chain_Init( &outputs );
+
+        vlc_mutex_lock( &chain->pipeline.lock );
+        if( chain->pipeline.flushing )
+        {
+            if( pic != NULL )
+                picture_Release( pic );
+            FilterDeletePictures( &outputs );
+        }
+        else if( pic != NULL )
+        {
+            FilterChainPipelineQueue( chain, next, pic );
+            while( !vlc_picture_chain_IsEmpty( &outputs ) )
+                FilterChainPipelineQueue( chain, next,
+                                    vlc_picture_chain_PopFront( &outputs ) );
+        }
+        f->busy = false;
+        vlc_cond_broadcast( &chain->pipeline.wait );
+    }
+    vlc_mutex_unlock( &chain->pipeline.lock );
+    return NULL;
+}
+
+static int FilterChainPipelineStart( filter_chain_t *chain )
+{
+    chained_filter_t *f;
+    vlc_list_foreach( f, &chain->filter_list, node )
+    {
+        if( vlc_clone( &f->thread, FilterChainStageThread, f ) == 0 )
+            continue;
+
+        /* Unwind the stages started so far */
+        vlc_mutex_lock( &chain->pipeline.lock );
+        chain->pipeline.stopping = true;
+        vlc_cond_broadcast( &chain->pipeline.wait );
+        vlc_mutex_unlock( &chain->pipeline.lock );
+
+        chained_filter_t *started;
+        vlc_list_foreach( started, &chain->filter_list, node )
+        {
+            if( started == f )
+                break;
+            vlc_join( started->thread, NULL );
+        }
+        chain->pipeline.stopping = false;
+        return VLC_EGENERIC;
+    }
+    chain->pipeline.running = true;
+    return VLC_SUCCESS;
+}
+
+/* Waits for all the queued pictures to go through, then joins the stages.
+ * The pictures out of the last stage are kept in the chain output. */
+static void FilterChainPipelineStop( filter_chain_t *chain )
+{
+    if( !chain->pipeline.running )
+        return;
+
+    vlc_mutex_lock( &chain->pipeline.lock );
+    while( !FilterChainPipelineIdle( chain ) )
+        vlc_cond_wait( &chain->pipeline.wait, &chain->pipeline.lock );
+    chain->pipeline.stopping = true;
+    vlc_cond_broadcast( &chain->pipeline.wait );
+    vlc_mutex_unlock( &chain->pipeline.lock );
+
+    chained_filter_t *f;
+    vlc_list_foreach( f, &chain->filter_list, node )
+        vlc_join( f->thread, NULL );
+
+    chain->pipeline.running = false;
+    chain->pipeline.stopping = false;
+}
+
+static picture_t *FilterChainPipelineFilter( filter_chain_t *chain,
+                                             picture_t *pic )
+{
+    chained_filter_t *first =
+        vlc_list_first_entry_or_null( &chain->filter_list, chained_filter_t,
+                                      node );
+
+    vlc_mutex_lock( &chain->pipeline.lock );
+    if( pic != NULL )
+    {
+        /* Without filters, the picture goes straight to the output, behind
+         * the pictures left over by the stages that were removed */
+        if( first != NULL )
+            while( first->queue_length >= chain->pipeline.depth )
+                vlc_cond_wait( &chain->pipeline.wait, &chain->pipeline.lock );
+
+        FilterChainPipelineQueue( chain, first, pic );
+        vlc_cond_broadcast( &chain->pipeline.wait );
+    }
+    pic = vlc_picture_chain_PopFront( &chain->pipeline.output );
+    vlc_mutex_unlock( &chain->pipeline.lock );
+    return pic;
+}
+
+void filter_chain_SetPipelined( filter_chain_t *chain, unsigned depth )
+{
+    FilterChainPipelineStop( chain );
+    assert( vlc_picture_chain_IsEmpty( &chain->pipeline.output ) );
+    chain->pipeline.depth = depth;
+}
+
+void filter_chain_VideoDrain( filter_chain_t *chain )
+{
+    if( !chain->pipeline.running )
+        return;
+
+    vlc_mutex_lock( &chain->pipeline.lock );
+    while( !FilterChainPipelineIdle( chain ) )
+        vlc_cond_wait( &chain->pipeline.wait, &chain->pipeline.lock );
+    vlc_mutex_unlock( &chain->pipeline.lock );
+}
+
 picture_t *filter_chain_VideoFilter( filter_chain_t *p_chain, picture_t *p_pic )
 {
+    if( p_chain->pipeline.depth > 0 )
+    {
+        if( p_chain->pipeline.running
+         || vlc_list_is_empty( &p_chain->filter_list )
+         || FilterChainPipelineStart( p_chain ) == VLC_SUCCESS )
+            return FilterChainPipelineFilter( p_chain, p_pic );
+
+        msg_Warn( p_chain->obj, "cannot start the filter pipeline, "
+                  "filtering synchronously" );
+        p_chain->pipeline.depth = 0;
+    }
+
     if( p_pic )
     {
         chained_filter_t *f;
@@ -528,7 +757,9 @@ picture_t *filter_chain_VideoFilter( filter_chain_t *p_chain, picture_t *p_pic )
             continue;
 
         // iterate forward through the next filters
-        struct vlc_list_it f_it = vlc_list_it_b;
+        struct vlc_list_it f_it = {
+            &p_chain->filter_list, &b->node, b->node.next
+        };
         vlc_list_it_next(&f_it);
         for ( ; vlc_list_it_continue(&f_it); vlc_list_it_next(&f_it) )
         {
@@ -547,6 +778,23 @@ picture_t *filter_chain_VideoFilter( filter_chain_t *p_chain, picture_t *p_pic )
 void filter_chain_VideoFlush( filter_chain_t *p_chain )
 {
     chained_filter_t *f;
+
+    /* Drop the queued pictures and wait for the busy stages: the stages
+     * do not pull anything while flushing, and the caller is the only one
+     * feeding the pipeline, so the filters stay idle until the end. */
+    vlc_mutex_lock( &p_chain->pipeline.lock );
+    p_chain->pipeline.flushing = true;
+    vlc_list_foreach( f, &p_chain->filter_list, node )
+    {
+        FilterDeletePictures( &f->queue );
+        f->queue_length = 0;
+    }
+    vlc_cond_broadcast( &p_chain->pipeline.wait );
+    while( !FilterChainPipelineIdle( p_chain ) )
+        vlc_cond_wait( &p_chain->pipeline.wait, &p_chain->pipeline.lock );
+    FilterDeletePictures( &p_chain->pipeline.output );
+    vlc_mutex_unlock( &p_chain->pipeline.lock );
+
     vlc_list_foreach( f, &p_chain->filter_list, node )
     {
         filter_t *p_filter = &f->filter;
@@ -555,6 +803,11 @@ void filter_chain_VideoFlush( filter_chain_t *p_chain )
 
         filter_Flush( p_filter );
     }
+
+    vlc_mutex_lock( &p_chain->pipeline.lock );
+    p_chain->pipeline.flushing = false;
+    vlc_cond_broadcast( &p_chain->pipeline.wait );
+    vlc_mutex_unlock( &p_chain->pipeline.lock );
 }
 
 int filter_chain_MouseFilter( filter_chain_t *p_chain, vlc_mouse_t *p_dst, const vlc_mouse_t *p_src )
@@ -30,6 +30,7 @@
 #include <errno.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <limits.h>
 #ifdef _WIN32
 # include <windows.h>
 #endif
@@ -112,6 +113,189 @@ vlc_frame_t *vlc_frame_Init(vlc_frame_t *restrict f, const struct vlc_frame_call
 /** Initial reserved header and footer size. */
 #define VLC_FRAME_PADDING      32
 
+/*
+ * Frame cache
+ *
+ * Small and medium frames are allocated in one piece (header and buffer) from
+ * power-of-two size classes. On release, they are kept on a free list of the
+ * cache they were allocated from (rather than freed) up to a per-class budget,
+ * so that steady-state streaming does not hit the system allocator.
+ *
+ * Threads are spread over several caches, so that a producer (e.g. a demuxer)
+ * and a consumer (e.g. a decoder) only contend with each other.
+ */
+#if defined(__SANITIZE_ADDRESS__)
+/* Let the sanitizer catch use-after-free on frames */
+# define VLC_FRAME_CACHE_BUDGET 0
+#else
+/** Maximum bytes kept on a free list, per class and per cache */
+# define VLC_FRAME_CACHE_BUDGET (256 * 1024)
+#endif
+
+/** Smallest class capacity (shift), must fit the paddings */
+#define VLC_FRAME_CLASS_MIN_SHIFT 8
+/** Number of size classes, from 256 bytes to 64 KiB */
+#define VLC_FRAME_CLASSES         9
+#define VLC_FRAME_CACHES          16
+
+static_assert ((1 << VLC_FRAME_CLASS_MIN_SHIFT) > 2 * VLC_FRAME_PADDING,
+               "Smallest frame class too small");
+
+struct vlc_frame_cached
+{
+    vlc_frame_t frame;
+    struct vlc_frame_cached *next;
+    unsigned char cache;
+    unsigned char size_class;
+};
+
+#define VLC_FRAME_CACHED_HEADER \
+    ((sizeof (struct vlc_frame_cached) + VLC_FRAME_ALIGN - 1) \
+     & ~(size_t)(VLC_FRAME_ALIGN - 1))
+
+/* Zero-initialized, which is also VLC_STATIC_MUTEX for the locks */
+static struct vlc_frame_cache
+{
+    vlc_mutex_t lock;
+    struct vlc_frame_cached *free[VLC_FRAME_CLASSES];
+    size_t count[VLC_FRAME_CLASSES];
+    struct vlc_frame_alloc_stats stats;
+    /* Keep caches on distinct cache lines */
+    char pad[64];
+} vlc_frame_caches[VLC_FRAME_CACHES];
+
+static thread_local unsigned vlc_frame_cache_index = UINT_MAX;
+
+static struct vlc_frame_cache *vlc_frame_cache_Get(void)
+{
+    unsigned index = vlc_frame_cache_index;
+
+    if (unlikely(index == UINT_MAX))
+    {
+        static atomic_uint next = 0;
+
+        index = atomic_fetch_add_explicit(&next, 1, memory_order_relaxed)
+                % VLC_FRAME_CACHES;
+        vlc_frame_cache_index = index;
+    }
+    return &vlc_frame_caches[index];
+}
+
+static size_t vlc_frame_class_Size(unsigned size_class)
+{
+    return (size_t)1 << (VLC_FRAME_CLASS_MIN_SHIFT + size_class);
+}
+
+static void vlc_frame_cached_Release(vlc_frame_t *frame)
+{
+    struct vlc_frame_cached *c =
+        container_of(frame, struct vlc_frame_cached, frame);
+    struct vlc_frame_cache *cache = &vlc_frame_caches[c->cache];
+    const unsigned size_class = c->size_class;
+    const size_t class_size = vlc_frame_class_Size(size_class);
+
+    vlc_mutex_lock(&cache->lock);
+    cache->stats.releases++;
+    if ((cache->count[size_class] + 1) * class_size <= VLC_FRAME_CACHE_BUDGET)
+    {
+        c->next = cache->free[size_class];
+        cache->free[size_class] = c;
+        cache->count[size_class]++;
+        cache->stats.cached_frames++;
+        cache->stats.cached_bytes += class_size;
+        c = NULL;
+    }
+    vlc_mutex_unlock(&cache->lock);
+
+    aligned_free(c);
+}
+
+static const struct vlc_frame_callbacks vlc_frame_cached_cbs =
+{
+    vlc_frame_cached_Release,
+};
+
+static vlc_frame_t *vlc_frame_cached_Alloc(unsigned size_class)
+{
+    struct vlc_frame_cache *cache = vlc_frame_cache_Get();
+    const size_t class_size = vlc_frame_class_Size(size_class);
+    struct vlc_frame_cached *c;
+
+    vlc_mutex_lock(&cache->lock);
+    cache->stats.allocs++;
+    c = cache->free[size_class];
+    if (c != NULL)
+    {
+        cache->free[size_class] = c->next;
+        cache->count[size_class]--;
+        cache->stats.hits++;
+        cache->stats.cached_frames--;
+        cache->stats.cached_bytes -= class_size;
+    }
+    vlc_mutex_unlock(&cache->lock);
+
+    if (c == NULL)
+    {
+        c = aligned_alloc(VLC_FRAME_ALIGN, VLC_FRAME_CACHED_HEADER + class_size);
+        if (unlikely(c == NULL))
+            return NULL;
+
+        c->cache = cache - vlc_frame_caches;
+        c->size_class = size_class;
+    }
+
+    return vlc_frame_Init(&c->frame, &vlc_frame_cached_cbs,
+                          (unsigned char *)c + VLC_FRAME_CACHED_HEADER,
+                          class_size);
+}
+
+void vlc_frame_GetAllocStats(struct vlc_frame_alloc_stats *stats)
+{
+    memset(stats, 0, sizeof (*stats));
+
+    for (size_t i = 0; i < VLC_FRAME_CACHES; i++)
+    {
+        struct vlc_frame_cache *cache = &vlc_frame_caches[i];
+
+        vlc_mutex_lock(&cache->lock);
+        stats->allocs += cache->stats.allocs;
+        stats->hits += cache->stats.hits;
+        stats->releases += cache->stats.releases;
+        stats->cached_frames += cache->stats.cached_frames;
+        stats->cached_bytes += cache->stats.cached_bytes;
+        vlc_mutex_unlock(&cache->lock);
+    }
+}
+
+void vlc_frame_TrimCaches(void)
+{
+    for (size_t i = 0; i < VLC_FRAME_CACHES; i++)
+    {
+        struct vlc_frame_cache *cache = &vlc_frame_caches[i];
+        struct vlc_frame_cached *list[VLC_FRAME_CLASSES];
+
+        vlc_mutex_lock(&cache->lock);
+        for (size_t j = 0; j < VLC_FRAME_CLASSES; j++)
+        {
+            list[j] = cache->free[j];
+            cache->free[j] = NULL;
+            cache->count[j] = 0;
+        }
+        cache->stats.cached_frames = 0;
+        cache->stats.cached_bytes = 0;
+        vlc_mutex_unlock(&cache->lock);
+
+        for (size_t j = 0; j < VLC_FRAME_CLASSES; j++)
+            while (list[j] != NULL)
+            {
+                struct vlc_frame_cached *next = list[j]->next;
+
+                aligned_free(list[j]);
+                list[j] = next;
+            }
+    }
+}
+
 vlc_frame_t *vlc_frame_Alloc (size_t size)
 {
     if (unlikely(size >> 28))
@@ -125,6 +309,24 @@ vlc_frame_t *vlc_frame_Alloc (size_t size)
 
     /* 2 * VLC_FRAME_PADDING: pre + post padding */
     size_t capacity = (2 * VLC_FRAME_PADDING) + size;
+
+    if (capacity <= vlc_frame_class_Size(VLC_FRAME_CLASSES - 1))
+    {
+        unsigned size_class = 0;
+
+        while (vlc_frame_class_Size(size_class) < capacity)
+            size_class++;
+
+        vlc_frame_t *f = vlc_frame_cached_Alloc(size_class);
+        if (likely(f != NULL))
+        {
+            /* Header reserve */
+            f->p_buffer += VLC_FRAME_PADDING;
+            f->i_buffer = size;
+        }
+        return f;
+    }
+
     unsigned char *buf;
 #ifdef HAVE_ALIGNED_ALLOC
     capacity += (-size) % VLC_FRAME_ALIGN;
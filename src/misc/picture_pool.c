@@ -37,20 +37,42 @@
 #include <vlc_atomic.h>
 #include "picture.h"
 
-#define POOL_MAX (CHAR_BIT * sizeof (unsigned long long))
+#define POOL_WORD_BITS (CHAR_BIT * sizeof (unsigned long long))
+#define POOL_WORDS 4
+#define POOL_MAX (POOL_WORDS * POOL_WORD_BITS)
 
 static_assert ((POOL_MAX & (POOL_MAX - 1)) == 0, "Not a power of two");
 
 struct picture_pool_t {
+    /* Free pictures bitmap, claimed and returned without locking */
+    _Atomic unsigned long long available[POOL_WORDS];
+    atomic_uint        waiters;
     vlc_mutex_t lock;
     vlc_cond_t  wait;
 
-    unsigned long long available;
     vlc_atomic_rc_t    refs;
     unsigned short     picture_count;
     picture_t  *picture[];
 };
 
+static int picture_pool_TryClaim(picture_pool_t *pool)
+{
+    for (unsigned w = 0; w < POOL_WORDS; w++) {
+        unsigned long long avail = atomic_load(&pool->available[w]);
+
+        while (avail != 0) {
+            unsigned long long bit = 1ULL << stdc_trailing_zeros(avail);
+
+            if (atomic_compare_exchange_weak_explicit(&pool->available[w],
+                                                      &avail, avail & ~bit,
+                                                      memory_order_acquire,
+                                                      memory_order_relaxed))
+                return w * POOL_WORD_BITS + stdc_trailing_zeros(bit);
+        }
+    }
+    return -1;
+}
+
 static void picture_pool_Destroy(picture_pool_t *pool)
 {
     if (!vlc_atomic_rc_dec(&pool->refs))
@@ -76,11 +98,18 @@ static void picture_pool_ReleaseClone(picture_t *clone)
 
     picture_Release(picture);
 
-    vlc_mutex_lock(&pool->lock);
-    assert(!(pool->available & (1ULL << offset)));
-    pool->available |= 1ULL << offset;
-    vlc_cond_signal(&pool->wait);
-    vlc_mutex_unlock(&pool->lock);
+    unsigned long long bit = 1ULL << (offset % POOL_WORD_BITS);
+    unsigned long long prev = atomic_fetch_or(
+                                &pool->available[offset / POOL_WORD_BITS], bit);
+    assert(!(prev & bit));
+    (void) prev;
+
+    /* Only take the lock if someone may be sleeping on an empty pool */
+    if (atomic_load(&pool->waiters) > 0) {
+        vlc_mutex_lock(&pool->lock);
+        vlc_cond_signal(&pool->wait);
+        vlc_mutex_unlock(&pool->lock);
+    }
 
     picture_pool_Destroy(pool);
 }
@@ -115,10 +144,17 @@ picture_pool_t *picture_pool_New(unsigned count, picture_t *const *tab)
 
     vlc_mutex_init(&pool->lock);
     vlc_cond_init(&pool->wait);
-    if (count == POOL_MAX)
-        pool->available = ~0ULL;
-    else
-        pool->available = (1ULL << count) - 1;
+    for (unsigned w = 0; w < POOL_WORDS; w++) {
+        unsigned n = count - __MIN(count, w * POOL_WORD_BITS);
+        unsigned long long mask;
+
+        if (n >= POOL_WORD_BITS)
+            mask = ~0ULL;
+        else
+            mask = (1ULL << n) - 1;
+        atomic_init(&pool->available[w], mask);
+    }
+    atomic_init(&pool->waiters, 0);
     vlc_atomic_rc_init(&pool->refs);
     pool->picture_count = count;
     memcpy(pool->picture, tab, count * sizeof (picture_t *));
@@ -156,33 +192,30 @@ error:
 
 picture_t *picture_pool_Get(picture_pool_t *pool)
 {
-
-    vlc_mutex_lock(&pool->lock);
     assert(vlc_atomic_rc_get(&pool->refs) > 0);
 
-    if (pool->available == 0)
-    {
-        vlc_mutex_unlock(&pool->lock);
+    int i = picture_pool_TryClaim(pool);
+    if (i < 0)
         return NULL;
-    }
-
-    int i = stdc_trailing_zeros(pool->available);
-    pool->available &= ~(1ULL << i);
-    vlc_mutex_unlock(&pool->lock);
 
     return picture_pool_ClonePicture(pool, i);
 }
 
 picture_t *picture_pool_Wait(picture_pool_t *pool)
 {
-    vlc_mutex_lock(&pool->lock);
     assert(vlc_atomic_rc_get(&pool->refs) > 0);
 
-    while (pool->available == 0)
-        vlc_cond_wait(&pool->wait, &pool->lock);
+    int i = picture_pool_TryClaim(pool);
+    if (likely(i >= 0))
+        return picture_pool_ClonePicture(pool, i);
 
-    int i = stdc_trailing_zeros(pool->available);
-    pool->available &= ~(1ULL << i);
+    vlc_mutex_lock(&pool->lock);
+    /* Announce the waiter before checking again, so that a release either
+     * is seen here or sees the waiter and signals. */
+    atomic_fetch_add(&pool->waiters, 1);
+    while ((i = picture_pool_TryClaim(pool)) < 0)
+        vlc_cond_wait(&pool->wait, &pool->lock);
+    atomic_fetch_sub(&pool->waiters, 1);
     vlc_mutex_unlock(&pool->lock);
 
     return picture_pool_ClonePicture(pool, i);
@@ -57,7 +57,7 @@
 #ifdef HAVE_DYNAMIC_PLUGINS
 /* Sub-version number
  * (only used to avoid breakage in dev version when cache structure changes) */
-#define CACHE_SUBVERSION_NUM 36
+#define CACHE_SUBVERSION_NUM 37
 
 /* Cache filename */
 #define CACHE_NAME "plugins.dat"
@@ -183,6 +183,7 @@ static int vlc_cache_load_config(struct vlc_param *param, block_t *file)
 {
     module_config_t *cfg = &param->item;
 
+    LOAD_STRING (cfg->psz_name);
     LOAD_IMMEDIATE (cfg->i_type);
     LOAD_IMMEDIATE (param->shortname);
     LOAD_FLAG (param->internal);
@@ -190,7 +191,6 @@ static int vlc_cache_load_config(struct vlc_param *param, block_t *file)
     LOAD_FLAG (param->safe);
     LOAD_FLAG (param->obsolete);
     LOAD_STRING (cfg->psz_type);
-    LOAD_STRING (cfg->psz_name);
     LOAD_STRING (cfg->psz_text);
     LOAD_STRING (cfg->psz_longtext);
     LOAD_IMMEDIATE (cfg->list_count);
@@ -200,17 +200,26 @@ static int vlc_cache_load_config(struct vlc_param *param, block_t *file)
         const char *psz;
         LOAD_STRING(psz);
         cfg->orig.psz = (char *)psz;
-        atomic_init(&param->value.str, NULL);
-        vlc_param_SetString(param, psz);
+
+        /* The parameter is not visible yet: no need to synchronize with
+         * readers as vlc_param_SetString() does. */
+        char *str = NULL;
+        if (psz != NULL && psz[0] != '\0')
+        {
+            str = strdup(psz);
+            if (unlikely(str == NULL))
+                goto error;
+        }
+        atomic_init(&param->value.str, str);
+        cfg->value.psz = str;
 
         if (cfg->list_count)
             cfg->list.psz = xmalloc (cfg->list_count * sizeof (char *));
         for (unsigned i = 0; i < cfg->list_count; i++)
         {
             LOAD_STRING (cfg->list.psz[i]);
-            if (cfg->list.psz[i] == NULL /* NULL -> empty string */
-             && (cfg->list.psz[i] = calloc (1, 1)) == NULL)
-                goto error;
+            if (cfg->list.psz[i] == NULL) /* NULL -> empty string */
+                cfg->list.psz[i] = "";
         }
     }
     else
@@ -234,13 +243,13 @@ static int vlc_cache_load_config(struct vlc_param *param, block_t *file)
         LOAD_ARRAY(cfg->list.i, cfg->list_count);
     }
 
-    cfg->list_text = xmalloc (cfg->list_count * sizeof (char *));
+    if (cfg->list_count)
+        cfg->list_text = xmalloc (cfg->list_count * sizeof (char *));
     for (unsigned i = 0; i < cfg->list_count; i++)
     {
         LOAD_STRING (cfg->list_text[i]);
-        if (cfg->list_text[i] == NULL /* NULL -> empty string */
-         && (cfg->list_text[i] = calloc (1, 1)) == NULL)
-            goto error;
+        if (cfg->list_text[i] == NULL) /* NULL -> empty string */
+            cfg->list_text[i] = "";
     }
 
     return 0;
@@ -250,47 +259,86 @@ error:
 
 static int vlc_cache_load_plugin_config(vlc_plugin_t *plugin, block_t *file)
 {
-    uint16_t lines;
+    uint16_t lines, count;
+    uint32_t size;
+    const char *data;
+    const struct vlc_cache_param *index;
 
-    /* Calculate the structure length */
     LOAD_IMMEDIATE (lines);
+    LOAD_IMMEDIATE (count);
+    LOAD_IMMEDIATE (size);
 
-    /* Allocate memory */
-    if (lines)
+    /* The items are used in place, and only loaded on first use */
+    LOAD_ARRAY (data, size);
+    if (count > 0)
     {
-        plugin->conf.params = calloc(lines, sizeof (struct vlc_param));
-        if (unlikely(plugin->conf.params == NULL))
-        {
-            plugin->conf.size = 0;
-            return -1;
-        }
+        LOAD_ALIGNOF (struct vlc_cache_param);
+    }
+    LOAD_ARRAY (index, count);
+
+    if ((lines > 0) != (size > 0) || count > lines)
+        goto error;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const struct vlc_cache_param *entry = index + i;
+
+        if (entry->index >= lines || !CONFIG_ITEM(entry->type)
+         || entry->name >= size
+         || memchr(data + entry->name, '\0', size - entry->name) == NULL)
+            goto error;
+
+        if (entry->type == CONFIG_ITEM_BOOL)
+            plugin->conf.booleans++;
     }
-    else
-        plugin->conf.params = NULL;
 
     plugin->conf.size = lines;
+    plugin->conf.count = count;
+    plugin->conf.cache = data;
+    plugin->conf.cache_size = size;
+    plugin->conf.index = index;
+    return 0;
+error:
+    return -1;
+}
+
+/**
+ * Loads the configuration items of a plug-in from the cache.
+ */
+int vlc_cache_load_params(vlc_plugin_t *plugin)
+{
+    size_t lines = plugin->conf.size;
+    block_t block, *file = &block;
+
+    assert(plugin->conf.params == NULL);
+    block_Init(file, NULL, (void *)plugin->conf.cache,
+               plugin->conf.cache_size);
+
+    struct vlc_param *params = calloc(lines, sizeof (*params));
+    if (unlikely(params == NULL))
+    {
+        plugin->conf.size = 0;
+        return -1;
+    }
 
-    /* Do the duplication job */
     for (size_t i = 0; i < lines; i++)
     {
-        struct vlc_param *param = plugin->conf.params + i;
-        module_config_t *item = &param->item;
+        struct vlc_param *param = params + i;
 
         if (vlc_cache_load_config(param, file))
-            return -1;
-
-        if (CONFIG_ITEM(item->i_type))
-        {
-            plugin->conf.count++;
-            if (item->i_type == CONFIG_ITEM_BOOL)
-                plugin->conf.booleans++;
-        }
+            goto error;
         param->owner = plugin;
     }
 
+    if (file->i_buffer > 0)
+        goto error;
+
+    plugin->conf.params = params;
     return 0;
 error:
-    return -1; /* FIXME: leaks */
+    config_Free(params, lines);
+    plugin->conf.size = 0;
+    return -1;
 }
 
 static int vlc_cache_load_module(vlc_plugin_t *plugin, block_t *file)
@@ -372,6 +420,7 @@ error:
  * will in turn be queried by AllocateAllPlugins() to see if it needs to
  * actually load the dynamically loadable module.
  * This allows us to only fully load plugins when they are actually used.
+ * Likewise, configuration items are only loaded when they are looked up.
  */
 vlc_plugin_t *vlc_cache_load(libvlc_int_t *p_this, const char *dir,
                              block_t **backingp)
@@ -522,6 +571,7 @@ static int CacheSaveConfig(FILE *file, const struct vlc_param *param)
 {
     const module_config_t *cfg = &param->item;
 
+    SAVE_STRING (cfg->psz_name); /* first, see CacheSaveModuleConfig() */
     SAVE_IMMEDIATE (cfg->i_type);
     SAVE_IMMEDIATE (param->shortname);
     SAVE_FLAG (param->internal);
@@ -529,7 +579,6 @@ static int CacheSaveConfig(FILE *file, const struct vlc_param *param)
     SAVE_FLAG (param->safe);
     SAVE_FLAG (param->obsolete);
     SAVE_STRING (cfg->psz_type);
-    SAVE_STRING (cfg->psz_name);
     SAVE_STRING (cfg->psz_text);
     SAVE_STRING (cfg->psz_longtext);
     SAVE_IMMEDIATE (cfg->list_count);
@@ -563,18 +612,86 @@ error:
     return -1;
 }
 
-static int CacheSaveModuleConfig(FILE *file, const vlc_plugin_t *plugin)
+static int CacheSaveModuleConfig(FILE *file, vlc_plugin_t *plugin)
 {
-    uint16_t lines = plugin->conf.size;
+    size_t size;
+    const struct vlc_param *params = vlc_plugin_get_params(plugin, &size);
+    uint16_t lines = size;
+    uint16_t count = 0;
+    uint32_t bytes = 0;
+    uint32_t *names = NULL;
+
+    for (size_t i = 0; i < lines; i++)
+        if (CONFIG_ITEM(params[i].item.i_type))
+            count++;
 
     SAVE_IMMEDIATE (lines);
+    SAVE_IMMEDIATE (count);
 
+    long start = ftell(file);
+    if (start < 0)
+        goto error;
+    SAVE_IMMEDIATE (bytes); /* overwritten once the items are saved */
+
+    long base = start + (long)sizeof (bytes);
+
+    if (lines > 0)
+    {
+        names = vlc_alloc(lines, sizeof (*names));
+        if (unlikely(names == NULL))
+            goto error;
+    }
+
+    /* The index refers to the names by their offset within the items */
     for (size_t i = 0; i < lines; i++)
-        if (CacheSaveConfig(file, plugin->conf.params + i))
+    {
+        long offset = ftell(file) - base;
+
+        if (offset < 0)
+            goto error;
+        names[i] = offset + sizeof (uint16_t); /* skip the string size */
+
+        if (CacheSaveConfig(file, params + i))
            goto error;
+    }
+
+    long end = ftell(file);
+    if (end < base || (unsigned long)(end - base) > UINT32_MAX)
+        goto error;
+    bytes = end - base;
+
+    if (fseek(file, start, SEEK_SET))
+        goto error;
+    SAVE_IMMEDIATE (bytes);
+    if (fseek(file, end, SEEK_SET))
+        goto error;
+
+    if (count > 0)
+    {
+        SAVE_ALIGNOF(struct vlc_cache_param);
+    }
+
+    for (size_t i = 0; i < lines; i++)
+    {
+        const struct vlc_param *param = params + i;
+        struct vlc_cache_param entry;
+
+        if (!CONFIG_ITEM(param->item.i_type))
+            continue; /* ignore hints */
+
+        memset(&entry, 0, sizeof (entry)); /* clear the padding */
+        entry.name = names[i];
+        entry.index = i;
+        entry.type = param->item.i_type;
+        entry.shortname = param->shortname;
+        entry.obsolete = param->obsolete;
+        SAVE_IMMEDIATE (entry);
+    }
 
+    free(names);
     return 0;
 error:
+    free(names);
     return -1;
 }
 
@@ -623,7 +740,7 @@ static int CacheSaveBank(FILE *file, vlc_plugin_t *const *cache, size_t n)
 
     for (size_t i = 0; i < n; i++)
     {
-        const vlc_plugin_t *plugin = cache[i];
+        vlc_plugin_t *plugin = cache[i];
         uint32_t count = plugin->modules_count;
 
         SAVE_IMMEDIATE(count);
@@ -107,6 +107,10 @@ vlc_plugin_t *vlc_plugin_create(void)
     plugin->conf.count = 0;
     plugin->conf.booleans = 0;
 #ifdef HAVE_DYNAMIC_PLUGINS
+    plugin->conf.cache = NULL;
+    plugin->conf.cache_size = 0;
+    plugin->conf.index = NULL;
+    plugin->conf.once = (vlc_once_t)VLC_STATIC_ONCE;
     plugin->unloadable = true;
     atomic_init(&plugin->handle, 0);
     plugin->abspath = NULL;
@@ -132,7 +136,8 @@ void vlc_plugin_destroy(vlc_plugin_t *plugin)
     if (plugin->module != NULL)
         vlc_module_destroy(plugin->module);
 
-    config_Free(plugin->conf.params, plugin->conf.size);
+    if (plugin->conf.params != NULL) /* NULL until loaded from the cache */
+        config_Free(plugin->conf.params, plugin->conf.size);
 #ifdef HAVE_DYNAMIC_PLUGINS
     free(plugin->abspath);
     free(plugin->path);
@@ -140,6 +145,26 @@ void vlc_plugin_destroy(vlc_plugin_t *plugin)
     free(plugin);
 }
 
+#ifdef HAVE_DYNAMIC_PLUGINS
+static void vlc_plugin_load_params(void *data)
+{
+    vlc_plugin_t *plugin = data;
+
+    /* On error, the plug-in is left without items */
+    vlc_cache_load_params(plugin);
+}
+#endif
+
+struct vlc_param *vlc_plugin_get_params(vlc_plugin_t *plugin, size_t *size)
+{
+#ifdef HAVE_DYNAMIC_PLUGINS
+    if (plugin->conf.cache != NULL)
+        vlc_once(&plugin->conf.once, vlc_plugin_load_params, plugin);
+#endif
+    *size = plugin->conf.size;
+    return plugin->conf.params;
+}
+
 static struct vlc_param *vlc_config_create(vlc_plugin_t *plugin, int type)
 {
     unsigned confsize = plugin->conf.size;
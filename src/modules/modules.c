@@ -318,7 +318,7 @@ module_t *module_find (const char *name)
 
 module_config_t *module_config_get( const module_t *module, unsigned *restrict psize )
 {
-    const vlc_plugin_t *plugin = module->plugin;
+    vlc_plugin_t *plugin = module->plugin;
 
     assert( psize != NULL );
     *psize = 0;
@@ -329,7 +329,8 @@ module_config_t *module_config_get( const module_t *module, unsigned *restrict p
         return NULL;
     }
 
-    size_t size = plugin->conf.size;
+    size_t size;
+    const struct vlc_param *params = vlc_plugin_get_params(plugin, &size);
     module_config_t *config = vlc_alloc( size, sizeof( *config ) );
 
     if( !config )
@@ -338,7 +339,7 @@ module_config_t *module_config_get( const module_t *module, unsigned *restrict p
     unsigned i, j;
     for( i = 0, j = 0; i < size; i++ )
     {
-        const struct vlc_param *param = plugin->conf.params + i;
+        const struct vlc_param *param = params + i;
         const module_config_t *item = &param->item;
 
         if (param->internal /* internal option */
@@ -25,8 +25,10 @@
 
 # include <stdatomic.h>
 # include <vlc_plugin.h>
+# include <vlc_threads.h>
 
 struct vlc_param;
+struct vlc_cache_param;
 
 /** VLC plugin */
 typedef struct vlc_plugin_t
@@ -46,6 +48,13 @@ typedef struct vlc_plugin_t
         size_t size; /**< Total count of all items */
         size_t count; /**< Count of real options (excludes hints) */
         size_t booleans; /**< Count of options that are of boolean type */
+#ifdef HAVE_DYNAMIC_PLUGINS
+        /* Items from the plugins cache, loaded on first use */
+        const void *cache; /**< Serialized items (or NULL) */
+        size_t cache_size; /**< Byte size of the serialized items */
+        const struct vlc_cache_param *index; /**< Index of the real options */
+        vlc_once_t once;
+#endif
     } conf;
 
 #ifdef HAVE_DYNAMIC_PLUGINS
@@ -102,6 +111,17 @@ struct module_t
 
 vlc_plugin_t *vlc_plugin_create(void);
 void vlc_plugin_destroy(vlc_plugin_t *);
+
+/**
+ * Gets the configuration items of a plug-in.
+ *
+ * Items from the plugins cache are loaded on first use.
+ *
+ * \param size storage for the number of items [OUT]
+ * \return the table of items (or NULL if there are none)
+ */
+struct vlc_param *vlc_plugin_get_params(vlc_plugin_t *, size_t *size);
+
 module_t *vlc_module_create(vlc_plugin_t *);
 void vlc_module_destroy (module_t *);
 
@@ -177,7 +197,21 @@ void *vlc_dlsym(void *handle, const char *name) VLC_USED;
 char *vlc_dlerror(void) VLC_USED;
 
 /* Plugins cache */
+
+/**
+ * Option of a plug-in from the cache, known before its item is loaded
+ */
+struct vlc_cache_param
+{
+    uint32_t name; /**< Offset of the name within the serialized items */
+    uint16_t index; /**< Index of the item within the plug-in */
+    uint8_t type; /**< Item type */
+    unsigned char shortname; /**< Optional short option name */
+    bool obsolete; /**< Ignored for backward compatibility */
+};
+
 vlc_plugin_t *vlc_cache_load(libvlc_int_t *, const char *, block_t **);
+int vlc_cache_load_params(vlc_plugin_t *);
 vlc_plugin_t *vlc_cache_lookup(vlc_plugin_t **, const char *relpath);
 
 void CacheSave(libvlc_int_t *, const char *, vlc_plugin_t *const *, size_t);
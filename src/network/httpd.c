@@ -44,6 +44,7 @@
 #include <vlc_url.h>
 #include <vlc_mime.h>
 #include <vlc_block.h>
+#include <vlc_fs.h>
 #include "../libvlc.h"
 
 #include <string.h>
@@ -56,6 +57,9 @@
 #ifdef HAVE_POLL_H
 # include <poll.h>
 #endif
+#ifdef __linux__
+# include <sys/epoll.h>
+#endif
 
 #if defined(_WIN32)
 #   include <winsock2.h>
@@ -70,10 +74,39 @@
 #define HTTPD_CL_BUFSIZE 10000
 #endif
 
+/* Maximum number of stream blocks written to a client at once */
+#define HTTPD_CL_IOVMAX 64
+
+#ifdef __linux__
+/* Clients are spread over as many threads, up to that many */
+# define HTTPD_WORKERS_MAX 8
+#else
+# define HTTPD_WORKERS_MAX 1
+#endif
+
+struct httpd_stream_block;
+
 static void httpd_ClientDestroy(httpd_client_t *cl);
-static void httpd_AppendData(httpd_stream_t *stream, uint8_t *p_data, int i_data);
+static void httpd_ClientStreamRelease(httpd_client_t *cl);
+static void httpd_ClientStreamDetach(httpd_client_t *cl);
+
+/* each worker thread handles a share of the host clients */
+struct httpd_worker
+{
+    httpd_host_t *host;
+    vlc_thread_t thread;
+    vlc_mutex_t lock;
 
-/* each host run in his own thread */
+    size_t client_count;
+    struct vlc_list clients;
+    unsigned generation; /* bumped when another thread destroys clients */
+#ifdef __linux__
+    int epfd;
+    struct vlc_list active; /* clients to run without socket events */
+#endif
+};
+
+/* each host run in its own threads */
 struct httpd_host_t
 {
     struct vlc_object_t obj;
@@ -87,7 +120,7 @@ struct httpd_host_t
     unsigned     nfd;
     unsigned     port;
 
-    vlc_thread_t thread;
+    /* protects the urls, and serializes the url callbacks */
     vlc_mutex_t lock;
 
     /* all registered url (becarefull that 2 httpd_url_t could point at the same url)
@@ -96,8 +129,12 @@ struct httpd_host_t
      * */
     struct vlc_list urls;
 
-    size_t client_count;
-    struct vlc_list clients;
+    struct httpd_worker workers[HTTPD_WORKERS_MAX];
+    unsigned worker_count;
+    unsigned next_worker;
+#ifdef __linux__
+    int wake[2];
+#endif
     unsigned timeout_sec;
 
     /* TLS data */
@@ -144,7 +181,13 @@ struct httpd_client_t
     httpd_url_t *url;
     vlc_tls_t   *sock;
 
+    struct httpd_worker *worker;
     struct vlc_list node;
+#ifdef __linux__
+    struct vlc_list active_node;
+    bool    b_active;
+    bool    b_ready;
+#endif
 
     bool    b_stream_mode;
     uint8_t i_state;
@@ -163,6 +206,14 @@ struct httpd_client_t
      */
     int64_t i_keyframe_wait_to_pass;
 
+    /* Stream data, written in place from the stream blocks */
+    httpd_stream_t *stream;
+    struct httpd_stream_block *stream_block; /* first referenced block */
+    unsigned stream_blocks; /* number of referenced blocks */
+    struct iovec iov[HTTPD_CL_IOVMAX];
+    unsigned iov_index;
+    unsigned iov_count;
+
     /* */
     httpd_message_t query;  /* client -> httpd */
     httpd_message_t answer; /* httpd -> client */
@@ -624,6 +675,18 @@ void httpd_RedirectDelete(httpd_redirect_t *rdir)
 /*****************************************************************************
  * High Level Functions: httpd_stream_t
  *****************************************************************************/
+
+/* Stream data is stored once, and shared by all the clients: each client
+ * references the blocks it is currently sending. */
+struct httpd_stream_block
+{
+    struct httpd_stream_block *next;
+    int64_t  i_pos;     /* absolute position of the first byte */
+    size_t   i_size;
+    unsigned refs;      /* chain + clients, protected by the stream lock */
+    uint8_t  p_data[];
+};
+
 struct httpd_stream_t
 {
     vlc_mutex_t lock;
@@ -643,9 +706,10 @@ struct httpd_stream_t
     bool        b_has_keyframes;
     int64_t     i_last_keyframe_seen_pos;
 
-    /* circular buffer */
-    int         i_buffer_size;      /* buffer size, can't be reallocated smaller */
-    uint8_t     *p_buffer;          /* buffer */
+    /* data blocks, the oldest ones are dropped beyond the buffer size */
+    int         i_buffer_size;      /* buffer size */
+    struct httpd_stream_block *p_first;
+    struct httpd_stream_block **pp_last;
     int64_t     i_buffer_pos;       /* absolute position from beginning */
     int64_t     i_buffer_last_pos;  /* a new connection will start with that */
 
@@ -664,47 +728,82 @@ static int httpd_StreamCallBack(httpd_callback_sys_t *p_sys,
         return VLC_SUCCESS;
 
     if (answer->i_body_offset > 0) {
-        int     i_pos;
+        struct httpd_stream_block *block;
+        int64_t i_offset = answer->i_body_offset;
 
-        if (answer->i_body_offset >= stream->i_buffer_pos)
-            return VLC_EGENERIC;    /* wait, no data available */
+        if (cl->stream != stream)
+            httpd_ClientStreamDetach(cl);
+
+        vlc_mutex_lock(&stream->lock);
+        if (i_offset >= stream->i_buffer_pos)
+            goto wait;  /* no data available */
 
         if (cl->i_keyframe_wait_to_pass >= 0) {
             if (stream->i_last_keyframe_seen_pos <= cl->i_keyframe_wait_to_pass)
                 /* still waiting for the next keyframe */
-                return VLC_EGENERIC;
+                goto wait;
 
             /* seek to the new keyframe */
-            answer->i_body_offset = stream->i_last_keyframe_seen_pos;
+            i_offset = stream->i_last_keyframe_seen_pos;
             cl->i_keyframe_wait_to_pass = -1;
         }
 
-        if (answer->i_body_offset + stream->i_buffer_size < stream->i_buffer_pos)
-            answer->i_body_offset = stream->i_buffer_last_pos; /* this client isn't fast enough */
-
-        i_pos   = answer->i_body_offset % stream->i_buffer_size;
-        int64_t i_write = stream->i_buffer_pos - answer->i_body_offset;
-
-        if (i_write > HTTPD_CL_BUFSIZE)
-            i_write = HTTPD_CL_BUFSIZE;
-        else if (i_write <= 0)
-            return VLC_EGENERIC;    /* wait, no data available */
-
-        /* Don't go past the end of the circular buffer */
-        i_write = __MIN(i_write, stream->i_buffer_size - i_pos);
+        if (i_offset < stream->p_first->i_pos)
+            i_offset = stream->i_buffer_last_pos; /* this client isn't fast enough */
+        if (i_offset >= stream->i_buffer_pos)
+            goto wait;
+
+        /* Continue after the blocks sent last if possible, as looking the
+         * data up from the oldest block is slow with many small blocks. */
+        block = cl->stream_block;
+        if (block != NULL) {
+            for (unsigned i = 1; i < cl->stream_blocks; i++)
+                block = block->next;
+            if (block->i_pos + (int64_t)block->i_size == i_offset)
+                block = block->next;
+            else
+                block = NULL;
+        }
+        if (block == NULL) {
+            block = stream->p_first;
+            while (block->i_pos + (int64_t)block->i_size <= i_offset)
+                block = block->next;
+        }
+        assert(block != NULL && block->i_pos <= i_offset);
+
+        /* Reference the blocks rather than copy them */
+        struct httpd_stream_block *first = block;
+        size_t i_skip = i_offset - block->i_pos;
+        unsigned n = 0;
+
+        do {
+            cl->iov[n].iov_base = block->p_data + i_skip;
+            cl->iov[n].iov_len = block->i_size - i_skip;
+            i_offset += cl->iov[n].iov_len;
+            block->refs++;
+            i_skip = 0;
+            block = block->next;
+        } while (++n < HTTPD_CL_IOVMAX && block != NULL);
+
+        httpd_ClientStreamRelease(cl);
+        cl->stream = stream;
+        cl->stream_block = first;
+        cl->stream_blocks = n;
+        cl->iov_index = 0;
+        cl->iov_count = n;
+        vlc_mutex_unlock(&stream->lock);
 
         /* using HTTPD_MSG_ANSWER -> data available */
         answer->i_proto  = HTTPD_PROTO_HTTP;
         answer->i_version= 0;
         answer->i_type   = HTTPD_MSG_ANSWER;
 
-        answer->i_body = i_write;
-        answer->p_body = xmalloc(i_write);
-        memcpy(answer->p_body, &stream->p_buffer[i_pos], i_write);
-
-        answer->i_body_offset += i_write;
+        answer->i_body_offset = i_offset;
 
         return VLC_SUCCESS;
+wait:
+        vlc_mutex_unlock(&stream->lock);
+        return VLC_EGENERIC;
     } else {
         answer->i_proto  = HTTPD_PROTO_HTTP;
         answer->i_version= 0;
@@ -788,7 +887,6 @@ httpd_stream_t *httpd_StreamNew(httpd_host_t *host,
         return NULL;
 
     stream->psz_mime = NULL;
-    stream->p_buffer = NULL;
 
     stream->url = httpd_UrlNew(host, psz_url, psz_user, psz_password);
     if (!stream->url)
@@ -805,10 +903,8 @@ httpd_stream_t *httpd_StreamNew(httpd_host_t *host,
     stream->i_header = 0;
     stream->p_header = NULL;
     stream->i_buffer_size = 5000000;    /* 5 Mo per stream */
-
-    stream->p_buffer = malloc(stream->i_buffer_size);
-    if (stream->p_buffer == NULL)
-        goto error;
+    stream->p_first = NULL;
+    stream->pp_last = &stream->p_first;
 
     /* We set to 1 to make life simpler
      * (this way i_body_offset can never be 0) */
@@ -855,22 +951,43 @@ int httpd_StreamHeader(httpd_stream_t *stream, uint8_t *p_data, int i_data)
     return VLC_SUCCESS;
 }
 
-static void httpd_AppendData(httpd_stream_t *stream, uint8_t *p_data, int i_data)
+static void httpd_StreamBlockRelease(struct httpd_stream_block *block)
+{
+    assert(block->refs > 0);
+    if (--block->refs == 0)
+        free(block);
+}
+
+static void httpd_ClientStreamRelease(httpd_client_t *cl)
 {
-    int i_pos = stream->i_buffer_pos % stream->i_buffer_size;
-    int i_count = i_data;
-    while (i_count > 0) {
-        int i_copy = __MIN(i_count, stream->i_buffer_size - i_pos);
+    struct httpd_stream_block *block = cl->stream_block;
 
-        /* Ok, we can't go past the end of our buffer */
-        memcpy(&stream->p_buffer[i_pos], p_data, i_copy);
+    /* Blocks dropped from the stream are not unlinked from each other, and
+     * the ones referenced here cannot have been freed. */
+    for (unsigned i = 0; i < cl->stream_blocks; i++) {
+        struct httpd_stream_block *next = block->next;
 
-        i_pos = (i_pos + i_copy) % stream->i_buffer_size;
-        i_count -= i_copy;
-        p_data  += i_copy;
+        httpd_StreamBlockRelease(block);
+        block = next;
     }
+    cl->stream_block = NULL;
+    cl->stream_blocks = 0;
+}
+
+/* Drops the stream data references of a client, under the lock of the
+ * stream they belong to. The stream exists as long as the client uses its
+ * URL, so this must be done before the client moves to another URL. */
+static void httpd_ClientStreamDetach(httpd_client_t *cl)
+{
+    httpd_stream_t *stream = cl->stream;
+
+    if (stream == NULL)
+        return;
 
-    stream->i_buffer_pos += i_data;
+    vlc_mutex_lock(&stream->lock);
+    httpd_ClientStreamRelease(cl);
+    vlc_mutex_unlock(&stream->lock);
+    cl->stream = NULL;
 }
 
 int httpd_StreamSend(httpd_stream_t *stream, const block_t *p_block)
@@ -878,6 +995,19 @@ int httpd_StreamSend(httpd_stream_t *stream, const block_t *p_block)
     if (!p_block || !p_block->p_buffer)
         return VLC_SUCCESS;
 
+    /* This is the only copy of the data: clients send from the block */
+    struct httpd_stream_block *block = NULL;
+    if (p_block->i_buffer > 0) {
+        block = malloc(sizeof (*block) + p_block->i_buffer);
+        if (unlikely(block == NULL))
+            return VLC_ENOMEM;
+
+        block->next = NULL;
+        block->i_size = p_block->i_buffer;
+        block->refs = 1;
+        memcpy(block->p_data, p_block->p_buffer, p_block->i_buffer);
+    }
+
     vlc_mutex_lock(&stream->lock);
 
     /* save this pointer (to be used by new connection) */
@@ -888,7 +1018,21 @@ int httpd_StreamSend(httpd_stream_t *stream, const block_t *p_block)
         stream->i_last_keyframe_seen_pos = stream->i_buffer_pos;
     }
 
-    httpd_AppendData(stream, p_block->p_buffer, p_block->i_buffer);
+    if (block != NULL) {
+        block->i_pos = stream->i_buffer_pos;
+        *stream->pp_last = block;
+        stream->pp_last = &block->next;
+        stream->i_buffer_pos += block->i_size;
+
+        /* Drop the oldest blocks, but keep at least the buffer size */
+        for (struct httpd_stream_block *first = stream->p_first;
+             first->next != NULL
+          && stream->i_buffer_pos - first->next->i_pos >= stream->i_buffer_size;
+             first = stream->p_first) {
+            stream->p_first = first->next;
+            httpd_StreamBlockRelease(first);
+        }
+    }
 
     vlc_mutex_unlock(&stream->lock);
     return VLC_SUCCESS;
@@ -904,14 +1048,20 @@ void httpd_StreamDelete(httpd_stream_t *stream)
     free(stream->p_http_headers);
     free(stream->psz_mime);
     free(stream->p_header);
-    free(stream->p_buffer);
+    while (stream->p_first != NULL) {
+        struct httpd_stream_block *block = stream->p_first;
+
+        stream->p_first = block->next;
+        httpd_StreamBlockRelease(block);
+    }
     free(stream);
 }
 
 /*****************************************************************************
  * Low level
  *****************************************************************************/
-static void* httpd_HostThread(void *);
+static int httpd_HostStart(httpd_host_t *);
+static void httpd_HostStop(httpd_host_t *);
 static httpd_host_t *httpd_HostCreate(vlc_object_t *, const char *,
                                       const char *, vlc_tls_server_t *,
                                       unsigned);
@@ -1007,13 +1157,11 @@ static httpd_host_t *httpd_HostCreate(vlc_object_t *p_this,
 
     host->port     = port;
     vlc_list_init(&host->urls);
-    host->client_count = 0;
-    vlc_list_init(&host->clients);
     host->timeout_sec = timeout_sec;
     host->p_tls    = p_tls;
 
-    /* create the thread */
-    if (vlc_clone(&host->thread, httpd_HostThread, host)) {
+    /* create the threads */
+    if (httpd_HostStart(host)) {
         msg_Err(p_this, "cannot spawn http host thread");
         goto error;
     }
@@ -1039,8 +1187,6 @@ error:
 /* delete a host */
 void httpd_HostDelete(httpd_host_t *host)
 {
-    httpd_client_t *client;
-
     vlc_mutex_lock(&httpd.mutex);
 
     if (atomic_fetch_sub_explicit(&host->ref, 1, memory_order_relaxed) > 1) {
@@ -1051,16 +1197,10 @@ void httpd_HostDelete(httpd_host_t *host)
     }
 
     vlc_list_remove(&host->node);
-    vlc_cancel(host->thread);
-    vlc_join(host->thread, NULL);
+    httpd_HostStop(host);
 
     msg_Dbg(host, "HTTP host removed");
 
-    vlc_list_foreach(client, &host->clients, node) {
-        msg_Warn(host, "client still connected");
-        httpd_ClientDestroy(client);
-    }
-
     assert(vlc_list_is_empty(&host->urls));
     vlc_tls_ServerDelete(host->p_tls);
     net_ListenClose(host->fds);
@@ -1148,22 +1288,30 @@ void httpd_UrlDelete(httpd_url_t *url)
 
     vlc_mutex_lock(&host->lock);
     vlc_list_remove(&url->node);
+    vlc_mutex_unlock(&host->lock);
 
     free(url->psz_url);
     free(url->psz_user);
     free(url->psz_password);
 
-    vlc_list_foreach(client, &host->clients, node) {
-        if (client->url != url)
-            continue;
+    /* The url is not reachable anymore, but some clients may still use it.
+     * Clients only run with their worker lock held. */
+    for (unsigned i = 0; i < host->worker_count; i++) {
+        struct httpd_worker *w = &host->workers[i];
+
+        vlc_mutex_lock(&w->lock);
+        vlc_list_foreach(client, &w->clients, node) {
+            if (client->url != url)
+                continue;
 
-        /* TODO complete it */
-        msg_Warn(host, "force closing connections");
-        host->client_count--;
-        httpd_ClientDestroy(client);
+            /* TODO complete it */
+            msg_Warn(host, "force closing connections");
+            httpd_ClientDestroy(client);
+            w->generation++;
+        }
+        vlc_mutex_unlock(&w->lock);
     }
     free(url);
-    vlc_mutex_unlock(&host->lock);
 }
 
 static void httpd_MsgInit(httpd_message_t *msg)
@@ -1247,6 +1395,14 @@ char* httpd_ServerIP(const httpd_client_t *cl, char *ip, int *port)
 
 static void httpd_ClientDestroy(httpd_client_t *cl)
 {
+#ifdef __linux__
+    if (cl->b_active)
+        vlc_list_remove(&cl->active_node);
+#endif
+    cl->worker->client_count--;
+
+    httpd_ClientStreamDetach(cl);
+
     vlc_list_remove(&cl->node);
     vlc_tls_Close(cl->sock);
     httpd_MsgClean(&cl->answer);
@@ -1264,12 +1420,22 @@ static httpd_client_t *httpd_ClientNew(vlc_tls_t *sock)
 
     cl->sock    = sock;
     cl->url     = NULL;
+    cl->worker  = NULL;
+#ifdef __linux__
+    cl->b_active = false;
+    cl->b_ready = false;
+#endif
     cl->i_state = HTTPD_CLIENT_RECEIVING;
     cl->i_buffer_size = HTTPD_CL_BUFSIZE;
     cl->i_buffer = 0;
     cl->p_buffer = xmalloc(cl->i_buffer_size);
     cl->i_keyframe_wait_to_pass = -1;
     cl->b_stream_mode = false;
+    cl->stream = NULL;
+    cl->stream_block = NULL;
+    cl->stream_blocks = 0;
+    cl->iov_index = 0;
+    cl->iov_count = 0;
 
     httpd_MsgInit(&cl->query);
     httpd_MsgInit(&cl->answer);
@@ -1292,6 +1458,14 @@ ssize_t httpd_NetSend (httpd_client_t *cl, const uint8_t *p, size_t i_len)
     return sock->ops->writev(sock, &iov, 1);
 }
 
+static
+ssize_t httpd_NetSendStream(httpd_client_t *cl)
+{
+    vlc_tls_t *sock = cl->sock;
+    return sock->ops->writev(sock, cl->iov + cl->iov_index,
+                             cl->iov_count - cl->iov_index);
+}
+
 
 static const struct
 {
@@ -1635,8 +1809,12 @@ static int httpd_ClientSend(httpd_client_t *cl)
         cl->i_buffer_size = (uint8_t*)p - cl->p_buffer;
     }
 
-    i_len = httpd_NetSend(cl, &cl->p_buffer[cl->i_buffer],
-                           cl->i_buffer_size - cl->i_buffer);
+    bool b_stream = cl->iov_index < cl->iov_count;
+    if (b_stream)
+        i_len = httpd_NetSendStream(cl);
+    else
+        i_len = httpd_NetSend(cl, &cl->p_buffer[cl->i_buffer],
+                              cl->i_buffer_size - cl->i_buffer);
 
     if (i_len < 0) {
 #if defined(_WIN32)
@@ -1651,7 +1829,22 @@ static int httpd_ClientSend(httpd_client_t *cl)
         return 0;
     }
 
-    cl->i_buffer += i_len;
+    if (b_stream) {
+        for (size_t i_left = i_len; i_left > 0;) {
+            struct iovec *iov = &cl->iov[cl->iov_index];
+
+            if (i_left < iov->iov_len) {
+                iov->iov_base = (uint8_t *)iov->iov_base + i_left;
+                iov->iov_len -= i_left;
+                break;
+            }
+            i_left -= iov->iov_len;
+            cl->iov_index++;
+        }
+        if (cl->iov_index < cl->iov_count)
+            return 0;
+    } else
+        cl->i_buffer += i_len;
 
     if (cl->i_buffer >= cl->i_buffer_size) {
         if (cl->answer.i_body == 0  && cl->answer.i_body_offset > 0) {
@@ -1661,7 +1854,10 @@ static int httpd_ClientSend(httpd_client_t *cl)
             httpd_MsgClean(&cl->answer);
             cl->answer.i_body_offset = i_offset;
 
+            httpd_host_t *host = cl->url->host;
+            vlc_mutex_lock(&host->lock);
             httpd_UrlCatchCall(cl->url, cl);
+            vlc_mutex_unlock(&host->lock);
         }
 
         if (cl->answer.i_body != 0) {
@@ -1673,7 +1869,7 @@ static int httpd_ClientSend(httpd_client_t *cl)
 
             cl->answer.i_body = 0;
             cl->answer.p_body = NULL;
-        } else /* send finished */
+        } else if (cl->iov_index == cl->iov_count) /* send finished */
             cl->i_state = HTTPD_CLIENT_SEND_DONE;
     }
     return 0;
@@ -1730,273 +1926,491 @@ auth_failed:
     return false;
 }
 
-static void httpdLoop(httpd_host_t *host)
+/* Runs one step of the client state machine: the pending I/O, then the
+ * state transitions. Returns -1 if the client is waiting for its socket or
+ * for stream data, 0 if it made progress. */
+static int httpd_ClientStep(httpd_host_t *host, httpd_client_t *cl)
 {
-    struct pollfd ufd[host->nfd + host->client_count];
-    unsigned nfd;
-    for (nfd = 0; nfd < host->nfd; nfd++) {
-        ufd[nfd].fd = host->fds[nfd];
-        ufd[nfd].events = POLLIN;
-        ufd[nfd].revents = 0;
+    int val = -1;
+
+    switch (cl->i_state) {
+        case HTTPD_CLIENT_RECEIVING:
+            val = httpd_ClientRecv(cl);
+            break;
+        case HTTPD_CLIENT_SENDING:
+            val = httpd_ClientSend(cl);
+            break;
+        case HTTPD_CLIENT_TLS_HS_IN:
+        case HTTPD_CLIENT_TLS_HS_OUT:
+            httpd_ClientTlsHandshake(host, cl);
+            break;
     }
 
-    vlc_mutex_lock(&host->lock);
-    /* add all socket that should be read/write and close dead connection */
-    vlc_tick_t now = vlc_tick_now();
-    int delay = -1;
-    httpd_client_t *cl;
+    if (cl->i_state == HTTPD_CLIENT_DEAD)
+        return 0;
 
-    int canc = vlc_savecancel();
-    vlc_list_foreach(cl, &host->clients, node) {
-        int val = -1;
+    switch (cl->i_state) {
+        case HTTPD_CLIENT_RECEIVE_DONE: {
+            httpd_message_t *answer = &cl->answer;
+            httpd_message_t *query  = &cl->query;
+
+            httpd_MsgInit(answer);
+            vlc_mutex_lock(&host->lock);
+
+            /* Handle what we received */
+            switch (query->i_type) {
+                case HTTPD_MSG_ANSWER:
+                    cl->url     = NULL;
+                    cl->i_state = HTTPD_CLIENT_DEAD;
+                    break;
+
+                case HTTPD_MSG_OPTIONS:
+                    answer->i_type   = HTTPD_MSG_ANSWER;
+                    answer->i_proto  = query->i_proto;
+                    answer->i_status = 200;
+                    answer->i_body = 0;
+                    answer->p_body = NULL;
+
+                    httpd_MsgAdd(answer, "Server", "VLC/%s", VERSION);
+                    httpd_MsgAdd(answer, "Content-Length", "0");
+
+                    switch(query->i_proto) {
+                    case HTTPD_PROTO_HTTP:
+                        answer->i_version = 1;
+                        httpd_MsgAdd(answer, "Allow", "GET,HEAD,POST,OPTIONS");
+                        break;
 
-        switch (cl->i_state) {
-            case HTTPD_CLIENT_RECEIVING:
-                val = httpd_ClientRecv(cl);
-                break;
-            case HTTPD_CLIENT_SENDING:
-                val = httpd_ClientSend(cl);
-                break;
-            case HTTPD_CLIENT_TLS_HS_IN:
-            case HTTPD_CLIENT_TLS_HS_OUT:
-                httpd_ClientTlsHandshake(host, cl);
-                break;
-        }
+                    case HTTPD_PROTO_RTSP:
+                        answer->i_version = 0;
 
-        if (cl->i_state == HTTPD_CLIENT_DEAD
-         || (host->timeout_sec > 0 && cl->i_timeout_date < now)) {
-            host->client_count--;
-            httpd_ClientDestroy(cl);
-            continue;
+                        const char *p = httpd_MsgGet(query, "Cseq");
+                        if (p)
+                            httpd_MsgAdd(answer, "Cseq", "%s", p);
+                        p = httpd_MsgGet(query, "Timestamp");
+                        if (p)
+                            httpd_MsgAdd(answer, "Timestamp", "%s", p);
+
+                        p = httpd_MsgGet(query, "Require");
+                        if (p) {
+                            answer->i_status = 551;
+                            httpd_MsgAdd(query, "Unsupported", "%s", p);
+                        }
+
+                        httpd_MsgAdd(answer, "Public", "DESCRIBE,SETUP,"
+                                "TEARDOWN,PLAY,PAUSE,GET_PARAMETER");
+                        break;
+                    }
+
+                    if (httpd_MsgGet(&cl->query, "Connection") != NULL)
+                        httpd_MsgAdd(answer, "Connection", "close");
+
+                    cl->i_buffer = -1;  /* Force the creation of the answer in
+                                         * httpd_ClientSend */
+                    cl->i_state = HTTPD_CLIENT_SENDING;
+                    break;
+
+                case HTTPD_MSG_NONE:
+                    if (query->i_proto == HTTPD_PROTO_NONE) {
+                        cl->url = NULL;
+                        cl->i_state = HTTPD_CLIENT_DEAD;
+                    } else {
+                        /* unimplemented */
+                        answer->i_proto  = query->i_proto ;
+                        answer->i_type   = HTTPD_MSG_ANSWER;
+                        answer->i_version= 0;
+                        answer->i_status = 501;
+
+                        char *p;
+                        answer->i_body = httpd_HtmlError (&p, 501, NULL);
+                        answer->p_body = (uint8_t *)p;
+                        httpd_MsgAdd(answer, "Content-Length", "%zu", answer->i_body);
+                        httpd_MsgAdd(answer, "Connection", "close");
+
+                        cl->i_buffer = -1;  /* Force the creation of the answer in httpd_ClientSend */
+                        cl->i_state = HTTPD_CLIENT_SENDING;
+                    }
+                    break;
+
+                default: {
+                    httpd_url_t *url;
+                    bool b_auth_failed = false;
+
+                    /* Search the url and trigger callbacks */
+                    vlc_list_foreach(url, &host->urls, node) {
+                        if (strcmp(url->psz_url, query->psz_url))
+                            continue;
+
+                        if (answer) {
+                            b_auth_failed = !httpdAuthOk(url->psz_user,
+                               url->psz_password,
+                               httpd_MsgGet(query, "Authorization")); /* BASIC id */
+                            if (b_auth_failed)
+                               break;
+                        }
+
+                        if (httpd_UrlCatchCall(url, cl))
+                            continue;
+
+                        if (answer->i_proto == HTTPD_PROTO_NONE)
+                            cl->i_buffer = cl->i_buffer_size; /* Raw answer from a CGI */
+                        else
+                            cl->i_buffer = -1;
+
+                        /* only one url can answer */
+                        answer = NULL;
+                        if (!cl->url)
+                            cl->url = url;
+                    }
+
+                    if (answer) {
+                        answer->i_proto  = query->i_proto;
+                        answer->i_type   = HTTPD_MSG_ANSWER;
+                        answer->i_version= 0;
+
+                       if (b_auth_failed) {
+                            httpd_MsgAdd(answer, "WWW-Authenticate",
+                                    "Basic realm=\"VLC stream\"");
+                            answer->i_status = 401;
+                        } else
+                            answer->i_status = 404; /* no url registered */
+
+                        char *p;
+                        answer->i_body = httpd_HtmlError (&p, answer->i_status,
+                                query->psz_url);
+                        answer->p_body = (uint8_t *)p;
+
+                        cl->i_buffer = -1;  /* Force the creation of the answer in httpd_ClientSend */
+                        httpd_MsgAdd(answer, "Content-Length", "%zu", answer->i_body);
+                        httpd_MsgAdd(answer, "Content-Type", "%s", "text/html");
+                        if (httpd_MsgGet(&cl->query, "Connection") != NULL)
+                            httpd_MsgAdd(answer, "Connection", "close");
+                    }
+
+                    cl->i_state = HTTPD_CLIENT_SENDING;
+                }
+            }
+            vlc_mutex_unlock(&host->lock);
+            break;
         }
 
-        if (val == 0) {
-            cl->i_timeout_date = now + VLC_TICK_FROM_SEC(host->timeout_sec);
-            delay = 0;
+        case HTTPD_CLIENT_SEND_DONE:
+            if (!cl->b_stream_mode || cl->answer.i_body_offset == 0) {
+                bool do_close = false;
+
+                httpd_ClientStreamDetach(cl);
+                cl->url = NULL;
+
+                if (cl->query.i_proto != HTTPD_PROTO_HTTP
+                 || cl->query.i_version > 0)
+                {
+                    const char *psz_connection = httpd_MsgGet(&cl->answer,
+                                                             "Connection");
+                    if (psz_connection != NULL)
+                        do_close = !strcasecmp(psz_connection, "close");
+                }
+                else
+                    do_close = true;
+
+                if (!do_close) {
+                    httpd_MsgClean(&cl->query);
+                    httpd_MsgInit(&cl->query);
+
+                    cl->i_buffer = 0;
+                    cl->i_buffer_size = 1000;
+                    free(cl->p_buffer);
+                    // Allocate an extra byte for the null terminating byte
+                    cl->p_buffer = xmalloc(cl->i_buffer_size + 1);
+                    cl->i_state = HTTPD_CLIENT_RECEIVING;
+                } else
+                    cl->i_state = HTTPD_CLIENT_DEAD;
+                httpd_MsgClean(&cl->answer);
+            } else {
+                int64_t i_offset = cl->answer.i_body_offset;
+                httpd_MsgClean(&cl->answer);
+
+                cl->answer.i_body_offset = i_offset;
+                free(cl->p_buffer);
+                cl->p_buffer = NULL;
+                cl->i_buffer = 0;
+                cl->i_buffer_size = 0;
+
+                cl->i_state = HTTPD_CLIENT_WAITING;
+            }
+            break;
+
+        case HTTPD_CLIENT_WAITING: {
+            int64_t i_offset = cl->answer.i_body_offset;
+            int i_msg = cl->query.i_type;
+
+            httpd_MsgInit(&cl->answer);
+            cl->answer.i_body_offset = i_offset;
+
+            vlc_mutex_lock(&host->lock);
+            cl->url->catch[i_msg].cb(cl->url->catch[i_msg].p_sys, cl,
+                    &cl->answer, &cl->query);
+            vlc_mutex_unlock(&host->lock);
+            if (cl->answer.i_type != HTTPD_MSG_NONE) {
+                /* we have new data, so re-enter send mode */
+                cl->i_buffer      = 0;
+                cl->p_buffer      = cl->answer.p_body;
+                cl->i_buffer_size = cl->answer.i_body;
+                cl->answer.p_body = NULL;
+                cl->answer.i_body = 0;
+                cl->i_state = HTTPD_CLIENT_SENDING;
+            }
+            break;
         }
+    }
+    return val;
+}
 
-        struct pollfd *pufd = ufd + nfd;
-        assert (pufd < ufd + ARRAY_SIZE (ufd));
+static bool httpd_HostAccept(httpd_host_t *host, int fd, vlc_tick_t now)
+{
+    fd = vlc_accept (fd, NULL, NULL, true);
+    if (fd == -1)
+        return false;
+    setsockopt (fd, SOL_SOCKET, SO_REUSEADDR,
+            &(int){ 1 }, sizeof(int));
 
-        pufd->events = pufd->revents = 0;
+    vlc_tls_t *sk = vlc_tls_SocketOpen(fd);
+    if (unlikely(sk == NULL))
+    {
+        vlc_close(fd);
+        return true;
+    }
 
-        switch (cl->i_state) {
-            case HTTPD_CLIENT_RECEIVING:
-            case HTTPD_CLIENT_TLS_HS_IN:
-                pufd->events = POLLIN;
-                break;
+    if (host->p_tls != NULL)
+    {
+        const char *alpn[] = { "http/1.1", NULL };
+        vlc_tls_t *tls;
 
-            case HTTPD_CLIENT_SENDING:
-            case HTTPD_CLIENT_TLS_HS_OUT:
-                pufd->events = POLLOUT;
-                break;
+        tls = vlc_tls_ServerSessionCreate(host->p_tls, sk, alpn);
+        if (tls == NULL)
+        {
+            vlc_tls_SessionDelete(sk);
+            return true;
+        }
+        sk = tls;
+    }
 
-            case HTTPD_CLIENT_RECEIVE_DONE: {
-                httpd_message_t *answer = &cl->answer;
-                httpd_message_t *query  = &cl->query;
+    httpd_client_t *cl = httpd_ClientNew(sk);
 
-                httpd_MsgInit(answer);
+    if (unlikely(cl == NULL))
+    {
+        vlc_tls_Close(sk);
+        return true;
+    }
 
-                /* Handle what we received */
-                switch (query->i_type) {
-                    case HTTPD_MSG_ANSWER:
-                        cl->url     = NULL;
-                        cl->i_state = HTTPD_CLIENT_DEAD;
-                        break;
+    if (host->p_tls != NULL)
+        cl->i_state = HTTPD_CLIENT_TLS_HS_OUT;
 
-                    case HTTPD_MSG_OPTIONS:
-                        answer->i_type   = HTTPD_MSG_ANSWER;
-                        answer->i_proto  = query->i_proto;
-                        answer->i_status = 200;
-                        answer->i_body = 0;
-                        answer->p_body = NULL;
+    cl->i_timeout_date = now + VLC_TICK_FROM_SEC(host->timeout_sec);
 
-                        httpd_MsgAdd(answer, "Server", "VLC/%s", VERSION);
-                        httpd_MsgAdd(answer, "Content-Length", "0");
+    /* Spread the clients over the workers */
+    struct httpd_worker *w = &host->workers[host->next_worker];
+    if (++host->next_worker == host->worker_count)
+        host->next_worker = 0;
 
-                        switch(query->i_proto) {
-                        case HTTPD_PROTO_HTTP:
-                            answer->i_version = 1;
-                            httpd_MsgAdd(answer, "Allow", "GET,HEAD,POST,OPTIONS");
-                            break;
+    vlc_mutex_lock(&w->lock);
+    cl->worker = w;
+    w->client_count++;
+    vlc_list_append(&cl->node, &w->clients);
+#ifdef __linux__
+    struct epoll_event ev = {
+        .events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET,
+        .data.ptr = cl,
+    };
 
-                        case HTTPD_PROTO_RTSP:
-                            answer->i_version = 0;
+    if (epoll_ctl(w->epfd, EPOLL_CTL_ADD, vlc_tls_GetFD(sk), &ev))
+        httpd_ClientDestroy(cl);
+#endif
+    vlc_mutex_unlock(&w->lock);
+    return true;
+}
 
-                            const char *p = httpd_MsgGet(query, "Cseq");
-                            if (p)
-                                httpd_MsgAdd(answer, "Cseq", "%s", p);
-                            p = httpd_MsgGet(query, "Timestamp");
-                            if (p)
-                                httpd_MsgAdd(answer, "Timestamp", "%s", p);
+#ifdef __linux__
+static void httpd_ClientSetActive(httpd_client_t *cl, bool active)
+{
+    if (cl->b_active == active)
+        return;
+    if (active)
+        vlc_list_append(&cl->active_node, &cl->worker->active);
+    else
+        vlc_list_remove(&cl->active_node);
+    cl->b_active = active;
+}
 
-                            p = httpd_MsgGet(query, "Require");
-                            if (p) {
-                                answer->i_status = 551;
-                                httpd_MsgAdd(query, "Unsupported", "%s", p);
-                            }
+/* Runs a client until it would block, or until it used its budget */
+static void httpd_WorkerRun(struct httpd_worker *w, httpd_client_t *cl,
+                            vlc_tick_t now)
+{
+    httpd_host_t *host = w->host;
 
-                            httpd_MsgAdd(answer, "Public", "DESCRIBE,SETUP,"
-                                    "TEARDOWN,PLAY,PAUSE,GET_PARAMETER");
-                            break;
-                        }
+    for (unsigned budget = 256;; budget--) {
+        uint8_t state = cl->i_state;
+        int val = httpd_ClientStep(host, cl);
 
-                        if (httpd_MsgGet(&cl->query, "Connection") != NULL)
-                            httpd_MsgAdd(answer, "Connection", "close");
+        if (cl->i_state == HTTPD_CLIENT_DEAD) {
+            httpd_ClientDestroy(cl);
+            return;
+        }
 
-                        cl->i_buffer = -1;  /* Force the creation of the answer in
-                                             * httpd_ClientSend */
-                        cl->i_state = HTTPD_CLIENT_SENDING;
-                        break;
+        if (val == 0)
+            cl->i_timeout_date = now + VLC_TICK_FROM_SEC(host->timeout_sec);
+        else if (cl->i_state == state)
+            break; /* wait for the next edge, or for stream data */
+
+        if (budget == 0) {
+            /* let the other clients run, and resume at the next iteration */
+            cl->b_ready = true;
+            httpd_ClientSetActive(cl, true);
+            return;
+        }
+    }
 
-                    case HTTPD_MSG_NONE:
-                        if (query->i_proto == HTTPD_PROTO_NONE) {
-                            cl->url = NULL;
-                            cl->i_state = HTTPD_CLIENT_DEAD;
-                        } else {
-                            /* unimplemented */
-                            answer->i_proto  = query->i_proto ;
-                            answer->i_type   = HTTPD_MSG_ANSWER;
-                            answer->i_version= 0;
-                            answer->i_status = 501;
-
-                            char *p;
-                            answer->i_body = httpd_HtmlError (&p, 501, NULL);
-                            answer->p_body = (uint8_t *)p;
-                            httpd_MsgAdd(answer, "Content-Length", "%zu", answer->i_body);
-                            httpd_MsgAdd(answer, "Connection", "close");
+    /* Clients waiting for stream data do not get any socket event */
+    cl->b_ready = false;
+    httpd_ClientSetActive(cl, cl->i_state == HTTPD_CLIENT_WAITING);
+}
 
-                            cl->i_buffer = -1;  /* Force the creation of the answer in httpd_ClientSend */
-                            cl->i_state = HTTPD_CLIENT_SENDING;
-                        }
-                        break;
+static void *httpd_WorkerThread(void *data)
+{
+    struct httpd_worker *w = data;
+    httpd_host_t *host = w->host;
+    struct epoll_event ev[64];
+    vlc_tick_t next_tick = VLC_TICK_0, next_check = VLC_TICK_0;
+    int delay = -1;
 
-                    default: {
-                        httpd_url_t *url;
-                        bool b_auth_failed = false;
-
-                        /* Search the url and trigger callbacks */
-                        vlc_list_foreach(url, &host->urls, node) {
-                            if (strcmp(url->psz_url, query->psz_url))
-                                continue;
-
-                            if (answer) {
-                                b_auth_failed = !httpdAuthOk(url->psz_user,
-                                   url->psz_password,
-                                   httpd_MsgGet(query, "Authorization")); /* BASIC id */
-                                if (b_auth_failed)
-                                   break;
-                            }
-
-                            if (httpd_UrlCatchCall(url, cl))
-                                continue;
-
-                            if (answer->i_proto == HTTPD_PROTO_NONE)
-                                cl->i_buffer = cl->i_buffer_size; /* Raw answer from a CGI */
-                            else
-                                cl->i_buffer = -1;
-
-                            /* only one url can answer */
-                            answer = NULL;
-                            if (!cl->url)
-                                cl->url = url;
-                        }
+    vlc_thread_set_name("vlc-httpd");
 
-                        if (answer) {
-                            answer->i_proto  = query->i_proto;
-                            answer->i_type   = HTTPD_MSG_ANSWER;
-                            answer->i_version= 0;
-
-                           if (b_auth_failed) {
-                                httpd_MsgAdd(answer, "WWW-Authenticate",
-                                        "Basic realm=\"VLC stream\"");
-                                answer->i_status = 401;
-                            } else
-                                answer->i_status = 404; /* no url registered */
-
-                            char *p;
-                            answer->i_body = httpd_HtmlError (&p, answer->i_status,
-                                    query->psz_url);
-                            answer->p_body = (uint8_t *)p;
-
-                            cl->i_buffer = -1;  /* Force the creation of the answer in httpd_ClientSend */
-                            httpd_MsgAdd(answer, "Content-Length", "%zu", answer->i_body);
-                            httpd_MsgAdd(answer, "Content-Type", "%s", "text/html");
-                            if (httpd_MsgGet(&cl->query, "Connection") != NULL)
-                                httpd_MsgAdd(answer, "Connection", "close");
-                        }
+    for (;;) {
+        vlc_mutex_lock(&w->lock);
+        unsigned generation = w->generation;
+        vlc_mutex_unlock(&w->lock);
 
-                        cl->i_state = HTTPD_CLIENT_SENDING;
-                    }
-                }
-                break;
+        int n = epoll_wait(w->epfd, ev, ARRAY_SIZE(ev), delay);
+        if (n < 0) {
+            if (errno != EINTR)
+                msg_Err(host, "polling error: %s", vlc_strerror_c(errno));
+            n = 0;
+        }
+
+        vlc_tick_t now = vlc_tick_now();
+
+        /* Handle the server sockets (accept new connections) */
+        for (int i = 0; i < n; i++) {
+            if (ev[i].data.ptr == w)
+                return NULL; /* host deleted */
+            if (ev[i].data.ptr == host) {
+                for (unsigned j = 0; j < host->nfd; j++)
+                    for (unsigned k = 0; k < 64; k++)
+                        if (!httpd_HostAccept(host, host->fds[j], now))
+                            break;
+                ev[i].data.ptr = NULL;
             }
+        }
 
-            case HTTPD_CLIENT_SEND_DONE:
-                if (!cl->b_stream_mode || cl->answer.i_body_offset == 0) {
-                    bool do_close = false;
+        vlc_mutex_lock(&w->lock);
 
-                    cl->url = NULL;
+        httpd_client_t *cl;
 
-                    if (cl->query.i_proto != HTTPD_PROTO_HTTP
-                     || cl->query.i_version > 0)
-                    {
-                        const char *psz_connection = httpd_MsgGet(&cl->answer,
-                                                                 "Connection");
-                        if (psz_connection != NULL)
-                            do_close = !strcasecmp(psz_connection, "close");
-                    }
-                    else
-                        do_close = true;
-
-                    if (!do_close) {
-                        httpd_MsgClean(&cl->query);
-                        httpd_MsgInit(&cl->query);
-
-                        cl->i_buffer = 0;
-                        cl->i_buffer_size = 1000;
-                        free(cl->p_buffer);
-                        // Allocate an extra byte for the null terminating byte
-                        cl->p_buffer = xmalloc(cl->i_buffer_size + 1);
-                        cl->i_state = HTTPD_CLIENT_RECEIVING;
-                    } else
-                        cl->i_state = HTTPD_CLIENT_DEAD;
-                    httpd_MsgClean(&cl->answer);
-                } else {
-                    int64_t i_offset = cl->answer.i_body_offset;
-                    httpd_MsgClean(&cl->answer);
+        if (w->generation != generation) {
+            /* Some clients were destroyed by httpd_UrlDelete() in the mean
+             * time: the events may be stale, run every client instead. */
+            vlc_list_foreach(cl, &w->clients, node)
+                httpd_WorkerRun(w, cl, now);
+        } else {
+            for (int i = 0; i < n; i++)
+                if (ev[i].data.ptr != NULL)
+                    httpd_WorkerRun(w, ev[i].data.ptr, now);
+        }
 
-                    cl->answer.i_body_offset = i_offset;
-                    free(cl->p_buffer);
-                    cl->p_buffer = NULL;
-                    cl->i_buffer = 0;
-                    cl->i_buffer_size = 0;
+        /* Run the clients that used their budget, and every 20 ms (not too
+         * big) the ones waiting for stream data */
+        bool tick = now >= next_tick;
+        if (tick)
+            next_tick = now + VLC_TICK_FROM_MS(20);
+
+        vlc_list_foreach(cl, &w->active, active_node)
+            if (tick || cl->b_ready)
+                httpd_WorkerRun(w, cl, now);
+
+        /* Close the timed out connections */
+        if (host->timeout_sec > 0 && now >= next_check) {
+            vlc_list_foreach(cl, &w->clients, node)
+                if (cl->i_timeout_date < now)
+                    httpd_ClientDestroy(cl);
+            next_check = now + VLC_TICK_FROM_SEC(1);
+        }
 
-                    cl->i_state = HTTPD_CLIENT_WAITING;
-                }
-                break;
+        bool ready = false;
+        vlc_list_foreach(cl, &w->active, active_node)
+            ready |= cl->b_ready;
 
-            case HTTPD_CLIENT_WAITING: {
-                int64_t i_offset = cl->answer.i_body_offset;
-                int i_msg = cl->query.i_type;
+        if (ready)
+            delay = 0;
+        else if (!vlc_list_is_empty(&w->active))
+            delay = MS_FROM_VLC_TICK(next_tick - now) + 1;
+        else if (host->timeout_sec > 0 && !vlc_list_is_empty(&w->clients))
+            delay = MS_FROM_VLC_TICK(next_check - now) + 1;
+        else
+            delay = -1;
+        vlc_mutex_unlock(&w->lock);
+    }
+}
+#else
+static short httpd_ClientEvents(const httpd_client_t *cl)
+{
+    switch (cl->i_state) {
+        case HTTPD_CLIENT_RECEIVING:
+        case HTTPD_CLIENT_TLS_HS_IN:
+            return POLLIN;
+        case HTTPD_CLIENT_SENDING:
+        case HTTPD_CLIENT_TLS_HS_OUT:
+            return POLLOUT;
+    }
+    return 0;
+}
 
-                httpd_MsgInit(&cl->answer);
-                cl->answer.i_body_offset = i_offset;
+static void httpdLoop(httpd_host_t *host)
+{
+    struct httpd_worker *w = &host->workers[0];
+    struct pollfd ufd[host->nfd + w->client_count];
+    unsigned nfd;
+    for (nfd = 0; nfd < host->nfd; nfd++) {
+        ufd[nfd].fd = host->fds[nfd];
+        ufd[nfd].events = POLLIN;
+        ufd[nfd].revents = 0;
+    }
 
-                cl->url->catch[i_msg].cb(cl->url->catch[i_msg].p_sys, cl,
-                        &cl->answer, &cl->query);
-                if (cl->answer.i_type != HTTPD_MSG_NONE) {
-                    /* we have new data, so re-enter send mode */
-                    cl->i_buffer      = 0;
-                    cl->p_buffer      = cl->answer.p_body;
-                    cl->i_buffer_size = cl->answer.i_body;
-                    cl->answer.p_body = NULL;
-                    cl->answer.i_body = 0;
-                    cl->i_state = HTTPD_CLIENT_SENDING;
-                }
-            }
+    vlc_mutex_lock(&w->lock);
+    /* add all socket that should be read/write and close dead connection */
+    vlc_tick_t now = vlc_tick_now();
+    int delay = -1;
+    httpd_client_t *cl;
+
+    int canc = vlc_savecancel();
+    vlc_list_foreach(cl, &w->clients, node) {
+        uint8_t state = cl->i_state;
+        int val = httpd_ClientStep(host, cl);
+
+        if (cl->i_state == HTTPD_CLIENT_DEAD
+         || (host->timeout_sec > 0 && cl->i_timeout_date < now)) {
+            httpd_ClientDestroy(cl);
+            continue;
         }
 
+        if (val == 0) {
+            cl->i_timeout_date = now + VLC_TICK_FROM_SEC(host->timeout_sec);
+            delay = 0;
+        } else if (cl->i_state != state)
+            delay = 0;
+
+        struct pollfd *pufd = ufd + nfd;
+        assert (pufd < ufd + ARRAY_SIZE (ufd));
+
+        pufd->events = httpd_ClientEvents(cl);
+        pufd->revents = 0;
         pufd->fd = vlc_tls_GetPollFD(cl->sock, &pufd->events);
 
         if (pufd->events != 0)
@@ -2005,7 +2419,7 @@ static void httpdLoop(httpd_host_t *host)
         else if (delay != 0)
             delay = 20;
     }
-    vlc_mutex_unlock(&host->lock);
+    vlc_mutex_unlock(&w->lock);
     vlc_restorecancel(canc);
 
     while (poll(ufd, nfd, delay) < 0)
@@ -2015,78 +2429,122 @@ static void httpdLoop(httpd_host_t *host)
     }
 
     canc = vlc_savecancel();
-    vlc_mutex_lock(&host->lock);
-
-    /* Handle client sockets */
-    now = vlc_tick_now();
-    nfd = host->nfd;
 
     /* Handle server sockets (accept new connections) */
+    now = vlc_tick_now();
     for (nfd = 0; nfd < host->nfd; nfd++) {
-        int fd = ufd[nfd].fd;
+        assert (ufd[nfd].fd == host->fds[nfd]);
 
-        assert (fd == host->fds[nfd]);
+        if (ufd[nfd].revents != 0)
+            httpd_HostAccept(host, ufd[nfd].fd, now);
+    }
 
-        if (ufd[nfd].revents == 0)
-            continue;
+    vlc_restorecancel(canc);
+}
 
-        /* */
-        fd = vlc_accept (fd, NULL, NULL, true);
-        if (fd == -1)
-            continue;
-        setsockopt (fd, SOL_SOCKET, SO_REUSEADDR,
-                &(int){ 1 }, sizeof(int));
+static void* httpd_WorkerThread(void *data)
+{
+    vlc_thread_set_name("vlc-httpd");
 
-        vlc_tls_t *sk = vlc_tls_SocketOpen(fd);
-        if (unlikely(sk == NULL))
-        {
-            vlc_close(fd);
-            continue;
-        }
+    struct httpd_worker *w = data;
+    httpd_host_t *host = w->host;
 
-        if (host->p_tls != NULL)
-        {
-            const char *alpn[] = { "http/1.1", NULL };
-            vlc_tls_t *tls;
+    while (atomic_load_explicit(&host->ref, memory_order_relaxed) > 0)
+        httpdLoop(host);
+    return NULL;
+}
+#endif
 
-            tls = vlc_tls_ServerSessionCreate(host->p_tls, sk, alpn);
-            if (tls == NULL)
-            {
-                vlc_tls_SessionDelete(sk);
-                continue;
-            }
-            sk = tls;
-        }
+static int httpd_HostStart(httpd_host_t *host)
+{
+    unsigned count = 1;
 
-        cl = httpd_ClientNew(sk);
+#ifdef __linux__
+    count = vlc_GetCPUCount();
+    if (count > HTTPD_WORKERS_MAX)
+        count = HTTPD_WORKERS_MAX;
 
-        if (unlikely(cl == NULL))
-        {
-            vlc_tls_Close(sk);
-            continue;
-        }
+    if (vlc_pipe(host->wake))
+        return -1;
+#endif
+    host->worker_count = 0;
+    host->next_worker = 0;
+
+    for (unsigned i = 0; i < count; i++) {
+        struct httpd_worker *w = &host->workers[i];
+
+        w->host = host;
+        vlc_mutex_init(&w->lock);
+        w->client_count = 0;
+        vlc_list_init(&w->clients);
+        w->generation = 0;
+#ifdef __linux__
+        vlc_list_init(&w->active);
+
+        w->epfd = epoll_create1(EPOLL_CLOEXEC);
+        if (w->epfd == -1)
+            break;
+
+        /* The wake-up pipe is never drained, so that all workers see it */
+        struct epoll_event ev = { .events = EPOLLIN, .data.ptr = w };
+        bool ok = !epoll_ctl(w->epfd, EPOLL_CTL_ADD, host->wake[0], &ev);
 
-        if (host->p_tls != NULL)
-            cl->i_state = HTTPD_CLIENT_TLS_HS_OUT;
+        /* The first worker accepts the new connections */
+        ev.data.ptr = host;
+        for (unsigned j = 0; ok && i == 0 && j < host->nfd; j++)
+            ok = !epoll_ctl(w->epfd, EPOLL_CTL_ADD, host->fds[j], &ev);
 
-        cl->i_timeout_date = now + VLC_TICK_FROM_SEC(host->timeout_sec);
-        host->client_count++;
-        vlc_list_append(&cl->node, &host->clients);
+        if (!ok) {
+            vlc_close(w->epfd);
+            break;
+        }
+#endif
+        if (vlc_clone(&w->thread, httpd_WorkerThread, w)) {
+#ifdef __linux__
+            vlc_close(w->epfd);
+#endif
+            break;
+        }
+        host->worker_count++;
     }
 
-    vlc_mutex_unlock(&host->lock);
-    vlc_restorecancel(canc);
+    if (host->worker_count == 0) {
+#ifdef __linux__
+        vlc_close(host->wake[1]);
+        vlc_close(host->wake[0]);
+#endif
+        return -1;
+    }
+    return 0;
 }
 
-static void* httpd_HostThread(void *data)
+static void httpd_HostStop(httpd_host_t *host)
 {
-    vlc_thread_set_name("vlc-httpd");
+    httpd_client_t *client;
 
-    httpd_host_t *host = data;
+#ifdef __linux__
+    while (write(host->wake[1], "", 1) < 0 && errno == EINTR);
+#else
+    vlc_cancel(host->workers[0].thread);
+#endif
 
-    while (atomic_load_explicit(&host->ref, memory_order_relaxed) > 0)
-        httpdLoop(host);
-    return NULL;
+    for (unsigned i = 0; i < host->worker_count; i++) {
+        struct httpd_worker *w = &host->workers[i];
+
+        vlc_join(w->thread, NULL);
+
+        vlc_list_foreach(client, &w->clients, node) {
+            msg_Warn(host, "client still connected");
+            httpd_ClientDestroy(client);
+        }
+#ifdef __linux__
+        vlc_close(w->epfd);
+#endif
+    }
+#ifdef __linux__
+    vlc_close(host->wake[1]);
+    vlc_close(host->wake[0]);
+#endif
 }
 
 int httpd_StreamSetHTTPHeaders(httpd_stream_t * p_stream,
@@ -139,7 +139,12 @@ Submit(input_fetcher_t *fetcher, vlc_executor_t *executor, input_item_t *item,
         return VLC_ENOMEM;
 
     FetcherAddTask(fetcher, task);
-    vlc_executor_Submit(task->executor, &task->runnable);
+
+    /* Interactive requests come from the user, serve them first */
+    enum vlc_executor_priority priority =
+        options & META_REQUEST_OPTION_DO_INTERACT
+            ? VLC_EXECUTOR_PRIORITY_HIGH : VLC_EXECUTOR_PRIORITY_NORMAL;
+    vlc_executor_SubmitPriority(task->executor, &task->runnable, priority);
 
     return VLC_SUCCESS;
 }
@@ -392,7 +392,13 @@ int vlc_preparser_Push( vlc_preparser_t *preparser,
 
     PreparserAddTask(preparser, task);
 
-    vlc_executor_Submit(preparser->executor, &task->runnable);
+    /* Interactive requests come from the user, do not let them wait behind
+     * background (e.g. media library) preparsing */
+    enum vlc_executor_priority priority =
+        i_options & META_REQUEST_OPTION_DO_INTERACT
+            ? VLC_EXECUTOR_PRIORITY_HIGH : VLC_EXECUTOR_PRIORITY_NORMAL;
+    vlc_executor_SubmitPriority(preparser->executor, &task->runnable,
+                                priority);
     return VLC_SUCCESS;
 }
 
@@ -86,11 +86,66 @@ static void test_block (void)
     //assert (block == NULL);
 }
 
+static void test_block_cache (void)
+{
+    struct vlc_frame_alloc_stats before, after;
+    block_t *blocks[64];
+
+    vlc_frame_GetAllocStats (&before);
+
+    for (int round = 0; round < 2; round++)
+    {
+        for (int i = 0; i < 64; i++)
+        {
+            blocks[i] = block_Alloc (188 * (1 + i % 7));
+            assert (blocks[i] != NULL);
+            assert (((uintptr_t)blocks[i]->p_buffer % 32) == 0);
+            memset (blocks[i]->p_buffer, i, blocks[i]->i_buffer);
+        }
+        for (int i = 0; i < 64; i++)
+        {
+            assert (blocks[i]->i_buffer == 188u * (1 + i % 7));
+            assert (blocks[i]->p_buffer[blocks[i]->i_buffer - 1] == i);
+            block_Release (blocks[i]);
+        }
+    }
+
+    /* Large blocks bypass the cache */
+    block_t *block = block_Alloc (1 << 20);
+    assert (block != NULL);
+    block_Release (block);
+
+    vlc_frame_GetAllocStats (&after);
+    assert (after.allocs - before.allocs == 128);
+    assert (after.releases - before.releases == 128);
+    assert (after.hits - before.hits <= 128);
+#ifndef __SANITIZE_ADDRESS__
+    /* The second round is served from the first round releases */
+    assert (after.hits - before.hits >= 64);
+    assert (after.cached_frames > 0);
+#endif
+
+    /* Trimming frees the cached frames, not the ones in use */
+    block = block_Alloc (188);
+    assert (block != NULL);
+    vlc_frame_TrimCaches ();
+    vlc_frame_GetAllocStats (&after);
+    assert (after.cached_frames == 0);
+    assert (after.cached_bytes == 0);
+    block_Release (block);
+#ifndef __SANITIZE_ADDRESS__
+    vlc_frame_GetAllocStats (&after);
+    assert (after.cached_frames == 1);
+#endif
+    vlc_frame_TrimCaches ();
+}
+
 int main (void)
 {
     test_block_File(false);
     test_block_File(true);
     test_block ();
+    test_block_cache ();
     return 0;
 }
 
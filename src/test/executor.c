@@ -264,6 +264,17 @@ static void test_task_chain(void)
     SpawnDoublerTask(executor, array, 100);
 
     vlc_executor_WaitIdle(executor);
+
+    /* 100 leaves and 99 intermediate nodes */
+    struct vlc_executor_stats stats;
+    vlc_executor_GetStats(executor, &stats);
+    assert(stats.submitted == 199);
+    assert(stats.completed == 199);
+    assert(stats.canceled == 0);
+    assert(stats.running == 0);
+    for (int i = 0; i <= VLC_EXECUTOR_PRIORITY_HIGH; ++i)
+        assert(stats.queued[i] == 0);
+
     vlc_executor_Delete(executor);
 
     /* All values must have been doubled */
@@ -271,6 +282,127 @@ static void test_task_chain(void)
         assert(array[i] == 2 * i);
 }
 
+struct order_data
+{
+    vlc_mutex_t lock;
+    vlc_cond_t cond;
+    bool started;
+    bool blocked;
+    int next;
+    int order[3];
+};
+
+struct order_task
+{
+    struct order_data *data;
+    int index;
+    struct vlc_runnable runnable;
+};
+
+static void RunBlock(void *userdata)
+{
+    struct order_data *data = userdata;
+
+    vlc_mutex_lock(&data->lock);
+    data->started = true;
+    vlc_cond_broadcast(&data->cond);
+    while (data->blocked)
+        vlc_cond_wait(&data->cond, &data->lock);
+    vlc_mutex_unlock(&data->lock);
+}
+
+static void RunRecord(void *userdata)
+{
+    struct order_task *task = userdata;
+    struct order_data *data = task->data;
+
+    vlc_mutex_lock(&data->lock);
+    data->order[data->next++] = task->index;
+    vlc_mutex_unlock(&data->lock);
+}
+
+static void test_priority(void)
+{
+    vlc_executor_t *executor = vlc_executor_New(1);
+    assert(executor);
+
+    struct order_data data = {
+        .started = false,
+        .blocked = true,
+        .next = 0,
+    };
+    vlc_mutex_init(&data.lock);
+    vlc_cond_init(&data.cond);
+
+    /* Keep the only thread busy while the other tasks are queued */
+    struct vlc_runnable blocker = {
+        .run = RunBlock,
+        .userdata = &data,
+    };
+    vlc_executor_Submit(executor, &blocker);
+
+    /* Otherwise the thread could pick one of the tasks below first */
+    vlc_mutex_lock(&data.lock);
+    while (!data.started)
+        vlc_cond_wait(&data.cond, &data.lock);
+    vlc_mutex_unlock(&data.lock);
+
+    static const enum vlc_executor_priority priorities[] = {
+        VLC_EXECUTOR_PRIORITY_LOW,
+        VLC_EXECUTOR_PRIORITY_NORMAL,
+        VLC_EXECUTOR_PRIORITY_HIGH,
+    };
+
+    struct order_task tasks[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        tasks[i].data = &data;
+        tasks[i].index = i;
+        tasks[i].runnable.run = RunRecord;
+        tasks[i].runnable.userdata = &tasks[i];
+        vlc_executor_SubmitPriority(executor, &tasks[i].runnable,
+                                    priorities[i]);
+    }
+
+    struct vlc_executor_stats stats;
+    vlc_executor_GetStats(executor, &stats);
+    assert(stats.submitted == 4);
+    assert(stats.queued[VLC_EXECUTOR_PRIORITY_LOW] == 1);
+    assert(stats.queued[VLC_EXECUTOR_PRIORITY_HIGH] == 1);
+
+    /* Canceled runnables are accounted */
+    struct order_task canceled = {
+        .data = &data,
+        .index = -1,
+        .runnable = { .run = RunRecord, .userdata = &canceled },
+    };
+    vlc_executor_SubmitPriority(executor, &canceled.runnable,
+                                VLC_EXECUTOR_PRIORITY_HIGH);
+    assert(vlc_executor_Cancel(executor, &canceled.runnable));
+
+    vlc_mutex_lock(&data.lock);
+    data.blocked = false;
+    vlc_cond_broadcast(&data.cond);
+    vlc_mutex_unlock(&data.lock);
+
+    vlc_executor_WaitIdle(executor);
+
+    /* Highest priority first */
+    assert(data.next == 3);
+    assert(data.order[0] == 2);
+    assert(data.order[1] == 1);
+    assert(data.order[2] == 0);
+
+    vlc_executor_GetStats(executor, &stats);
+    assert(stats.threads == 1);
+    assert(stats.submitted == 5);
+    assert(stats.completed == 4);
+    assert(stats.canceled == 1);
+    assert(stats.max_wait_time <= stats.wait_time);
+
+    vlc_executor_Delete(executor);
+}
+
 int main(void)
 {
     test_single_runnable();
@@ -278,5 +410,6 @@ int main(void)
     test_blocking_delete();
     test_cancel();
     test_task_chain();
+    test_priority();
     return 0;
 }
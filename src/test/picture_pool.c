@@ -26,11 +26,18 @@
 #undef NDEBUG
 #include <assert.h>
 
+#include <stdatomic.h>
+#include <stdio.h>
+
 #include <vlc_common.h>
 #include <vlc_es.h>
 #include <vlc_picture_pool.h>
+#include <vlc_threads.h>
+#include <vlc_tick.h>
 
 #define PICTURES 10
+#define THREADS 4
+#define ITERATIONS 100000
 
 const char vlc_module_name[] = "test_picture_pool";
 
@@ -87,6 +94,87 @@ static void test(bool zombie)
             picture_Release(pics[i]);
 }
 
+static void test_large(void)
+{
+    picture_t *pics[256];
+
+    pool = picture_pool_NewFromFormat(&fmt, 256);
+    assert(pool != NULL);
+
+    for (unsigned i = 0; i < 256; i++) {
+        pics[i] = picture_pool_Get(pool);
+        assert(pics[i] != NULL);
+    }
+    assert(picture_pool_Get(pool) == NULL);
+
+    for (unsigned i = 0; i < 256; i += 2)
+        picture_Release(pics[i]);
+    for (unsigned i = 0; i < 256; i += 2) {
+        pics[i] = picture_pool_Wait(pool);
+        assert(pics[i] != NULL);
+    }
+    assert(picture_pool_Get(pool) == NULL);
+
+    for (unsigned i = 0; i < 256; i++)
+        picture_Release(pics[i]);
+    picture_pool_Release(pool);
+}
+
+static atomic_uint owners[PICTURES];
+
+static void *contend(void *data)
+{
+    uint8_t *const *planes = data;
+
+    for (unsigned i = 0; i < ITERATIONS; i++) {
+        picture_t *pic = picture_pool_Wait(pool);
+        assert(pic != NULL);
+
+        /* Each picture must have a single owner at a time */
+        unsigned idx = 0;
+        while (planes[idx] != pic->p[0].p_pixels)
+            idx++;
+        assert(atomic_fetch_add(&owners[idx], 1) == 0);
+        atomic_fetch_sub(&owners[idx], 1);
+
+        picture_Release(pic);
+    }
+    return NULL;
+}
+
+static void test_contention(unsigned count)
+{
+    picture_t *pics[PICTURES];
+    uint8_t *planes[PICTURES];
+    vlc_thread_t th[THREADS];
+
+    pool = picture_pool_NewFromFormat(&fmt, count);
+    assert(pool != NULL);
+
+    /* Clones share the pool picture planes */
+    for (unsigned i = 0; i < count; i++) {
+        pics[i] = picture_pool_Get(pool);
+        assert(pics[i] != NULL);
+        planes[i] = pics[i]->p[0].p_pixels;
+        atomic_init(&owners[i], 0);
+    }
+    for (unsigned i = 0; i < count; i++)
+        picture_Release(pics[i]);
+
+    vlc_tick_t start = vlc_tick_now();
+    for (unsigned i = 0; i < THREADS; i++)
+        assert(vlc_clone(&th[i], contend, planes) == 0);
+    for (unsigned i = 0; i < THREADS; i++)
+        vlc_join(th[i], NULL);
+    vlc_tick_t elapsed = vlc_tick_now() - start;
+
+    printf("%u threads, %u pictures: %"PRId64" ns per get/release\n",
+           THREADS, count,
+           NS_FROM_VLC_TICK(elapsed) / (THREADS * ITERATIONS));
+
+    picture_pool_Release(pool);
+}
+
 int main(void)
 {
     video_format_Setup(&fmt, VLC_CODEC_I420, 320, 200, 320, 200, 1, 1);
@@ -98,6 +186,10 @@ int main(void)
 
     test(false);
     test(true);
+    test_large();
+
+    test_contention(PICTURES);
+    test_contention(THREADS / 2);
 
     return 0;
 }
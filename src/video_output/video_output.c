@@ -396,6 +396,12 @@ void vout_PutPicture(vout_thread_t *vout, picture_t *picture)
     vout_thread_sys_t *sys = VOUT_THREAD_TO_SYS(vout);
     assert(!sys->dummy);
     assert( !picture_HasChainedPics( picture ) );
+
+    struct vlc_tracer *tracer = GetTracer(sys);
+    if (tracer != NULL)
+        vlc_tracer_TraceStreamPTS(tracer, "VOUT", sys->str_id, "IN",
+                                  picture->date);
+
     picture_fifo_Push(sys->decoder_fifo, picture);
     vout_control_Wake(&sys->control);
 }
@@ -984,6 +990,7 @@ static picture_t *PreparePicture(vout_thread_sys_t *vout, bool reuse_decoded,
 {
     vout_thread_sys_t *sys = vout;
     bool is_late_dropped = sys->is_late_dropped && !frame_by_frame;
+    struct vlc_tracer *tracer = GetTracer(sys);
 
     vlc_mutex_lock(&sys->filter.lock);
 
@@ -1001,6 +1008,10 @@ static picture_t *PreparePicture(vout_thread_sys_t *vout, bool reuse_decoded,
             if (decoded == NULL)
                 break;
 
+            if (tracer != NULL)
+                vlc_tracer_TraceStreamPTS(tracer, "VOUT", sys->str_id, "OUT",
+                                          decoded->date);
+
             if (!decoded->b_force)
             {
                 const vlc_tick_t system_now = vlc_tick_now();
@@ -1062,6 +1073,10 @@ static picture_t *PreparePicture(vout_thread_sys_t *vout, bool reuse_decoded,
         sys->displayed.timestamp     = decoded->date;
         sys->displayed.is_interlaced = !decoded->b_progressive;
 
+        if (tracer != NULL)
+            vlc_tracer_TraceStreamPTS(tracer, "FILTER", sys->str_id, "IN",
+                                      decoded->date);
+
         vout_chrono_Start(&sys->chrono.static_filter);
         picture = filter_chain_VideoFilter(sys->filter.chain_static, sys->displayed.decoded);
         vout_chrono_Stop(&sys->chrono.static_filter);
@@ -1069,6 +1084,11 @@ static picture_t *PreparePicture(vout_thread_sys_t *vout, bool reuse_decoded,
 
     vlc_mutex_unlock(&sys->filter.lock);
 
+    /* Also covers pictures left in the chain by a previous input picture */
+    if (tracer != NULL && picture != NULL)
+        vlc_tracer_TraceStreamPTS(tracer, "FILTER", sys->str_id, "OUT",
+                                  picture->date);
+
     return picture;
 }
 
@@ -1372,12 +1392,18 @@ static int RenderPicture(vout_thread_sys_t *sys, bool render_now)
     const unsigned frame_rate = todisplay->format.i_frame_rate;
     const unsigned frame_rate_base = todisplay->format.i_frame_rate_base;
 
+    struct vlc_tracer *tracer = GetTracer(sys);
+    if (tracer != NULL)
+        vlc_tracer_TraceStreamPTS(tracer, "PREPARE", sys->str_id, "IN", pts);
+
     if (vd->ops->prepare != NULL)
         vd->ops->prepare(vd, todisplay, subpic, system_pts);
 
+    if (tracer != NULL)
+        vlc_tracer_TraceStreamPTS(tracer, "PREPARE", sys->str_id, "OUT", pts);
+
     vout_chrono_Stop(&sys->chrono.render);
 
-    struct vlc_tracer *tracer = GetTracer(sys);
     system_now = vlc_tick_now();
     if (!render_now)
     {
@@ -1439,7 +1465,11 @@ static int RenderPicture(vout_thread_sys_t *sys, bool render_now)
     }
 
     /* Display the direct buffer returned by vout_RenderPicture */
+    if (tracer != NULL)
+        vlc_tracer_TraceStreamPTS(tracer, "DISPLAY", sys->str_id, "IN", pts);
     vout_display_Display(vd, todisplay);
+    if (tracer != NULL)
+        vlc_tracer_TraceStreamPTS(tracer, "DISPLAY", sys->str_id, "OUT", pts);
     vlc_clock_Lock(sys->clock);
     vlc_tick_t drift = vlc_clock_UpdateVideo(sys->clock,
                                              vlc_tick_now(),
@@ -0,0 +1,121 @@
+/*****************************************************************************
+ * ts_pid.c: MPEG TS PID list tests
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <vlc_common.h>
+#include <vlc_demux.h>
+#include <vlc_tick.h>
+
+#include "../../../modules/demux/mpeg/ts_pid.h"
+#include "../../../modules/demux/mpeg/ts_streams.h"
+
+#include "../../libvlc/test.h"
+
+/* Only the list is exercised, PIDs are never set up */
+ts_pat_t *ts_pat_New( demux_t *d ) { VLC_UNUSED(d); return NULL; }
+void ts_pat_Del( demux_t *d, ts_pat_t *p ) { VLC_UNUSED(d); VLC_UNUSED(p); }
+ts_pmt_t *ts_pmt_New( demux_t *d ) { VLC_UNUSED(d); return NULL; }
+void ts_pmt_Del( demux_t *d, ts_pmt_t *p ) { VLC_UNUSED(d); VLC_UNUSED(p); }
+ts_stream_t *ts_stream_New( demux_t *d, ts_pmt_t *p )
+    { VLC_UNUSED(d); VLC_UNUSED(p); return NULL; }
+void ts_stream_Del( demux_t *d, ts_stream_t *p ) { VLC_UNUSED(d); VLC_UNUSED(p); }
+ts_si_t *ts_si_New( demux_t *d ) { VLC_UNUSED(d); return NULL; }
+void ts_si_Del( demux_t *d, ts_si_t *p ) { VLC_UNUSED(d); VLC_UNUSED(p); }
+ts_psip_t *ts_psip_New( demux_t *d ) { VLC_UNUSED(d); return NULL; }
+void ts_psip_Del( demux_t *d, ts_psip_t *p ) { VLC_UNUSED(d); VLC_UNUSED(p); }
+
+#define ASSERT(a) do {\
+    if(!(a)) { \
+        fprintf(stderr, "failed line %d\n", __LINE__); \
+        return 1; } \
+    } while(0)
+
+#define PID_COUNT    64
+#define PACKET_COUNT (1 << 22)
+
+static ts_pid_list_t list;
+
+int main(void)
+{
+    uint16_t pids[PID_COUNT];
+    ts_pid_t *refs[PID_COUNT];
+
+    test_init();
+
+    ts_pid_list_Init(&list);
+
+    /* fixed pids */
+    ASSERT(ts_pid_Get(&list, 0) == &list.pat);
+    ASSERT(ts_pid_Get(&list, 0x1FFB) == &list.base_si);
+    ASSERT(ts_pid_Get(&list, 0x1FFF) == &list.dummy);
+    ASSERT(list.i_all == 0);
+
+    /* full transponder like sample, created in descending order */
+    for(int i=0; i<PID_COUNT; i++)
+    {
+        pids[i] = 0x1F00 - i * 97;
+        refs[i] = ts_pid_Get(&list, pids[i]);
+        ASSERT(refs[i]);
+        ASSERT(refs[i]->i_pid == pids[i]);
+        ASSERT(refs[i]->i_cc == 0xff);
+    }
+    ASSERT(list.i_all == PID_COUNT);
+
+    /* storage is stable and lookups do not create */
+    for(int i=0; i<PID_COUNT; i++)
+        ASSERT(ts_pid_Get(&list, pids[i]) == refs[i]);
+    ASSERT(list.i_all == PID_COUNT);
+
+    /* iteration is sorted by pid */
+    ts_pid_next_context_t ctx = ts_pid_NextContextInitValue;
+    ts_pid_t *p_pid, *p_prev = NULL;
+    int i_count = 0;
+    while((p_pid = ts_pid_Next(&list, &ctx)))
+    {
+        ASSERT(!p_prev || p_prev->i_pid < p_pid->i_pid);
+        p_prev = p_pid;
+        i_count++;
+    }
+    ASSERT(i_count == PID_COUNT);
+
+    /* per packet lookup cost on heavily interleaved pids */
+    uint32_t seed = 0x5EED;
+    unsigned i_hits = 0;
+    vlc_tick_t start = vlc_tick_now();
+    for(unsigned i=0; i<PACKET_COUNT; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        const unsigned i_ref = (seed >> 16) % PID_COUNT;
+        i_hits += ts_pid_Get(&list, pids[i_ref]) == refs[i_ref];
+    }
+    vlc_tick_t elapsed = vlc_tick_now() - start;
+    ASSERT(i_hits == PACKET_COUNT);
+    ASSERT(list.i_all == PID_COUNT);
+
+    fprintf(stderr, "%u lookups over %d pids: %"PRId64" us, %.2f ns/packet\n",
+            PACKET_COUNT, PID_COUNT, US_FROM_VLC_TICK(elapsed),
+            US_FROM_VLC_TICK(elapsed) * 1000.0 / PACKET_COUNT);
+
+    ts_pid_list_Release(NULL, &list);
+
+    return 0;
+}
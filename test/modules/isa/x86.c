@@ -0,0 +1,340 @@
+/*****************************************************************************
+ * x86.c: x86 SIMD kernels tests
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdalign.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vlc_common.h>
+#include <vlc_cpu.h>
+
+#include "../../../modules/isa/x86/avx2.h"
+
+/* Each kernel is compared against the C code it replaces, with sizes
+ * covering both the vector loops and the scalar tails, and unaligned
+ * buffers. */
+
+#define ASSERT(a) do {\
+    if(!(a)) { \
+        fprintf(stderr, "failed line %d\n", __LINE__); \
+        return 1; } \
+    } while(0)
+
+#define WIDTH  301
+#define HEIGHT 9
+#define PITCH  (2 * WIDTH + 37)
+
+static alignas (32) uint8_t bufs[5][(HEIGHT * PITCH + 127) & ~63];
+
+static void fill(void *buf, size_t len)
+{
+    uint8_t *p = buf;
+
+    while (len-- > 0)
+        *(p++) = rand();
+}
+
+static void fill_float(float *p, size_t count)
+{
+    while (count-- > 0)
+        *(p++) = (rand() - RAND_MAX / 2) / (float)RAND_MAX;
+}
+
+static int test_chroma(unsigned width, unsigned vshift, bool uyvy)
+{
+    uint8_t *y = bufs[0] + 1, *u = bufs[1] + 3, *v = bufs[2] + 5;
+    uint8_t *ref = bufs[3] + 7, *out = bufs[4] + 9;
+    const struct yuv_planes planes = { y, u, v, PITCH - 3, PITCH / 2 };
+    const struct yuv_pack pack = { out, PITCH };
+
+    fill(bufs, sizeof (bufs));
+    memcpy(out, ref, HEIGHT * PITCH);
+
+    for (unsigned i = 0; i < HEIGHT; i++)
+    {
+        uint8_t *p = ref + i * PITCH;
+        const uint8_t *py = y + i * planes.y_pitch;
+        const uint8_t *pu = u + (i >> vshift) * planes.uv_pitch;
+        const uint8_t *pv = v + (i >> vshift) * planes.uv_pitch;
+
+        for (unsigned x = 0; x < width; x += 2, p += 4)
+        {
+            p[uyvy ? 1 : 0] = py[x];
+            p[uyvy ? 0 : 1] = pu[x / 2];
+            p[uyvy ? 3 : 2] = py[x + 1];
+            p[uyvy ? 2 : 3] = pv[x / 2];
+        }
+    }
+
+    if (vshift)
+        (uyvy ? i420_uyvy_avx2 : i420_yuyv_avx2)(&pack, &planes, width,
+                                                 HEIGHT);
+    else
+        (uyvy ? i422_uyvy_avx2 : i422_yuyv_avx2)(&pack, &planes, width,
+                                                 HEIGHT);
+    ASSERT(memcmp(ref, out, HEIGHT * PITCH) == 0);
+
+    /* And back to planar 4:2:2 */
+    const struct yuv_pack in = { ref, PITCH };
+    uint8_t ry[HEIGHT * PITCH], ru[HEIGHT * PITCH], rv[HEIGHT * PITCH];
+    const struct yuv_planes oplanes = { y, u, v, PITCH, PITCH / 2 };
+
+    memcpy(ry, y, sizeof (ry));
+    memcpy(ru, u, sizeof (ru));
+    memcpy(rv, v, sizeof (rv));
+
+    for (unsigned i = 0; i < HEIGHT; i++)
+    {
+        const uint8_t *p = ref + i * PITCH;
+
+        for (unsigned x = 0; x < width; x += 2, p += 4)
+        {
+            ry[i * PITCH + x] = p[uyvy ? 1 : 0];
+            ru[i * (PITCH / 2) + x / 2] = p[uyvy ? 0 : 1];
+            ry[i * PITCH + x + 1] = p[uyvy ? 3 : 2];
+            rv[i * (PITCH / 2) + x / 2] = p[uyvy ? 2 : 3];
+        }
+    }
+
+    (uyvy ? uyvy_i422_avx2 : yuyv_i422_avx2)(&oplanes, &in, width, HEIGHT);
+    ASSERT(memcmp(ry, y, sizeof (ry)) == 0);
+    ASSERT(memcmp(ru, u, sizeof (ru)) == 0);
+    ASSERT(memcmp(rv, v, sizeof (rv)) == 0);
+    return 0;
+}
+
+static int test_deinterleave(unsigned width)
+{
+    uint8_t *src = bufs[0] + 1;
+    uint8_t *u = bufs[1] + 2, *v = bufs[2] + 3;
+    uint8_t *ru = bufs[3] + 2, *rv = bufs[4] + 3;
+    const struct yuv_pack in = { src, PITCH };
+    const struct uv_planes out = { u, v, PITCH / 2 + 1 };
+
+    fill(bufs, sizeof (bufs));
+    memcpy(ru, u, HEIGHT * out.pitch);
+    memcpy(rv, v, HEIGHT * out.pitch);
+
+    for (unsigned i = 0; i < HEIGHT; i++)
+        for (unsigned x = 0; x < width; x++)
+        {
+            ru[i * out.pitch + x] = src[i * PITCH + 2 * x];
+            rv[i * out.pitch + x] = src[i * PITCH + 2 * x + 1];
+        }
+
+    deinterleave_chroma_avx2(&out, &in, width, HEIGHT);
+    ASSERT(memcmp(ru, u, HEIGHT * out.pitch) == 0);
+    ASSERT(memcmp(rv, v, HEIGHT * out.pitch) == 0);
+    return 0;
+}
+
+static int test_merge(size_t len)
+{
+    uint8_t *s1 = bufs[0] + 1, *s2 = bufs[1] + 2;
+    uint8_t *out = bufs[2] + 3, *ref = bufs[3] + 3;
+
+    fill(bufs, sizeof (bufs));
+
+    for (size_t i = 0; i < len; i++)
+        ref[i] = (s1[i] + s2[i]) >> 1;
+    merge8_avx2(out, s1, s2, len);
+    ASSERT(memcmp(ref, out, len) == 0);
+
+    /* 16-bit samples must be aligned to their size */
+    uint16_t *w1 = (uint16_t *)bufs[0] + 1, *w2 = (uint16_t *)bufs[1] + 3;
+    uint16_t *wout = (uint16_t *)bufs[2] + 5, *wref = (uint16_t *)bufs[3] + 5;
+
+    for (size_t i = 0; i < len / 2; i++)
+        wref[i] = (w1[i] + w2[i]) >> 1;
+    merge16_avx2(wout, w1, w2, len & ~1);
+    ASSERT(memcmp(wref, wout, len & ~1) == 0);
+    return 0;
+}
+
+static int test_amplify(size_t count)
+{
+    float *f = (float *)bufs[0] + 1, *fref = (float *)bufs[1] + 1;
+    const float famp = 0.7f;
+
+    fill_float(f, count);
+    for (size_t i = 0; i < count; i++)
+        fref[i] = f[i] * famp;
+    amplify_f32_avx2(f, count * sizeof (*f), famp);
+    ASSERT(memcmp(f, fref, count * sizeof (*f)) == 0);
+
+    double *d = (double *)bufs[2] + 1, *dref = (double *)bufs[3] + 1;
+    const double damp = 1.3f;
+
+    for (size_t i = 0; i < count; i++)
+        d[i] = dref[i] = f[i];
+    for (size_t i = 0; i < count; i++)
+        dref[i] *= damp;
+    amplify_f64_avx2(d, count * sizeof (*d), damp);
+    ASSERT(memcmp(d, dref, count * sizeof (*d)) == 0);
+
+    /* Amplification factors saturating, or not, in both directions */
+    static const int16_t amps[] = { 0, 77, 255, 257, 640, INT16_MAX };
+
+    for (size_t a = 0; a < ARRAY_SIZE(amps); a++)
+    {
+        int16_t *s = (int16_t *)bufs[0] + 1, *sref = (int16_t *)bufs[1] + 1;
+
+        fill(bufs, sizeof (bufs));
+        for (size_t i = 0; i < count; i++)
+        {
+            int_fast32_t v = (s[i] * (int_fast32_t)amps[a]) >> 8;
+            sref[i] = v > INT16_MAX ? INT16_MAX : v < INT16_MIN ? INT16_MIN : v;
+        }
+        amplify_s16_avx2(s, count * sizeof (*s), amps[a]);
+        ASSERT(memcmp(s, sref, count * sizeof (*s)) == 0);
+    }
+    return 0;
+}
+
+/* Reference versions of the simple channel mixer, one sample */
+static void mix_7_x_to_2_0(float *d, const float *s)
+{
+    float ctr = s[6] * 0.7071f;
+    d[0] = ctr + s[0] + s[2] / 4 + s[4] / 4;
+    d[1] = ctr + s[1] + s[3] / 4 + s[5] / 4;
+}
+
+static void mix_5_x_to_2_0(float *d, const float *s)
+{
+    d[0] = s[0] + 0.7071f * (s[4] + s[2]);
+    d[1] = s[1] + 0.7071f * (s[4] + s[3]);
+}
+
+static void mix_4_0_to_2_0(float *d, const float *s)
+{
+    d[0] = s[2] + s[3] + 0.5f * s[0];
+    d[1] = s[2] + s[3] + 0.5f * s[1];
+}
+
+static void mix_3_x_to_2_0(float *d, const float *s)
+{
+    d[0] = s[2] + 0.5f * s[0];
+    d[1] = s[2] + 0.5f * s[1];
+}
+
+static void mix_7_x_to_1_0(float *d, const float *s)
+{
+    d[0] = s[6] + s[0] / 4 + s[1] / 4 + s[2] / 8 + s[3] / 8 + s[4] / 8
+         + s[5] / 8;
+}
+
+static void mix_5_x_to_1_0(float *d, const float *s)
+{
+    d[0] = 0.7071f * (s[0] + s[1]) + s[4] + 0.5f * (s[2] + s[3]);
+}
+
+static void mix_7_x_to_4_0(float *d, const float *s)
+{
+    d[0] = s[6] + 0.5f * s[0] + s[2] / 6;
+    d[1] = s[6] + 0.5f * s[1] + s[3] / 6;
+    d[2] = s[2] / 6 + s[4];
+    d[3] = s[3] / 6 + s[5];
+}
+
+static void mix_5_x_to_4_0(float *d, const float *s)
+{
+    float ctr = s[4] * 0.7071f;
+    d[0] = s[0] + ctr;
+    d[1] = s[1] + ctr;
+    d[2] = s[2];
+    d[3] = s[3];
+}
+
+static const struct
+{
+    void (*ref)(float *, const float *);
+    void (*avx2)(float *, const float *, int, bool);
+    unsigned in, out;
+    bool lfe;
+} mixers[] = {
+#define MIXER(i, o, ic, oc, lfe) \
+    { mix_##i##_to_##o, convert_##i##_to_##o##_avx2, ic, oc, lfe }
+    MIXER(7_x, 2_0, 7, 2, true),
+    MIXER(5_x, 2_0, 5, 2, true),
+    MIXER(4_0, 2_0, 4, 2, false),
+    MIXER(3_x, 2_0, 3, 2, true),
+    MIXER(7_x, 1_0, 7, 1, true),
+    MIXER(5_x, 1_0, 5, 1, true),
+    MIXER(7_x, 4_0, 7, 4, true),
+    MIXER(5_x, 4_0, 5, 4, true),
+#undef MIXER
+};
+
+static int test_mixer(int samples)
+{
+    float *src = (float *)bufs[0] + 1;
+    float *out = (float *)bufs[1] + 1, *ref = (float *)bufs[2] + 1;
+
+    for (size_t m = 0; m < ARRAY_SIZE(mixers); m++)
+        for (unsigned lfe = 0; lfe <= mixers[m].lfe; lfe++)
+        {
+            const unsigned channels = mixers[m].in + lfe;
+
+            fill_float(src, samples * channels);
+            for (int i = 0; i < samples; i++)
+                mixers[m].ref(ref + i * mixers[m].out, src + i * channels);
+            mixers[m].avx2(out, src, samples, lfe);
+            ASSERT(memcmp(out, ref,
+                          samples * mixers[m].out * sizeof (*out)) == 0);
+        }
+    return 0;
+}
+
+int main(void)
+{
+    if (!vlc_CPU_AVX2())
+    {
+        fprintf(stderr, "AVX2 not supported, skipping\n");
+        return 77;
+    }
+
+    srand(0);
+
+    for (unsigned width = 2; width <= WIDTH; width += 14)
+        for (unsigned vshift = 0; vshift < 2; vshift++)
+        {
+            ASSERT(test_chroma(width, vshift, false) == 0);
+            ASSERT(test_chroma(width, vshift, true) == 0);
+        }
+
+    for (unsigned width = 1; width <= PITCH / 2 - 8; width += 13)
+        ASSERT(test_deinterleave(width) == 0);
+
+    for (size_t len = 0; len < 400; len += 7)
+        ASSERT(test_merge(len) == 0);
+
+    for (size_t count = 0; count < 200; count += 5)
+        ASSERT(test_amplify(count) == 0);
+
+    for (int samples = 0; samples < 100; samples += 3)
+        ASSERT(test_mixer(samples) == 0);
+
+    return 0;
+}
@@ -137,6 +137,23 @@ static int OpenFilter(filter_t *filter)
     return VLC_SUCCESS;
 }
 
+static picture_t *PassthroughFilter(filter_t *filter, picture_t *input)
+    { (void)filter; return input; }
+
+static int OpenPassthroughFilter(filter_t *filter)
+{
+    es_format_Clean(&filter->fmt_out);
+    es_format_Copy(&filter->fmt_out, &filter->fmt_in);
+
+    static const struct vlc_filter_operations ops = {
+        .filter_video = PassthroughFilter,
+        .close = NULL,
+    };
+    filter->ops = &ops;
+
+    return VLC_SUCCESS;
+}
+
 static picture_t *ConverterFilter(filter_t *filter, picture_t *input)
 {
     video_format_Clean(&input->format);
@@ -172,10 +189,18 @@ static vlc_frame_t *EncodeVideo(encoder_t *enc, picture_t *pic)
 
     assert(pic->format.i_chroma == enc->fmt_in.video.i_chroma);
     vlc_frame_t *frame = vlc_frame_Alloc(4);
+    assert(frame != NULL);
+    frame->i_dts = frame->i_pts = pic->date;
+    if (enc->fmt_in.video.i_frame_rate != 0)
+        frame->i_length =
+            vlc_tick_from_samples(enc->fmt_in.video.i_frame_rate_base,
+                                  enc->fmt_in.video.i_frame_rate);
 
     struct transcode_scenario *scenario = &transcode_scenarios[current_scenario];
     if (scenario->encoder_encode != NULL)
         scenario->encoder_encode(enc, pic);
+    if (scenario->encoder_output != NULL)
+        scenario->encoder_output(enc, frame);
     return frame;
 }
 
@@ -243,11 +268,12 @@ static int OpenErrorChecker(vlc_object_t *obj)
 
 static int OutputCheckerSend(sout_stream_t *stream, void *id, vlc_frame_t *f)
 {
-    (void)stream; (void)id;
+    (void)stream;
     struct transcode_scenario *scenario = &transcode_scenarios[current_scenario];
 
+    /* The ID is the ES ID given by the upstream */
     assert(scenario->report_output != NULL);
-    scenario->report_output(f);
+    scenario->report_output(id, f);
 
     vlc_frame_ChainRelease(f);
 
@@ -257,12 +283,33 @@ static int OutputCheckerSend(sout_stream_t *stream, void *id, vlc_frame_t *f)
 static void *OutputCheckerAdd(sout_stream_t *stream, const es_format_t *fmt,
                               const char *es_id)
 {
-    (void)stream; (void)fmt; (void)es_id;
-    return (void*)0x42;
+    (void)stream;
+    struct transcode_scenario *scenario = &transcode_scenarios[current_scenario];
+
+    assert(es_id != NULL);
+    if (scenario->report_es_add != NULL)
+        scenario->report_es_add(fmt, es_id);
+    return strdup(es_id);
 }
 
 static void OutputCheckerDel(sout_stream_t *stream, void *id)
-    { (void)stream; (void)id; }
+{
+    (void)stream;
+    struct transcode_scenario *scenario = &transcode_scenarios[current_scenario];
+
+    if (scenario->report_es_del != NULL)
+        scenario->report_es_del(id);
+    free(id);
+}
+
+static void OutputCheckerSetPCR(sout_stream_t *stream, vlc_tick_t pcr)
+{
+    (void)stream;
+    struct transcode_scenario *scenario = &transcode_scenarios[current_scenario];
+
+    if (scenario->report_pcr != NULL)
+        scenario->report_pcr(pcr);
+}
 
 static int OpenOutputChecker(vlc_object_t *obj)
 {
@@ -272,6 +319,7 @@ static int OpenOutputChecker(vlc_object_t *obj)
         .add = OutputCheckerAdd,
         .del = OutputCheckerDel,
         .send = OutputCheckerSend,
+        .set_pcr = OutputCheckerSetPCR,
     };
     stream->ops = &ops;
     return VLC_SUCCESS;
@@ -357,6 +405,7 @@ static int OpenIntf(vlc_object_t *obj)
  *  - access for triggering the correct decoder
  *  - decoder for generating video format and context
  *  - filter for generating video format and context
+ *  - passthrough filter to be used as a user filter
  *  - encoder to check the previous video format and context
  **/
 vlc_module_begin()
@@ -379,6 +428,10 @@ vlc_module_begin()
     add_submodule()
         set_callback_video_filter(OpenFilter)
 
+    add_submodule()
+        set_callback_video_filter(OpenPassthroughFilter)
+        add_shortcut("test_passthrough")
+
     add_submodule()
         set_callback_video_converter(OpenConverter, INT_MAX)
 
@@ -33,10 +33,15 @@ struct transcode_scenario {
     void (*encoder_setup)(encoder_t *);
     void (*encoder_close)(encoder_t *);
     void (*encoder_encode)(encoder_t *, picture_t *);
+    void (*encoder_output)(encoder_t *, vlc_frame_t *);
     void (*filter_setup)(filter_t *);
     void (*converter_setup)(filter_t *);
     void (*report_error)(sout_stream_t *);
-    void (*report_output)(const vlc_frame_t *);
+    void (*report_output)(const char *es_id, const vlc_frame_t *);
+    void (*report_es_add)(const es_format_t *, const char *es_id);
+    void (*report_es_del)(const char *es_id);
+    void (*report_pcr)(vlc_tick_t pcr);
+    unsigned output_es_count;
 };
 
 
@@ -36,6 +36,20 @@ static struct scenario_data
     vlc_sem_t wait_stop;
     struct vlc_video_context *decoder_vctx;
     unsigned output_frame_count;
+    unsigned decoded_frame_count;
+    struct
+    {
+        char *es_id;
+        int i_id;
+        unsigned height;
+        unsigned frame_count;
+        bool deleted;
+    } es[4];
+    size_t es_count;
+    size_t es_deleted;
+    vlc_tick_t last_pcr;
+    vlc_tick_t last_dts;
+    vlc_tick_t last_pts;
     bool converter_opened;
     bool encoder_opened;
     bool encoder_closed;
@@ -136,6 +150,12 @@ static int decoder_decode_vctx_update(decoder_t *dec, picture_t *pic)
     return VLC_SUCCESS;
 }
 
+static int decoder_decode_counted(decoder_t *dec, picture_t *pic)
+{
+    scenario_data.decoded_frame_count++;
+    return decoder_decode_dummy(dec, pic);
+}
+
 static int decoder_decode_error(decoder_t *dec, picture_t *pic)
 {
     (void)dec;
@@ -180,6 +200,39 @@ static void encoder_i420_800_600_vctx(encoder_t *enc)
     assert(enc->vctx_in == scenario_data.decoder_vctx);
 }
 
+static void encoder_i420_renditions(encoder_t *enc)
+{
+    /* The main encoder is opened first, then one for each rendition */
+    if (!scenario_data.encoder_opened)
+    {
+        encoder_i420_800_600(enc);
+        return;
+    }
+
+    assert(enc->fmt_in.video.i_visible_height == 300 ||
+           enc->fmt_in.video.i_visible_height == 150);
+    enc->fmt_in.video.i_chroma
+        = enc->fmt_in.i_codec
+        = VLC_CODEC_I420;
+}
+
+static void encoder_i420_segments(encoder_t *enc)
+{
+    /* The main encoder is opened first, then one for each segment, with
+     * the input format of the main one */
+    if (!scenario_data.encoder_opened)
+    {
+        encoder_i420_800_600(enc);
+        return;
+    }
+
+    assert(enc->fmt_in.video.i_visible_width == 800 &&
+           enc->fmt_in.video.i_visible_height == 600);
+    enc->fmt_in.video.i_chroma
+        = enc->fmt_in.i_codec
+        = VLC_CODEC_I420;
+}
+
 #if 0
 static void encoder_nv12_800_600_no_vctx(encoder_t *enc)
 {
@@ -200,28 +253,145 @@ static void encoder_encode_dummy(encoder_t *enc, picture_t *pic)
     msg_Info(enc, "Encode");
 }
 
+static void encoder_output_restart_dts(encoder_t *enc, vlc_frame_t *frame)
+{
+    /* Like an encoder reordering the pictures, start the DTS of each
+     * encoder instance two pictures before its first PTS */
+    if (enc->p_sys == NULL && frame->i_dts != VLC_TICK_INVALID)
+    {
+        frame->i_dts -= 2 * frame->i_length;
+        enc->p_sys = enc;
+    }
+}
+
 static void encoder_close(encoder_t *enc)
 {
     (void)enc;
     scenario_data.encoder_closed = true;
 }
 
-static void wait_output_10_frames_reported(const vlc_frame_t *out)
+static void wait_output_10_frames_reported(const char *es_id,
+                                           const vlc_frame_t *out)
 {
-    // Count frame output.
+    (void)es_id;
+    unsigned previous_count = scenario_data.output_frame_count;
+
+    // Count frame output, threaded encoders can output several at once.
     for (; out != NULL; out = out->p_next )
         ++scenario_data.output_frame_count;
 
-    if (scenario_data.output_frame_count == 10)
+    if (previous_count < 10 && scenario_data.output_frame_count >= 10)
         vlc_sem_post(&scenario_data.wait_stop);
 }
 
-static void wait_output_reported(const vlc_frame_t *out)
+static void wait_output_reported(const char *es_id, const vlc_frame_t *out)
 {
-    (void)out;
+    (void)es_id; (void)out;
     vlc_sem_post(&scenario_data.wait_stop);
 }
 
+static void output_es_add(const es_format_t *fmt, const char *es_id)
+{
+    assert(scenario_data.es_count < ARRAY_SIZE(scenario_data.es));
+    size_t i = scenario_data.es_count++;
+
+    scenario_data.es[i].es_id = strdup(es_id);
+    assert(scenario_data.es[i].es_id != NULL);
+    scenario_data.es[i].i_id = fmt->i_id;
+    scenario_data.es[i].height = fmt->video.i_visible_height;
+    scenario_data.es[i].frame_count = 0;
+    scenario_data.es[i].deleted = false;
+}
+
+static size_t output_es_find(const char *es_id)
+{
+    for (size_t i = 0; i < scenario_data.es_count; ++i)
+        if (strcmp(scenario_data.es[i].es_id, es_id) == 0)
+            return i;
+    vlc_assert_unreachable();
+}
+
+static void count_es_output(const char *es_id, const vlc_frame_t *out)
+{
+    size_t i = output_es_find(es_id);
+    assert(!scenario_data.es[i].deleted);
+
+    for (; out != NULL; out = out->p_next)
+        ++scenario_data.es[i].frame_count;
+}
+
+static void wait_output_10_monotonic_frames(const char *es_id,
+                                            const vlc_frame_t *out)
+{
+    for (const vlc_frame_t *f = out; f != NULL; f = f->p_next)
+    {
+        assert(f->i_dts != VLC_TICK_INVALID && f->i_pts != VLC_TICK_INVALID);
+        assert(f->i_dts <= f->i_pts);
+        assert(scenario_data.last_dts == VLC_TICK_INVALID ||
+               f->i_dts > scenario_data.last_dts);
+        assert(scenario_data.last_pts == VLC_TICK_INVALID ||
+               f->i_pts > scenario_data.last_pts);
+        scenario_data.last_dts = f->i_dts;
+        scenario_data.last_pts = f->i_pts;
+    }
+
+    wait_output_10_frames_reported(es_id, out);
+}
+
+static void record_pcr(vlc_tick_t pcr)
+{
+    assert(scenario_data.last_pcr == VLC_TICK_INVALID ||
+           pcr >= scenario_data.last_pcr);
+    scenario_data.last_pcr = pcr;
+}
+
+static void count_es_output_after_pcr(const char *es_id,
+                                      const vlc_frame_t *out)
+{
+    /* No ES may output a frame the forwarded PCR has already passed */
+    for (const vlc_frame_t *f = out; f != NULL; f = f->p_next)
+        assert(scenario_data.last_pcr == VLC_TICK_INVALID ||
+               f->i_dts >= scenario_data.last_pcr);
+
+    count_es_output(es_id, out);
+}
+
+static void check_rendition_es_add(const es_format_t *fmt, const char *es_id)
+{
+    output_es_add(fmt, es_id);
+
+    /* The renditions are added after the video ES they are encoded from,
+     * and let the muxers pick their ID */
+    if (scenario_data.es_count == 1)
+    {
+        assert(fmt->i_id != -1);
+        return;
+    }
+    assert(fmt->i_id == -1);
+    assert(fmt->video.i_visible_height == 300 ||
+           fmt->video.i_visible_height == 150);
+
+    char *expected;
+    int ret = asprintf(&expected, "%s/%up", scenario_data.es[0].es_id,
+                       fmt->video.i_visible_height);
+    assert(ret >= 0);
+    assert(strcmp(es_id, expected) == 0);
+    free(expected);
+}
+
+static void wait_es_drained(const char *es_id)
+{
+    /* Every decoded picture must have been encoded once the ES is gone */
+    size_t i = output_es_find(es_id);
+    assert(scenario_data.decoded_frame_count > 0);
+    assert(scenario_data.es[i].frame_count ==
+           scenario_data.decoded_frame_count);
+
+    scenario_data.es[i].deleted = true;
+    if (++scenario_data.es_deleted == scenario_data.es_count)
+        vlc_sem_post(&scenario_data.wait_stop);
+}
+
 static void converter_fixed_size(filter_t *filter, vlc_fourcc_t chroma_in,
         vlc_fourcc_t chroma_out, unsigned width, unsigned height)
 {
@@ -259,7 +429,21 @@ static void converter_i420_to_nv12_800_600_vctx(filter_t *filter)
     assert(filter->vctx_in == scenario_data.decoder_vctx);
 }
 
+static void converter_i420_renditions(filter_t *filter)
+{
+    /* Each rendition is scaled from the next larger one */
+    assert(filter->fmt_in.video.i_chroma == VLC_CODEC_I420);
+    assert(filter->fmt_out.video.i_chroma == VLC_CODEC_I420);
+    assert(filter->fmt_out.video.i_visible_height == 300 ||
+           filter->fmt_out.video.i_visible_height == 150);
+    assert(filter->fmt_in.video.i_visible_height ==
+           2 * filter->fmt_out.video.i_visible_height);
+
+    scenario_data.converter_opened = true;
+}
+
 const char source_800_600[] = "mock://video_track_count=1;length=100000000000;video_width=800;video_height=600";
+const char source_800_600_short[] = "mock://video_track_count=1;length=400000;video_width=800;video_height=600";
 struct transcode_scenario transcode_scenarios[] =
 {{
     .source = source_800_600,
@@ -356,6 +540,59 @@ struct transcode_scenario transcode_scenarios[] =
     .encoder_close = encoder_close,
     .converter_setup = converter_nv12_to_i420_800_600_vctx,
     .report_output = wait_output_10_frames_reported,
+},{
+    /* Make sure the encoder thread outputs frames without waiting for the
+     * end of the stream. */
+    .source = source_800_600,
+    .sout = "sout=#transcode{threads=2,pool-size=4}:output_checker",
+    .decoder_setup = decoder_i420_800_600,
+    .decoder_decode = decoder_decode_dummy,
+    .encoder_setup = encoder_i420_800_600,
+    .encoder_encode = encoder_encode_dummy,
+    .encoder_close = encoder_close,
+    .report_output = wait_output_10_frames_reported,
+},{
+    /* Make sure the segments encoded concurrently are output once
+     * complete. */
+    .source = source_800_600,
+    .sout = "sout=#transcode{segments=2,segment-length=4}:output_checker",
+    .decoder_setup = decoder_i420_800_600,
+    .decoder_decode = decoder_decode_dummy,
+    .encoder_setup = encoder_i420_segments,
+    .encoder_encode = encoder_encode_dummy,
+    .encoder_output = encoder_output_restart_dts,
+    .encoder_close = encoder_close,
+    .report_output = wait_output_10_monotonic_frames,
+},{
+    /* Make sure the pictures still queued in the pipelined user filters
+     * are encoded when the stream ends. */
+    .source = source_800_600_short,
+    .sout = "sout=#transcode{vfilter=test_passthrough,vfilter-pipeline=2}:output_checker",
+    .decoder_setup = decoder_i420_800_600,
+    .decoder_decode = decoder_decode_counted,
+    .encoder_setup = encoder_i420_800_600,
+    .encoder_encode = encoder_encode_dummy,
+    .encoder_close = encoder_close,
+    .report_output = count_es_output,
+    .report_es_add = output_es_add,
+    .report_es_del = wait_es_drained,
+    .output_es_count = 1,
+},{
+    /* Make sure each rendition gets its own ES and every picture, including
+     * the ones still queued in the threaded encoders at the end. */
+    .source = source_800_600_short,
+    .sout = "sout=#transcode{threads=2,renditions=\"300,150\"}:output_checker",
+    .decoder_setup = decoder_i420_800_600,
+    .decoder_decode = decoder_decode_counted,
+    .encoder_setup = encoder_i420_renditions,
+    .encoder_encode = encoder_encode_dummy,
+    .encoder_close = encoder_close,
+    .converter_setup = converter_i420_renditions,
+    .report_output = count_es_output_after_pcr,
+    .report_es_add = check_rendition_es_add,
+    .report_es_del = wait_es_drained,
+    .report_pcr = record_pcr,
+    .output_es_count = 3,
 },{
     /* Ensure that error are correctly forwarded back to the stream output
      * pipeline. */
@@ -372,6 +609,12 @@ void transcode_scenario_init(void)
 {
     scenario_data.decoder_vctx = NULL;
     scenario_data.output_frame_count = 0;
+    scenario_data.decoded_frame_count = 0;
+    scenario_data.es_count = 0;
+    scenario_data.es_deleted = 0;
+    scenario_data.last_pcr = VLC_TICK_INVALID;
+    scenario_data.last_dts = VLC_TICK_INVALID;
+    scenario_data.last_pts = VLC_TICK_INVALID;
     scenario_data.converter_opened = false;
     scenario_data.encoder_opened = false;
     vlc_sem_init(&scenario_data.wait_stop, 0);
@@ -393,4 +636,13 @@ void transcode_scenario_check(struct transcode_scenario *scenario)
 
     if (scenario_data.encoder_opened && scenario->encoder_close != NULL)
         assert(scenario_data.encoder_closed);
+
+    if (scenario->output_es_count != 0)
+    {
+        assert(scenario_data.es_count == scenario->output_es_count);
+        assert(scenario_data.es_deleted == scenario_data.es_count);
+    }
+
+    for (size_t i = 0; i < scenario_data.es_count; ++i)
+        free(scenario_data.es[i].es_id);
 }
@@ -0,0 +1,144 @@
+/*****************************************************************************
+ * blend.c: video blending tests and benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+#include <vlc_filter.h>
+#include <vlc_picture.h>
+
+#include "../../libvlc/test.h"
+#include "../lib/libvlc_internal.h"
+#include "picture_helpers.h"
+
+/* Blends a 720p overlay, as a subtitle or OSD would be, onto 1080p pictures
+ * for each chroma pair, checks a few invariants, then reports the speed in
+ * megapixels per second. The number of loops can be given as the first
+ * argument (e.g. "test_modules_video_filter_blend 500"). */
+
+#define DST_WIDTH  1920
+#define DST_HEIGHT 1080
+#define SRC_WIDTH  1280
+#define SRC_HEIGHT 720
+/* Odd offsets, to cover the partial chroma blocks and the vector tails */
+#define X_OFFSET   301
+#define Y_OFFSET   171
+
+static const vlc_fourcc_t dst_chromas[] = {
+    VLC_CODEC_I420, VLC_CODEC_YV12, VLC_CODEC_NV12, VLC_CODEC_NV21,
+    VLC_CODEC_RGBA, VLC_CODEC_BGRA, VLC_CODEC_ARGB, VLC_CODEC_RGBX,
+    VLC_CODEC_XRGB, VLC_CODEC_BGRX, VLC_CODEC_I422, VLC_CODEC_YUYV,
+};
+
+static const vlc_fourcc_t src_chromas[] = {
+    VLC_CODEC_YUVA, VLC_CODEC_RGBA,
+};
+
+/* Sets the alpha of all the source pixels, or half of them to random
+ * values if alpha is negative */
+static void SetAlpha(picture_t *src, int alpha)
+{
+    plane_t *p = &src->p[src->format.i_chroma == VLC_CODEC_YUVA ? A_PLANE : 0];
+    const unsigned step = src->format.i_chroma == VLC_CODEC_YUVA ? 1 : 4;
+    const unsigned offset = src->format.i_chroma == VLC_CODEC_YUVA ? 0 : 3;
+
+    for (int y = 0; y < p->i_visible_lines; y++)
+        for (int x = 0; x < p->i_visible_pitch; x += step)
+            p->p_pixels[y * p->i_pitch + x + offset] =
+                alpha >= 0 ? alpha : (rand() & 1) ? rand() : 0;
+}
+
+static void Test(vlc_object_t *obj, vlc_fourcc_t dst_chroma,
+                 vlc_fourcc_t src_chroma, unsigned loops)
+{
+    picture_t *dst = test_picture_NewRandomSize(dst_chroma, DST_WIDTH,
+                                                DST_HEIGHT);
+    picture_t *src = test_picture_NewRandomSize(src_chroma, SRC_WIDTH,
+                                                SRC_HEIGHT);
+    picture_t *ref = test_picture_NewRandomSize(dst_chroma, DST_WIDTH,
+                                                DST_HEIGHT);
+
+    vlc_blender_t *blend = filter_NewBlend(obj, &dst->format);
+    assert(blend != NULL);
+    int ret = filter_ConfigureBlend(blend, DST_WIDTH, DST_HEIGHT,
+                                    &src->format);
+    assert(ret == VLC_SUCCESS);
+
+    /* Fully transparent pixels do not touch the destination */
+    picture_CopyPixels(ref, dst);
+    SetAlpha(src, 0);
+    filter_Blend(blend, dst, X_OFFSET, Y_OFFSET, src, 255);
+    assert(test_picture_Equals(dst, ref));
+
+    /* Neither does a null global alpha */
+    SetAlpha(src, 255);
+    filter_Blend(blend, dst, X_OFFSET, Y_OFFSET, src, 0);
+    assert(test_picture_Equals(dst, ref));
+
+    /* Fully opaque YUVA replaces the luma */
+    if (src_chroma == VLC_CODEC_YUVA && dst_chroma == VLC_CODEC_I420)
+    {
+        filter_Blend(blend, dst, X_OFFSET, Y_OFFSET, src, 255);
+        for (unsigned y = 0; y < SRC_HEIGHT; y++)
+            assert(!memcmp(&dst->p[Y_PLANE].p_pixels[(Y_OFFSET + y) *
+                               dst->p[Y_PLANE].i_pitch + X_OFFSET],
+                           &src->p[Y_PLANE].p_pixels[y *
+                               src->p[Y_PLANE].i_pitch], SRC_WIDTH));
+    }
+
+    /* Translucent overlay, as anti-aliased subtitles */
+    SetAlpha(src, -1);
+
+    vlc_tick_t time = vlc_tick_now();
+    for (unsigned i = 0; i < loops; i++)
+        filter_Blend(blend, dst, X_OFFSET, Y_OFFSET, src, 192);
+    time = vlc_tick_now() - time;
+
+    test_log("%4.4s onto %4.4s: %8.1f Mpixels/s\n", (const char *)&src_chroma,
+             (const char *)&dst_chroma,
+             (double)loops * SRC_WIDTH * SRC_HEIGHT / 1000000.
+                 / secf_from_vlc_tick(time > 0 ? time : 1));
+
+    filter_DeleteBlend(blend);
+    picture_Release(ref);
+    picture_Release(src);
+    picture_Release(dst);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned loops = argc > 1 ? strtoul(argv[1], NULL, 0) : 4;
+
+    test_init();
+
+    libvlc_instance_t *vlc = libvlc_new(test_defaults_nargs,
+                                        test_defaults_args);
+    assert(vlc != NULL);
+
+    for (size_t i = 0; i < ARRAY_SIZE(src_chromas); i++)
+        for (size_t j = 0; j < ARRAY_SIZE(dst_chromas); j++)
+            Test(VLC_OBJECT(vlc->p_libvlc_int), dst_chromas[j],
+                 src_chromas[i], loops);
+
+    libvlc_release(vlc);
+    return 0;
+}
@@ -0,0 +1,169 @@
+/*****************************************************************************
+ * blend_rows.cpp: row blending bit-exactness tests
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/* Build the module in, for its internal blending functions */
+#define MODULE_NAME test_blend_rows
+#undef VLC_DYNAMIC_PLUGIN
+
+#include "../../../modules/video_filter/blend.cpp"
+
+#undef NDEBUG
+#include "picture_helpers.h"
+
+extern "C" const char vlc_module_name[];
+const char vlc_module_name[] = MODULE_STRING;
+
+/* Blends random YUVA and RGBA overlays with the row functions and with the
+ * per-pixel Blend(), which they replace for those chroma pairs, with random
+ * sizes, offsets and alpha, and checks that the results are the same. */
+
+#define LOOPS 64
+
+static const struct {
+    vlc_fourcc_t     dst;
+    vlc_fourcc_t     src;
+    blend_function_t blend;
+} references[] = {
+#define RGB32(csp, picture, cvt) \
+    { csp, VLC_CODEC_YUVA, Blend<picture, CPictureYUVA, compose<cvt, convertYuv8ToRgb> > }, \
+    { csp, VLC_CODEC_RGBA, Blend<picture, CPictureRGBA, compose<cvt, convertNone> > }
+#define YUV420(csp, picture) \
+    { csp, VLC_CODEC_YUVA, Blend<picture, CPictureYUVA, compose<convertNone, convertNone> > }, \
+    { csp, VLC_CODEC_RGBA, Blend<picture, CPictureRGBA, compose<convertNone, convertRgbToYuv8> > }
+
+    RGB32(VLC_CODEC_RGBA,   CPictureRGBA,     convertNone),
+    RGB32(VLC_CODEC_ARGB,   CPictureRGBA,     convertNone),
+    RGB32(VLC_CODEC_BGRA,   CPictureBGRA,     convertNone),
+    RGB32(VLC_CODEC_ABGR,   CPictureBGRA,     convertNone),
+    RGB32(VLC_CODEC_RGBX,   CPictureRGB32,    convertAddOpaque),
+    RGB32(VLC_CODEC_XRGB,   CPictureRGB32,    convertAddOpaque),
+    RGB32(VLC_CODEC_BGRX,   CPictureRGB32,    convertAddOpaque),
+    RGB32(VLC_CODEC_XBGR,   CPictureRGB32,    convertAddOpaque),
+
+    YUV420(VLC_CODEC_YV12,  CPictureYV12),
+    YUV420(VLC_CODEC_NV12,  CPictureNV12),
+    YUV420(VLC_CODEC_NV21,  CPictureNV21),
+    YUV420(VLC_CODEC_I420,  CPictureI420_8),
+
+#undef RGB32
+#undef YUV420
+};
+
+/* Mostly transparent or opaque pixels, as in subtitles, and some random */
+static void SetAlpha(picture_t *src)
+{
+    plane_t *p = &src->p[src->format.i_chroma == VLC_CODEC_YUVA ? A_PLANE : 0];
+    const int step = src->format.i_chroma == VLC_CODEC_YUVA ? 1 : 4;
+    const int offset = src->format.i_chroma == VLC_CODEC_YUVA ? 0 : 3;
+
+    for (int y = 0; y < p->i_visible_lines; y++)
+        for (int x = 0; x < p->i_visible_pitch; x += step)
+        {
+            const int r = rand() % 4;
+            p->p_pixels[y * p->i_pitch + x + offset] =
+                r == 0 ? 0 : r == 1 ? 255 : rand();
+        }
+}
+
+static void Test(vlc_fourcc_t dst_chroma, vlc_fourcc_t src_chroma,
+                 blend_function_t reference)
+{
+    blend_function_t rows = NULL;
+    for (size_t i = 0; i < ARRAY_SIZE(blends); i++)
+        if (blends[i].dst == dst_chroma && blends[i].src == src_chroma)
+            rows = blends[i].blend;
+    assert(rows != NULL && rows != reference);
+
+    for (unsigned i = 0; i < LOOPS; i++)
+    {
+        /* Odd sizes and offsets cover the partial chroma blocks, and the
+         * widths beyond BLEND_CHUNK the chunk and vector tails */
+        const unsigned dst_width = 2 + rand() % 600;
+        const unsigned dst_height = 2 + rand() % 8;
+        const unsigned src_width = 1 + rand() % dst_width;
+        const unsigned src_height = 1 + rand() % dst_height;
+        const unsigned x = rand() % (dst_width - src_width + 1);
+        const unsigned y = rand() % (dst_height - src_height + 1);
+        const int alpha = 1 + rand() % 255;
+
+        picture_t *dst = test_picture_NewRandomSize(dst_chroma, dst_width,
+                                                    dst_height);
+        picture_t *ref = test_picture_NewRandomSize(dst_chroma, dst_width,
+                                                    dst_height);
+        picture_t *src = test_picture_NewRandomSize(src_chroma, src_width,
+                                                    src_height);
+        picture_CopyPixels(ref, dst);
+        SetAlpha(src);
+
+        rows(CPicture(dst, &dst->format, x, y),
+             CPicture(src, &src->format, 0, 0), src_width, src_height, alpha);
+        reference(CPicture(ref, &ref->format, x, y),
+                  CPicture(src, &src->format, 0, 0), src_width, src_height,
+                  alpha);
+        assert(test_picture_Equals(dst, ref));
+
+        picture_Release(src);
+        picture_Release(ref);
+        picture_Release(dst);
+    }
+}
+
+/* The vectorised kernels against their plain C versions */
+static void TestBytes(void)
+{
+    uint8_t dst[300], ref[300], src[300], a[300], b[300];
+
+    for (unsigned i = 0; i < LOOPS; i++)
+    {
+        const unsigned offset = rand() % 16;
+        const unsigned count = rand() % (sizeof(dst) - offset);
+        const unsigned alpha = rand() % 256;
+
+        for (unsigned j = 0; j < sizeof(dst); j++)
+        {
+            dst[j] = ref[j] = rand();
+            src[j] = rand();
+            a[j] = rand();
+        }
+
+        BlendBytes(&dst[offset], &src[offset], &a[offset], count);
+        BlendBytesC(&ref[offset], &src[offset], &a[offset], count);
+        assert(!memcmp(dst, ref, sizeof(dst)));
+
+        ScaleAlpha(&dst[offset], &src[offset], count, alpha);
+        ScaleAlphaC(&ref[offset], &src[offset], count, alpha);
+        assert(!memcmp(dst, ref, sizeof(dst)));
+
+        /* div255() must stay exact over the whole 8-bit range */
+        memcpy(b, a, sizeof(b));
+        ScaleAlphaC(b, a, sizeof(b), 255);
+        assert(!memcmp(a, b, sizeof(b)));
+    }
+}
+
+int main(void)
+{
+    srand(42);
+
+    TestBytes();
+    for (size_t i = 0; i < ARRAY_SIZE(references); i++)
+        Test(references[i].dst, references[i].src, references[i].blend);
+    return 0;
+}
@@ -0,0 +1,164 @@
+/*****************************************************************************
+ * deinterlace.c: deinterlacer slice rendering tests
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+#include <vlc_filter.h>
+#include <vlc_picture.h>
+
+#include "../../libvlc/test.h"
+#include "../lib/libvlc_internal.h"
+#include "picture_helpers.h"
+
+/* Deinterlaces random pictures with the algorithms rendering slices, with
+ * one thread and with several, and checks that the outputs are the same
+ * pictures, byte for byte, with the same dates. */
+
+#define INPUT_COUNT 8
+
+static const char *const modes[] = {
+    "yadif", "yadif2x", "x",
+};
+
+static const unsigned threads[] = {
+    2, 3, 8, 16,
+};
+
+static const struct {
+    vlc_fourcc_t chroma;
+    unsigned     width;
+    unsigned     height;
+} formats[] = {
+    { VLC_CODEC_I420,  720,  576 },
+    { VLC_CODEC_I420, 1920, 1080 },
+    { VLC_CODEC_I422,  720,  480 },
+    /* Not a multiple of the X bands nor of the slice heights */
+    { VLC_CODEC_I420,  854,  486 },
+};
+
+static filter_chain_t *NewChain(vlc_object_t *obj, const es_format_t *fmt,
+                                const char *mode, unsigned thread_count)
+{
+    char *str;
+    if (asprintf(&str, "deinterlace{mode=%s,threads=%u}", mode,
+                 thread_count) < 0)
+        abort();
+
+    filter_chain_t *chain = filter_chain_NewVideo(obj, false, NULL);
+    assert(chain != NULL);
+    filter_chain_Reset(chain, fmt, NULL, fmt);
+    assert(filter_chain_AppendFromString(chain, str) == 1);
+    free(str);
+    return chain;
+}
+
+static size_t Collect(filter_chain_t *chain, picture_t *pic,
+                      picture_t **outputs, size_t count)
+{
+    for (pic = filter_chain_VideoFilter(chain, pic); pic != NULL;
+         pic = filter_chain_VideoFilter(chain, NULL))
+    {
+        assert(count < INPUT_COUNT * 2);
+        outputs[count++] = pic;
+    }
+    return count;
+}
+
+static size_t Run(filter_chain_t *chain, picture_t *const *inputs,
+                  picture_t **outputs)
+{
+    size_t count = 0;
+
+    for (unsigned i = 0; i < INPUT_COUNT; i++)
+    {
+        picture_t *pic = picture_Hold(inputs[i]);
+        pic->date = VLC_TICK_0 + i * VLC_TICK_FROM_MS(40);
+        count = Collect(chain, pic, outputs, count);
+    }
+    filter_chain_VideoDrain(chain);
+    count = Collect(chain, NULL, outputs, count);
+    filter_chain_Delete(chain);
+    return count;
+}
+
+static void Test(vlc_object_t *obj, vlc_fourcc_t chroma, unsigned width,
+                 unsigned height)
+{
+    picture_t *inputs[INPUT_COUNT];
+    picture_t *ref[INPUT_COUNT * 2], *outputs[INPUT_COUNT * 2];
+    es_format_t fmt;
+
+    es_format_Init(&fmt, VIDEO_ES, chroma);
+    video_format_Setup(&fmt.video, chroma, width, height, width, height,
+                       1, 1);
+    fmt.video.i_frame_rate = 25;
+    fmt.video.i_frame_rate_base = 1;
+
+    for (unsigned i = 0; i < INPUT_COUNT; i++)
+        inputs[i] = test_picture_NewRandom(&fmt.video);
+
+    for (size_t i = 0; i < ARRAY_SIZE(modes); i++)
+    {
+        test_log("%s on %4.4s %ux%u\n", modes[i], (const char *)&chroma,
+                 width, height);
+
+        size_t count = Run(NewChain(obj, &fmt, modes[i], 1), inputs, ref);
+        assert(count > 0);
+
+        for (size_t j = 0; j < ARRAY_SIZE(threads); j++)
+        {
+            size_t n = Run(NewChain(obj, &fmt, modes[i], threads[j]), inputs,
+                           outputs);
+            assert(n == count);
+            for (size_t k = 0; k < n; k++)
+            {
+                assert(outputs[k]->date == ref[k]->date);
+                assert(test_picture_Equals(outputs[k], ref[k]));
+                picture_Release(outputs[k]);
+            }
+        }
+
+        for (size_t k = 0; k < count; k++)
+            picture_Release(ref[k]);
+    }
+
+    for (unsigned i = 0; i < INPUT_COUNT; i++)
+        picture_Release(inputs[i]);
+    es_format_Clean(&fmt);
+}
+
+int main(void)
+{
+    test_init();
+
+    libvlc_instance_t *vlc = libvlc_new(test_defaults_nargs,
+                                        test_defaults_args);
+    assert(vlc != NULL);
+
+    for (size_t i = 0; i < ARRAY_SIZE(formats); i++)
+        Test(VLC_OBJECT(vlc->p_libvlc_int), formats[i].chroma,
+             formats[i].width, formats[i].height);
+
+    libvlc_release(vlc);
+    return 0;
+}
@@ -0,0 +1,81 @@
+/*****************************************************************************
+ * picture_helpers.h: picture helpers for the video filter tests
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_TEST_VIDEO_FILTER_PICTURE_HELPERS_H
+#define VLC_TEST_VIDEO_FILTER_PICTURE_HELPERS_H
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vlc_common.h>
+#include <vlc_picture.h>
+
+/**
+ * Allocates a picture of the given format, with random visible pixels.
+ */
+static inline picture_t *test_picture_NewRandom(const video_format_t *fmt)
+{
+    picture_t *pic = picture_NewFromFormat(fmt);
+    assert(pic != NULL);
+
+    for (int i = 0; i < pic->i_planes; i++)
+        for (int y = 0; y < pic->p[i].i_visible_lines; y++)
+            for (int x = 0; x < pic->p[i].i_visible_pitch; x++)
+                pic->p[i].p_pixels[y * pic->p[i].i_pitch + x] = rand();
+    return pic;
+}
+
+/**
+ * Allocates a picture of the given chroma and size, with random visible
+ * pixels.
+ */
+static inline picture_t *test_picture_NewRandomSize(vlc_fourcc_t chroma,
+                                                    unsigned width,
+                                                    unsigned height)
+{
+    video_format_t fmt;
+
+    video_format_Init(&fmt, chroma);
+    fmt.i_width = fmt.i_visible_width = width;
+    fmt.i_height = fmt.i_visible_height = height;
+
+    picture_t *pic = test_picture_NewRandom(&fmt);
+    video_format_Clean(&fmt);
+    return pic;
+}
+
+/**
+ * Compares the visible pixels of two pictures of the same format.
+ */
+static inline bool test_picture_Equals(const picture_t *a, const picture_t *b)
+{
+    if (a->i_planes != b->i_planes)
+        return false;
+    for (int i = 0; i < a->i_planes; i++)
+        for (int y = 0; y < a->p[i].i_visible_lines; y++)
+            if (memcmp(&a->p[i].p_pixels[y * a->p[i].i_pitch],
+                       &b->p[i].p_pixels[y * b->p[i].i_pitch],
+                       a->p[i].i_visible_pitch))
+                return false;
+    return true;
+}
+
+#endif
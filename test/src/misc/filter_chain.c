@@ -0,0 +1,220 @@
+/*****************************************************************************
+ * filter_chain.c: test for the video filter chain
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+/* Define a builtin module for mocked parts */
+#define MODULE_NAME test_misc_filter_chain
+#undef VLC_DYNAMIC_PLUGIN
+
+#include "../../libvlc/test.h"
+
+#include <vlc/vlc.h>
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_picture.h>
+#include <vlc_filter.h>
+
+#include "../lib/libvlc_internal.h"
+
+const char vlc_module_name[] = MODULE_STRING;
+
+/* The filters only work on the picture dates: the "double" filter outputs
+ * 2n and 2n+1 for each input n, and the "delay" filter outputs the previous
+ * picture, like a deinterlacer would. A pipelined chain must output the
+ * same dates, in the same order, as a synchronous one. */
+
+#define INPUT_COUNT 50
+
+static picture_t *Double(filter_t *filter, picture_t *pic)
+{
+    picture_t *copy = filter_NewPicture(filter);
+    assert(copy != NULL);
+
+    pic->date *= 2;
+    copy->date = pic->date + 1;
+    vlc_picture_chain_AppendChain(pic, copy);
+    return pic;
+}
+
+static int OpenDouble(filter_t *filter)
+{
+    static const struct vlc_filter_operations ops =
+    {
+        .filter_video = Double,
+    };
+    filter->ops = &ops;
+    return VLC_SUCCESS;
+}
+
+static picture_t *Delay(filter_t *filter, picture_t *pic)
+{
+    picture_t *prev = filter->p_sys;
+
+    filter->p_sys = pic;
+    return prev;
+}
+
+static void FlushDelay(filter_t *filter)
+{
+    picture_t *prev = filter->p_sys;
+
+    if (prev != NULL)
+        picture_Release(prev);
+    filter->p_sys = NULL;
+}
+
+static int OpenDelay(filter_t *filter)
+{
+    static const struct vlc_filter_operations ops =
+    {
+        .filter_video = Delay, .flush = FlushDelay, .close = FlushDelay,
+    };
+    filter->ops = &ops;
+    filter->p_sys = NULL;
+    return VLC_SUCCESS;
+}
+
+vlc_module_begin()
+    set_callback_video_filter(OpenDouble)
+    add_shortcut("test_double")
+
+    add_submodule()
+        set_callback_video_filter(OpenDelay)
+        add_shortcut("test_delay")
+vlc_module_end()
+
+VLC_EXPORT const vlc_plugin_cb vlc_static_modules[] = {
+    VLC_SYMBOL(vlc_entry),
+    NULL
+};
+
+static filter_chain_t *NewChain(vlc_object_t *obj, unsigned depth)
+{
+    es_format_t fmt;
+    es_format_Init(&fmt, VIDEO_ES, VLC_CODEC_I420);
+    video_format_Setup(&fmt.video, VLC_CODEC_I420, 16, 16, 16, 16, 1, 1);
+
+    filter_chain_t *chain = filter_chain_NewVideo(obj, false, NULL);
+    assert(chain != NULL);
+    filter_chain_SetPipelined(chain, depth);
+    filter_chain_Reset(chain, &fmt, NULL, &fmt);
+    es_format_Clean(&fmt);
+
+    static const char *const names[] = {
+        "test_double", "test_delay", "test_double",
+    };
+    for (size_t i = 0; i < ARRAY_SIZE(names); i++)
+        assert(filter_chain_AppendFilter(chain, names[i], NULL, NULL) != NULL);
+    return chain;
+}
+
+static size_t Collect(filter_chain_t *chain, picture_t *pic,
+                      vlc_tick_t *dates, size_t count)
+{
+    for (pic = filter_chain_VideoFilter(chain, pic); pic != NULL;
+         pic = filter_chain_VideoFilter(chain, NULL))
+    {
+        dates[count++] = pic->date;
+        picture_Release(pic);
+    }
+    return count;
+}
+
+static size_t Run(filter_chain_t *chain, vlc_tick_t first, vlc_tick_t *dates)
+{
+    const video_format_t *fmt = &filter_chain_GetFmtOut(chain)->video;
+    size_t count = 0;
+
+    for (vlc_tick_t i = first; i < first + INPUT_COUNT; i++)
+    {
+        picture_t *pic = picture_NewFromFormat(fmt);
+        assert(pic != NULL);
+        pic->date = i;
+        count = Collect(chain, pic, dates, count);
+    }
+    filter_chain_VideoDrain(chain);
+    return Collect(chain, NULL, dates, count);
+}
+
+static void Test(vlc_object_t *obj, unsigned depth)
+{
+    vlc_tick_t ref[INPUT_COUNT * 8], dates[INPUT_COUNT * 8];
+
+    test_log("pipeline depth %u\n", depth);
+
+    filter_chain_t *sync = NewChain(obj, 0);
+    filter_chain_t *chain = NewChain(obj, depth);
+
+    size_t count = Run(sync, 0, ref);
+    assert(count == (INPUT_COUNT * 2 - 1) * 2);
+    assert(Run(chain, 0, dates) == count);
+    assert(!memcmp(dates, ref, count * sizeof (*dates)));
+
+    /* The delayed picture is dropped on flush */
+    filter_chain_VideoFlush(sync);
+    filter_chain_VideoFlush(chain);
+    count = Run(sync, 1000, ref);
+    assert(Run(chain, 1000, dates) == count);
+    assert(!memcmp(dates, ref, count * sizeof (*dates)));
+    assert(ref[0] == 4000);
+
+    /* Flush with pictures in flight */
+    picture_t *pic = picture_NewFromFormat(&filter_chain_GetFmtOut(chain)->video);
+    assert(pic != NULL);
+    Collect(chain, pic, dates, 0);
+    filter_chain_VideoFlush(sync);
+    filter_chain_VideoFlush(chain);
+
+    /* Change the filters, which restarts the pipeline */
+    filter_t *sync_extra = filter_chain_AppendFilter(sync, "test_double",
+                                                     NULL, NULL);
+    filter_t *extra = filter_chain_AppendFilter(chain, "test_double",
+                                                NULL, NULL);
+    assert(sync_extra != NULL && extra != NULL);
+    count = Run(sync, 2000, ref);
+    assert(count == (INPUT_COUNT * 2 - 1) * 4);
+    assert(Run(chain, 2000, dates) == count);
+    assert(!memcmp(dates, ref, count * sizeof (*dates)));
+
+    filter_chain_DeleteFilter(sync, sync_extra);
+    filter_chain_DeleteFilter(chain, extra);
+
+    filter_chain_Delete(chain);
+    filter_chain_Delete(sync);
+}
+
+int main(void)
+{
+    test_init();
+
+    libvlc_instance_t *vlc = libvlc_new(test_defaults_nargs,
+                                        test_defaults_args);
+    assert(vlc != NULL);
+
+    for (unsigned depth = 1; depth <= 4; depth++)
+        Test(VLC_OBJECT(vlc->p_libvlc_int), depth);
+
+    libvlc_release(vlc);
+    return 0;
+}
@@ -0,0 +1,268 @@
+/*****************************************************************************
+ * httpd.c: HTTP server load test
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/*
+ * Opens many concurrent loopback connections to the built-in HTTP server,
+ * sends one request on each of them and checks every response.
+ *
+ * The number of connections defaults to CLIENT_COUNT, bounded by the file
+ * descriptor limit, and can be raised with VLC_TEST_HTTPD_CLIENTS.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+#include <vlc/vlc.h>
+
+#include "../../libvlc/test.h"
+#include "../../../lib/libvlc_internal.h"
+
+#include <vlc_common.h>
+#include <vlc_httpd.h>
+#include <vlc_network.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define CLIENT_COUNT 1000
+#define HTTP_BODY "Hello, World!\n"
+
+struct client
+{
+    int fd;
+    size_t sent;
+    size_t received;
+    char buf[1024];
+};
+
+static const char request[] = "GET /test HTTP/1.0\r\n\r\n";
+
+static int FileFill(httpd_file_sys_t *sys, httpd_file_t *file,
+                    uint8_t *psz_request, uint8_t **pp_data, size_t *pi_data)
+{
+    (void) sys; (void) file; (void) psz_request;
+
+    *pp_data = (uint8_t *)strdup(HTTP_BODY);
+    if (*pp_data == NULL)
+        return VLC_ENOMEM;
+    *pi_data = strlen(HTTP_BODY);
+    return VLC_SUCCESS;
+}
+
+static unsigned GetClientCount(void)
+{
+    unsigned count = CLIENT_COUNT;
+    const char *str = getenv("VLC_TEST_HTTPD_CLIENTS");
+    if (str != NULL && atoi(str) > 0)
+        count = atoi(str);
+
+    /* Both ends of each connection live in this process */
+    struct rlimit lim;
+    if (getrlimit(RLIMIT_NOFILE, &lim) == 0)
+    {
+        if (lim.rlim_cur < lim.rlim_max)
+        {
+            lim.rlim_cur = lim.rlim_max;
+            setrlimit(RLIMIT_NOFILE, &lim);
+            getrlimit(RLIMIT_NOFILE, &lim);
+        }
+        if (lim.rlim_cur != RLIM_INFINITY && lim.rlim_cur < 2 * count + 128)
+            count = (lim.rlim_cur - 128) / 2;
+    }
+    return count;
+}
+
+static int Connect(unsigned port)
+{
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+
+    int fd = vlc_socket(PF_INET, SOCK_STREAM, 0, true);
+    if (fd == -1)
+        return -1;
+
+    if (connect(fd, (struct sockaddr *)&addr, sizeof (addr))
+     && errno != EINPROGRESS)
+    {
+        net_Close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* Returns true once the response is complete */
+static bool ClientRun(struct client *c, short revents)
+{
+    if ((revents & POLLOUT) && c->sent < sizeof (request) - 1)
+    {
+        ssize_t val = send(c->fd, request + c->sent,
+                           sizeof (request) - 1 - c->sent, MSG_NOSIGNAL);
+        if (val > 0)
+            c->sent += val;
+    }
+
+    if (revents & (POLLIN|POLLHUP|POLLERR))
+    {
+        ssize_t val = recv(c->fd, c->buf + c->received,
+                           sizeof (c->buf) - 1 - c->received, 0);
+        if (val > 0)
+            c->received += val;
+        else if (val == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+            return true;
+        if (c->received == sizeof (c->buf) - 1)
+            return true;
+    }
+    return false;
+}
+
+static bool ClientCheck(struct client *c)
+{
+    c->buf[c->received] = '\0';
+
+    if (strncmp(c->buf, "HTTP/1.", 7) || strncmp(c->buf + 8, " 200 ", 5))
+        return false;
+
+    const char *body = strstr(c->buf, "\r\n\r\n");
+    return body != NULL && strcmp(body + 4, HTTP_BODY) == 0;
+}
+
+static int RunClients(unsigned port, unsigned count)
+{
+    struct client *clients = malloc(count * sizeof (*clients));
+    struct pollfd *ufd = malloc(count * sizeof (*ufd));
+    unsigned *map = malloc(count * sizeof (*map));
+    assert(clients != NULL && ufd != NULL && map != NULL);
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        clients[i].fd = Connect(port);
+        if (clients[i].fd == -1)
+        {
+            fprintf(stderr, "cannot connect client %u: %s\n", i,
+                    vlc_strerror_c(errno));
+            return 1;
+        }
+        clients[i].sent = clients[i].received = 0;
+    }
+
+    unsigned done = 0, failed = 0;
+    vlc_tick_t start = vlc_tick_now();
+
+    while (done < count)
+    {
+        unsigned nfd = 0;
+
+        for (unsigned i = 0; i < count; i++)
+        {
+            struct client *c = &clients[i];
+            if (c->fd == -1)
+                continue;
+
+            ufd[nfd].fd = c->fd;
+            ufd[nfd].events = POLLIN;
+            if (c->sent < sizeof (request) - 1)
+                ufd[nfd].events |= POLLOUT;
+            map[nfd++] = i;
+        }
+
+        if (poll(ufd, nfd, -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return 1;
+        }
+
+        for (unsigned i = 0; i < nfd; i++)
+        {
+            struct client *c = &clients[map[i]];
+
+            if (ufd[i].revents == 0 || !ClientRun(c, ufd[i].revents))
+                continue;
+
+            if (!ClientCheck(c))
+            {
+                fprintf(stderr, "client %u: bad response (%zu bytes)\n",
+                        map[i], c->received);
+                failed++;
+            }
+            net_Close(c->fd);
+            c->fd = -1;
+            done++;
+        }
+    }
+
+    vlc_tick_t elapsed = vlc_tick_now() - start;
+
+    fprintf(stderr, "%u concurrent requests: %"PRId64" ms, %.0f requests/s\n",
+            count, MS_FROM_VLC_TICK(elapsed),
+            count / secf_from_vlc_tick(elapsed > 0 ? elapsed : 1));
+
+    free(map);
+    free(ufd);
+    free(clients);
+    return failed != 0;
+}
+
+int main(void)
+{
+    test_init();
+
+    unsigned port = 18000 + getpid() % 10000;
+    char port_arg[32];
+    snprintf(port_arg, sizeof (port_arg), "--http-port=%u", port);
+
+    const char * const argv[] = {
+        "-v", "--ignore-config", "--http-host=127.0.0.1", port_arg,
+    };
+
+    libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(argv), argv);
+    assert(vlc != NULL);
+
+    httpd_host_t *host = vlc_http_HostNew(VLC_OBJECT(vlc->p_libvlc_int));
+    if (host == NULL)
+    {
+        libvlc_release(vlc);
+        return 77; /* cannot listen, skip */
+    }
+
+    httpd_file_t *file = httpd_FileNew(host, "/test", "text/plain", NULL, NULL,
+                                       FileFill, NULL);
+    assert(file != NULL);
+
+    unsigned count = GetClientCount();
+    int ret = RunClients(port, count);
+
+    /* Reuse the same host with a second, smaller wave */
+    if (ret == 0)
+        ret = RunClients(port, count / 10 + 1);
+
+    httpd_FileDelete(file);
+    httpd_HostDelete(host);
+    libvlc_release(vlc);
+
+    return ret;
+}